@@ -9,7 +9,7 @@
 
 load('jstests/concurrency/fsm_libs/extend_workload.js');            // for extendWorkload
 load('jstests/concurrency/fsm_workloads/indexed_insert_where.js');  // for $config
-// For isMongod, isMMAPv1, and isEphemeral.
+// For isMongod.
 load('jstests/concurrency/fsm_workload_helpers/server_types.js');
 
 var $config = extendWorkload($config, function($config, $super) {
@@ -23,10 +23,10 @@ var $config = extendWorkload($config, function($config, $super) {
 
     $config.states.touch = function touch(db, collName) {
         var res = db.runCommand(this.generateTouchCmdObj(collName));
-        if (isMongod(db) && (isMMAPv1(db) || isEphemeral(db))) {
+        if (isMongod(db)) {
             assertAlways.commandWorked(res);
         } else {
-            // SERVER-16850 and SERVER-16797
+            // SERVER-16797
             assertAlways.commandFailed(res);
         }
     };
@@ -0,0 +1,79 @@
+// Test that journal recovery gives the same result whether sections are decompressed and applied
+// by a pool of threads or sequentially, and that with several threads the writes of a section
+// are really copied into the data files by the workers.
+(function() {
+    "use strict";
+
+    var path = MongoRunner.dataPath + "dur_parallel_recovery";
+    var numDbs = 4;
+    var numRounds = 20;
+    var docsPerRound = 100;
+    var padding = new Array(1024).join("x");
+
+    function crashWithJournaledWrites() {
+        var conn = MongoRunner.runMongod(
+            {dbpath: path, journal: "", smallfiles: "", journalCommitInterval: 500});
+        // Keep the data files from being flushed so that recovery has to replay every write.
+        assert.commandWorked(conn.adminCommand({setParameter: 1, syncdelay: 0}));
+
+        // Create the data files of every database up front, so that later sections only hold
+        // writes.
+        for (var i = 0; i < numDbs; i++) {
+            var coll = conn.getDB("test" + i).foo;
+            assert.writeOK(coll.insert({_id: "first"}, {writeConcern: {j: true}}));
+        }
+
+        // Interleave unjournaled writes to several databases, so that each group commit holds
+        // writes to several data files and more than the 1MB recovery hands to its workers.
+        for (var round = 0; round < numRounds; round++) {
+            for (var i = 0; i < numDbs; i++) {
+                var bulk = conn.getDB("test" + i).foo.initializeUnorderedBulkOp();
+                for (var j = 0; j < docsPerRound; j++) {
+                    bulk.insert({_id: round * docsPerRound + j, x: padding});
+                }
+                assert.writeOK(bulk.execute());
+            }
+        }
+        assert.writeOK(conn.getDB("test0").foo.insert({_id: "last"}, {writeConcern: {j: true}}));
+
+        MongoRunner.stopMongod(conn, /*signal*/ 9);
+    }
+
+    function recoverAndCheck(threads) {
+        jsTest.log("Recovering with journalRecoveryThreads=" + threads);
+        resetDbpath(path);
+        crashWithJournaledWrites();
+
+        clearRawMongoProgramOutput();
+        var conn = MongoRunner.runMongod({
+            restart: true,
+            cleanData: false,
+            dbpath: path,
+            journal: "",
+            smallfiles: "",
+            setParameter: {journalRecoveryThreads: threads}
+        });
+        assert.neq(null, conn, "mongod failed to recover");
+
+        for (var i = 0; i < numDbs; i++) {
+            var db = conn.getDB("test" + i);
+            assert.eq(numRounds * docsPerRound + (i === 0 ? 2 : 1), db.foo.count(), "db " + db);
+            assert.commandWorked(db.foo.validate(true));
+        }
+        MongoRunner.stopMongod(conn);
+
+        var match = /(\d+) batches of writes copied in parallel/.exec(rawMongoProgramOutput());
+        assert.neq(null, match, "recovery did not log its statistics");
+        return parseInt(match[1]);
+    }
+
+    assert.eq(0, recoverAndCheck(1));
+    assert.gt(recoverAndCheck(4), 0);
+
+    // The number of recovery threads is bounded.
+    [0, -1, 65].forEach(function(threads) {
+        var conn =
+            MongoRunner.runMongod({dbpath: path, setParameter: {journalRecoveryThreads: threads}});
+        assert.eq(null, conn, "mongod started with journalRecoveryThreads=" + threads);
+    });
+}());
@@ -0,0 +1,64 @@
+// Check that range queries fetching in batches (internalQueryExecFetchBatchSize > 1) still return
+// only matching documents when they yield often while other clients update and delete documents.
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({
+        setParameter: {internalQueryExecFetchBatchSize: 64, internalQueryExecYieldIterations: 1}
+    });
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    var testDB = conn.getDB('test');
+    var coll = testDB.fetch_batch_yield;
+    var numDocs = 2000;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({x: 1}));
+
+    // Move documents around the index and remove and reinsert them until told to stop.
+    var awaitWriter = startParallelShell(function() {
+        var coll = db.fetch_batch_yield;
+        var numDocs = 2000;
+        while (db.stop.count() === 0) {
+            for (var i = 0; i < 100; ++i) {
+                var id = Random.randInt(numDocs);
+                if (Random.rand() < 0.5) {
+                    assert.writeOK(coll.update({_id: id}, {$set: {x: Random.randInt(numDocs)}}));
+                } else {
+                    assert.writeOK(coll.remove({_id: id}));
+                    assert.writeOK(coll.insert({_id: id, x: Random.randInt(numDocs)}));
+                }
+            }
+        }
+    }, conn.port);
+
+    for (var iter = 0; iter < 200; ++iter) {
+        var low = Random.randInt(numDocs);
+        var high = low + 1 + Random.randInt(numDocs / 4);
+        var query = {x: {$gte: low, $lt: high}};
+
+        // A small cursor batch size makes the query yield between getMores as well.
+        coll.find(query).hint({x: 1}).batchSize(10).forEach(function(doc) {
+            assert.gte(doc.x, low, tojson(doc));
+            assert.lt(doc.x, high, tojson(doc));
+        });
+    }
+
+    assert.writeOK(testDB.stop.insert({}));
+    awaitWriter();
+
+    // With the writer done, every document is found, and the plan did yield while fetching.
+    var explain = coll.find({x: {$gte: 0, $lt: numDocs}}).hint({x: 1}).explain('executionStats');
+    assert.commandWorked(explain);
+    assert.eq(numDocs, explain.executionStats.nReturned, tojson(explain));
+    assert.gt(explain.executionStats.executionStages.saveState, 0, tojson(explain));
+
+    // The batch size must be positive.
+    assert.commandFailed(conn.adminCommand({setParameter: 1, internalQueryExecFetchBatchSize: 0}));
+
+    MongoRunner.stopMongod(conn);
+})();
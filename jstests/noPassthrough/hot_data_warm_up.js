@@ -0,0 +1,61 @@
+// Check that mongod records which collections and indexes are hot, reads them back into the cache
+// when it restarts, and that the touch command works on every storage engine.
+//
+// This test requires persistence because the hot data summary must survive a restart.
+// @tags: [requires_persistence]
+(function() {
+    'use strict';
+    var baseName = 'hot_data_warm_up';
+    var dbpath = MongoRunner.dataPath + baseName;
+
+    var conn =
+        MongoRunner.runMongod({dbpath: dbpath, setParameter: {hotDataSummaryIntervalSecs: 1}});
+    assert.neq(null, conn, 'failed to start mongod');
+
+    var t = conn.getDB('test').getCollection(baseName);
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.createIndex({x: 1}));
+
+    var res = assert.commandWorked(t.runCommand('touch', {data: true, index: true}));
+    assert(res.data, tojson(res));
+    assert(res.indexes, tojson(res));
+
+    for (var i = 0; i < 10; ++i) {
+        assert.eq(1, t.find({x: i}).itcount());
+    }
+
+    assert.soon(function() {
+        return listFiles(dbpath).some(function(file) {
+            return file.baseName === 'hotData.bson';
+        });
+    }, 'hot data summary was never saved');
+
+    // Let at least one more recording pass see all of the activity above.
+    sleep(3000);
+
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, 'failed to restart mongod');
+
+    assert.soon(function() {
+        var log = assert.commandWorked(conn.adminCommand({getLog: 'global'})).log;
+        return log.some(function(line) {
+            return line.indexOf('Cache warm up read') >= 0;
+        });
+    }, 'cache warm up did not run after restart');
+
+    // The knobs reject negative values.
+    ['hotDataSummaryIntervalSecs', 'hotDataSummaryMaxEntries', 'warmUpMaxMBPerSec'].forEach(
+        function(name) {
+            var cmd = {setParameter: 1};
+            cmd[name] = -1;
+            assert.commandFailed(conn.adminCommand(cmd), name);
+        });
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,60 @@
+/**
+ * Tests the inMemory storage engine: data is not persisted across restarts, serverStatus reports
+ * the memory in use, and writes fail with ExceededMemoryLimit once inMemorySizeGB is used up.
+ */
+(function() {
+    "use strict";
+
+    // The cache size is configured in whole megabytes, so use a size that is a whole number of
+    // them (64MB).
+    var conn = MongoRunner.runMongod({storageEngine: "inMemory", inMemorySizeGB: 0.0625});
+    if (conn === null) {
+        jsTestLog("Skipping test because the inMemory storage engine is not available");
+        return;
+    }
+    var testDB = conn.getDB("test");
+
+    var status = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    assert.eq("inMemory", status.storageEngine.name, tojson(status.storageEngine));
+    assert.eq(false, status.storageEngine.persistent, tojson(status.storageEngine));
+    assert(status.inMemory, tojson(status));
+    assert.eq(64 * 1024 * 1024,
+              status.inMemory.maximumBytesConfigured,
+              tojson(status.inMemory));
+    assert.eq(0, status.inMemory.writesRejectedMemoryFull, tojson(status.inMemory));
+
+    // Document-level concurrency and indexes work as they do with wiredTiger.
+    assert.commandWorked(testDB.coll.createIndex({x: 1}));
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(testDB.coll.insert({_id: i, x: i}));
+    }
+    assert.eq(10, testDB.coll.find({x: {$lt: 10}}).itcount());
+
+    // Fill the configured memory until writes are rejected.
+    var bigString = new Array(1024 * 1024).join("x");
+    var res;
+    for (var i = 0; i < 1000; i++) {
+        res = testDB.big.insert({_id: i, s: bigString});
+        if (res.hasWriteError()) {
+            break;
+        }
+    }
+    assert.writeErrorWithCode(res, ErrorCodes.ExceededMemoryLimit);
+
+    status = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    assert.gt(status.inMemory.writesRejectedMemoryFull, 0, tojson(status.inMemory));
+
+    // Reads keep working, and deleting data makes room for writes again.
+    assert.eq(100, testDB.coll.find().itcount());
+    testDB.big.drop();
+    assert.writeOK(testDB.coll.insert({_id: "afterDrop"}));
+
+    // Nothing survives a restart.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(
+        {restart: true, port: conn.port, cleanData: false, storageEngine: "inMemory"});
+    assert.neq(null, conn, "failed to restart mongod");
+    assert.eq(0, conn.getDB("test").coll.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,53 @@
+// Test foreground index builds which generate and sort keys on several threads.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: "indexBuildKeyGenerationThreads=4"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var testDB = conn.getDB("test");
+    var coll = testDB.index_build_key_generation_threads;
+
+    var numDocs = 20000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, a: i % 1000, b: [i, -i], c: (i % 2 === 0) ? "even" : "odd"});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(coll.createIndexes([
+        {a: 1},
+        {b: 1},
+        {c: 1, a: -1},
+    ]));
+    assert.commandWorked(coll.createIndex({a: 1, _id: 1}, {partialFilterExpression: {c: "even"}}));
+
+    var validateRes = assert.commandWorked(coll.validate(true));
+    assert(validateRes.valid, tojson(validateRes));
+
+    assert.eq(20, coll.find({a: 7}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({b: -4242}).hint({b: 1}).itcount());
+    assert.eq(numDocs / 2, coll.find({c: "odd"}).hint({c: 1, a: -1}).itcount());
+    assert.eq(20, coll.find({a: 8, c: "even"}).hint({a: 1, _id: 1}).itcount());
+
+    // The array field must still mark its index multikey.
+    var explain = coll.find({b: 5}).hint({b: 1}).explain();
+    var ixscan = explain.queryPlanner.winningPlan.inputStage;
+    assert.eq("IXSCAN", ixscan.stage, tojson(explain));
+    assert(ixscan.isMultiKey, tojson(explain));
+
+    // Key generation errors on a worker thread fail the build.
+    assert.commandFailedWithCode(coll.createIndex({a: 1, c: 1}, {unique: true}),
+                                 ErrorCodes.DuplicateKey);
+    assert.writeOK(coll.insert({_id: numDocs, d: [1, 2], e: [3, 4]}));
+    assert.commandFailed(coll.createIndex({d: 1, e: 1}));
+    assert.commandWorked(coll.dropIndexes());
+
+    // Same result when changing the thread count at runtime.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, indexBuildKeyGenerationThreads: 2}));
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.eq(20, coll.find({a: 7}).hint({a: 1}).itcount());
+    assert.commandFailed(testDB.adminCommand({setParameter: 1, indexBuildKeyGenerationThreads: 0}));
+
+    MongoRunner.stopMongod(conn);
+}());
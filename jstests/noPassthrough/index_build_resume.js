@@ -0,0 +1,63 @@
+// Check that a foreground index build interrupted by a crash resumes from its last checkpoint on
+// restart instead of scanning the collection from the beginning.
+//
+// This test requires persistence because it assumes data/indices will survive a restart.
+// This test requires journaling because the information that an index build was started
+// must be made durable when the process aborts.
+// @tags: [requires_persistence, requires_journaling]
+(function() {
+    'use strict';
+    var baseName = 'index_build_resume';
+    var dbpath = MongoRunner.dataPath + baseName;
+
+    var conn = MongoRunner.runMongod({dbpath: dbpath});
+    assert.neq(null, conn, 'failed to start mongod');
+
+    var t = conn.getDB('test').getCollection(baseName);
+    t.drop();
+
+    // Only a document indexed before the checkpoint makes the index multikey.
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; ++i) {
+        bulk.insert({_id: i, a: (i == 10 ? [i, 1000] : i)});
+    }
+    assert.writeOK(bulk.execute({j: true}));
+
+    var createIdx = startParallelShell(function() {
+        var coll = db.getSiblingDB('test').getCollection('index_build_resume');
+        assert.commandWorked(db.adminCommand({
+            configureFailPoint: 'crashAfterIndexBuildCheckpoint',
+            mode: 'alwaysOn',
+            data: {afterRecords: 50}
+        }));
+        coll.createIndex({a: 1});
+    }, conn.port);
+
+    var exitCode = createIdx({checkExitSuccess: false});
+    assert.neq(0, exitCode, 'expected shell to exit abnormally due to mongod being terminated');
+    assert.eq(waitProgram(conn.pid),
+              MongoRunner.EXIT_TEST,
+              "mongod should have crashed due to the 'crashAfterIndexBuildCheckpoint' failpoint");
+
+    clearRawMongoProgramOutput();
+    conn = MongoRunner.runMongod({dbpath: dbpath, restart: true});
+    assert.neq(null, conn, 'failed to restart mongod');
+    assert(/resuming index build on test.index_build_resume from a checkpoint after 50 records/.test(
+               rawMongoProgramOutput()),
+           'expected the index build to resume from its checkpoint');
+
+    t = conn.getDB('test').getCollection(baseName);
+    assert.eq(100, t.find({}, {_id: 0, a: 1}).hint({a: 1}).itcount());
+    assert.eq(1, t.find({a: 1000}).hint({a: 1}).itcount());
+    assert.eq(1, t.find({a: 99}).hint({a: 1}).itcount());
+
+    var explain = t.find({a: 5}).hint({a: 1}).explain();
+    assert(explain.queryPlanner.winningPlan.inputStage.isMultiKey, tojson(explain));
+
+    // Checkpoints are removed once the interrupted builds have been restarted.
+    assert(!listFiles(dbpath).some(function(file) {
+        return file.baseName === '_indexBuildCheckpoints';
+    }));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,62 @@
+// Checks that mongod started with several accept threads accepts many concurrent connections, and
+// that serverStatus reports the listener's accept statistics.
+(function() {
+    'use strict';
+
+    var acceptThreads = 4;
+    var conn = MongoRunner.runMongod({setParameter: {listenerAcceptThreads: acceptThreads}});
+    assert.neq(null, conn, 'mongod failed to start with listenerAcceptThreads=' + acceptThreads);
+
+    function getListenerStats() {
+        var status = assert.commandWorked(conn.adminCommand({serverStatus: 1}));
+        assert(status.network.listener, tojson(status.network));
+        return status.network.listener;
+    }
+
+    var before = getListenerStats();
+    if (_isWindows() || before.acceptThreads === 1) {
+        // Several accept threads need SO_REUSEPORT; without it mongod falls back to one.
+        jsTest.log('Running with a single accept thread: ' + tojson(before));
+    } else {
+        assert.eq(acceptThreads, before.acceptThreads, tojson(before));
+        assert.gte(before.listeningSockets, acceptThreads, tojson(before));
+    }
+    assert.eq(0, before.acceptErrors, tojson(before));
+
+    // Open connections from several clients at once, and keep them open until all are made.
+    var numShells = 4;
+    var connsPerShell = 50;
+    var awaitShells = [];
+    for (var i = 0; i < numShells; i++) {
+        awaitShells.push(startParallelShell(
+            'var conns = [];' +
+            'for (var j = 0; j < ' + connsPerShell + '; j++) {' +
+            '    var c = new Mongo(db.getMongo().host);' +
+            '    assert.commandWorked(c.adminCommand({ping: 1}));' +
+            '    conns.push(c);' +
+            '}',
+            conn.port));
+    }
+    awaitShells.forEach(function(awaitShell) {
+        awaitShell();
+    });
+
+    var after = getListenerStats();
+    // Each parallel shell also makes its own initial connection.
+    assert.gte(after.totalAccepted - before.totalAccepted,
+               numShells * (connsPerShell + 1),
+               tojson({before: before, after: after}));
+    assert.eq(0, after.acceptErrors, tojson(after));
+    assert.gte(after.acceptsLastSecond, 0, tojson(after));
+    if (!_isWindows() && after.hasOwnProperty('acceptQueueDepth')) {
+        assert.gte(after.acceptQueueDepth, 0, tojson(after));
+        assert.gt(after.acceptQueueLimit, 0, tojson(after));
+    }
+
+    MongoRunner.stopMongod(conn);
+
+    // At least one accept thread is required.
+    assert.eq(null,
+              MongoRunner.runMongod({setParameter: {listenerAcceptThreads: 0}}),
+              'mongod started with listenerAcceptThreads=0');
+})();
@@ -0,0 +1,44 @@
+// Test that collections are all reopened after a restart when the storage engine catalog is
+// loaded on several threads.
+(function() {
+    "use strict";
+
+    // Parallel loading requires a storage engine with document-level locking.
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        return;
+    }
+
+    var numDbs = 4;
+    var collsPerDb = 100;
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    for (var i = 0; i < numDbs; i++) {
+        var testDB = conn.getDB("catalog_load_" + i);
+        for (var j = 0; j < collsPerDb; j++) {
+            assert.writeOK(testDB["coll" + j].insert({_id: j}));
+        }
+    }
+    MongoRunner.stopMongod(conn);
+
+    clearRawMongoProgramOutput();
+    conn = MongoRunner.runMongod({
+        restart: true,
+        cleanData: false,
+        dbpath: conn.dbpath,
+        setParameter: "storageEngineCatalogLoadThreads=4"
+    });
+    assert.neq(null, conn, "mongod was unable to restart");
+
+    assert(/Opened \d+ collections in \d+ms using 4 thread\(s\)/.test(rawMongoProgramOutput()),
+           "expected the catalog to be loaded on 4 threads");
+
+    for (var i = 0; i < numDbs; i++) {
+        var testDB = conn.getDB("catalog_load_" + i);
+        assert.eq(collsPerDb, testDB.getCollectionNames().length);
+        for (var j = 0; j < collsPerDb; j++) {
+            assert.eq({_id: j}, testDB["coll" + j].findOne());
+        }
+    }
+    MongoRunner.stopMongod(conn);
+}());
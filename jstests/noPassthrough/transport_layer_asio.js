@@ -0,0 +1,71 @@
+// Runs mongod with the asio transport layer through basic CRUD from several concurrent clients,
+// and checks that it shuts down cleanly.
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod(
+        {setParameter: {transportLayer: 'asio', transportLayerASIOReactorThreads: 2}});
+    assert.neq(null, conn, 'mongod failed to start with the asio transport layer');
+
+    var testDB = conn.getDB('test');
+    var coll = testDB.transport_layer_asio;
+
+    assert.writeOK(coll.insert({_id: 0, x: 0}));
+    assert.eq({_id: 0, x: 0}, coll.findOne({_id: 0}));
+    assert.writeOK(coll.update({_id: 0}, {$inc: {x: 1}}));
+    assert.eq(1, coll.findOne({_id: 0}).x);
+    assert.writeOK(coll.remove({_id: 0}));
+    assert.eq(0, coll.count());
+
+    // Getmores and large replies go through the same sessions.
+    var bulk = coll.initializeUnorderedBulkOp();
+    var padding = new Array(1024).join('x');
+    for (var i = 0; i < 5000; i++) {
+        bulk.insert({_id: i, padding: padding});
+    }
+    assert.writeOK(bulk.execute());
+    assert.eq(5000, coll.find().batchSize(100).itcount());
+
+    // Requests from several connections run on the worker pool.
+    var awaitShells = [];
+    for (var i = 0; i < 4; i++) {
+        awaitShells.push(startParallelShell(function() {
+            var coll = db.getSiblingDB('test').transport_layer_asio;
+            for (var j = 0; j < 200; j++) {
+                assert.writeOK(coll.update({_id: j}, {$inc: {n: 1}}));
+                assert.neq(null, coll.findOne({_id: j}));
+            }
+        }, conn.port));
+    }
+    awaitShells.forEach(function(awaitShell) {
+        awaitShell();
+    });
+    assert.eq(200, coll.find({n: 4}).itcount());
+
+    var status = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    assert(status.serviceExecutor, tojson(status));
+    assert.gt(status.serviceExecutor.totalRequests, 0, tojson(status.serviceExecutor));
+    assert.gte(status.connections.current, 1, tojson(status.connections));
+
+    // An idle connection that is still open does not keep mongod from shutting down.
+    var other = new Mongo(conn.host);
+    assert.commandWorked(other.adminCommand({ping: 1}));
+
+    assert.eq(0, MongoRunner.stopMongod(conn), 'mongod did not shut down cleanly');
+
+    // Worker pool bounds are checked when they are parsed.
+    [{serviceWorkerThreads: -1},
+     {serviceWorkerMinThreads: -1},
+     {serviceWorkerMinThreads: 8, serviceWorkerThreads: 4},
+     {serviceWorkerTargetQueueLatencyMicros: -1},
+    ].forEach(function(params) {
+        params.transportLayer = 'asio';
+        assert.eq(null, MongoRunner.runMongod({setParameter: params}), tojson(params));
+    });
+
+    // So are the transport layer options.
+    [{transportLayer: 'bogus'}, {transportLayer: 'asio', transportLayerASIOReactorThreads: -1}]
+        .forEach(function(params) {
+            assert.eq(null, MongoRunner.runMongod({setParameter: params}), tojson(params));
+        });
+})();
@@ -0,0 +1,53 @@
+// Check that with wiredTigerCappedBackgroundDeletion enabled, a user capped collection is still
+// trimmed to its maximum size by the background thread after mongod restarts.
+//
+// This test requires persistence because the capped collection must survive a restart.
+// @tags: [requires_persistence]
+(function() {
+    'use strict';
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because the storage engine is not wiredTiger');
+        return;
+    }
+
+    var baseName = 'wt_capped_background_deletion_restart';
+    var dbpath = MongoRunner.dataPath + baseName;
+    var maxSize = 1024 * 1024;
+    var options = {dbpath: dbpath, setParameter: {wiredTigerCappedBackgroundDeletion: true}};
+
+    function insertAndAwaitTrim(conn) {
+        var coll = conn.getDB('test').getCollection(baseName);
+        var padding = new Array(512).join('x');
+        for (var batch = 0; batch < 5; ++batch) {
+            var bulk = coll.initializeUnorderedBulkOp();
+            for (var i = 0; i < 1000; ++i) {
+                bulk.insert({batch: batch, i: i, padding: padding});
+            }
+            assert.writeOK(bulk.execute());
+        }
+
+        // The collection may exceed its size by about one stone's worth of records until the
+        // background thread catches up.
+        assert.soon(function() {
+            return coll.stats().size <= 2 * maxSize;
+        }, 'capped collection was not trimmed: ' + tojson(coll.stats()));
+
+        // The oldest documents are the ones that were removed.
+        assert.eq(0, coll.find({batch: 0}).itcount());
+        assert.eq(1000, coll.find({batch: 4}).itcount());
+    }
+
+    var conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'failed to start mongod');
+    assert.commandWorked(
+        conn.getDB('test').createCollection(baseName, {capped: true, size: maxSize}));
+    insertAndAwaitTrim(conn);
+    MongoRunner.stopMongod(conn);
+
+    options.noCleanData = true;
+    conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'failed to restart mongod');
+    insertAndAwaitTrim(conn);
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,36 @@
+// Test that repeat TLS connections from the same client resume their session rather than
+// performing a full handshake, and that serverStatus reports it.
+(function() {
+    "use strict";
+
+    var mongod = MongoRunner.runMongod({
+        sslMode: "requireSSL",
+        sslPEMKeyFile: "jstests/libs/server.pem",
+        sslCAFile: "jstests/libs/ca.pem"
+    });
+
+    function incomingSessionStats() {
+        var status = assert.commandWorked(mongod.getDB("admin").runCommand({serverStatus: 1}));
+        assert(status.security.SSLSessionCache, tojson(status.security));
+        return status.security.SSLSessionCache.incoming;
+    }
+
+    var before = incomingSessionStats();
+
+    var numConnections = 5;
+    for (var i = 0; i < numConnections; i++) {
+        var conn = new Mongo(mongod.host);
+        assert.commandWorked(conn.getDB("admin").runCommand({ping: 1}));
+    }
+
+    var after = incomingSessionStats();
+    assert.eq(before.resumed + before.fullHandshakes + numConnections,
+              after.resumed + after.fullHandshakes,
+              tojson(after));
+
+    // At most the first new connection may need a full handshake; the shell caches the session
+    // it negotiated and offers it on every later connection to the same server.
+    assert.gte(after.resumed - before.resumed, numConnections - 1, tojson(after));
+
+    MongoRunner.stopMongod(mongod);
+}());
@@ -73,14 +73,21 @@ const int BufferMaxSize = 64 * 1024 * 1024;
 template <typename Allocator>
 class StringBuilderImpl;
 
+/**
+ * Tag for constructing a BufBuilder whose buffers come from the SharedBufferPool. Use this for
+ * short-lived buffers that are built at a high rate, such as wire protocol replies.
+ */
+struct PooledBufferTag {};
+
 class SharedBufferAllocator {
     MONGO_DISALLOW_COPYING(SharedBufferAllocator);
 
 public:
     SharedBufferAllocator() = default;
+    explicit SharedBufferAllocator(PooledBufferTag) : _pooled(true) {}
 
     void malloc(size_t sz) {
-        _buf = SharedBuffer::allocate(sz);
+        _buf = _pooled ? SharedBuffer::allocatePooled(sz) : SharedBuffer::allocate(sz);
     }
     void realloc(size_t sz) {
         _buf.realloc(sz);
@@ -98,6 +105,7 @@ public:
 
 private:
     SharedBuffer _buf;
+    bool _pooled = false;
 };
 
 class StackAllocator {
@@ -151,6 +159,18 @@ public:
         l = 0;
         reservedBytes = 0;
     }
+
+    /**
+     * Only usable with BufBuilder. The builder's buffer, and so the one handed out by release(),
+     * comes from the SharedBufferPool.
+     */
+    _BufBuilder(PooledBufferTag tag, int initsize = 512) : _buf(tag), size(initsize) {
+        if (size > 0) {
+            _buf.malloc(size);
+        }
+        l = 0;
+        reservedBytes = 0;
+    }
     ~_BufBuilder() {
         kill();
     }
@@ -34,7 +34,14 @@
 
 #include "mongo/db/catalog/index_create.h"
 
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+#include <deque>
+#include <fstream>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/background.h"
@@ -47,9 +54,18 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/paths.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/file.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/progress_meter.h"
@@ -63,6 +79,111 @@ using std::endl;
 
 MONGO_FP_DECLARE(crashAfterStartingIndexBuild);
 MONGO_FP_DECLARE(hangAfterStartingIndexBuild);
+MONGO_FP_DECLARE(crashAfterIndexBuildCheckpoint);
+
+namespace {
+
+// Number of threads generating and sorting keys for foreground index builds. With 1, keys are
+// generated on the thread scanning the collection.
+std::atomic<int> indexBuildKeyGenerationThreads(1);  // NOLINT
+
+class ExportedIndexBuildKeyGenerationThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedIndexBuildKeyGenerationThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "indexBuildKeyGenerationThreads",
+              &indexBuildKeyGenerationThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "indexBuildKeyGenerationThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    }
+} exportedIndexBuildKeyGenerationThreadsParam;
+
+// Documents handed from the collection scan to a key generation thread at a time.
+const size_t kKeyGenerationBatchSize = 256;
+
+// Seconds between checkpoints of a foreground index build, which let the build resume after a
+// restart instead of starting over. 0 disables checkpoints.
+std::atomic<int> indexBuildCheckpointIntervalSecs(60);  // NOLINT
+
+class ExportedIndexBuildCheckpointIntervalSecsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedIndexBuildCheckpointIntervalSecsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "indexBuildCheckpointIntervalSecs",
+              &indexBuildCheckpointIntervalSecs) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "indexBuildCheckpointIntervalSecs must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedIndexBuildCheckpointIntervalSecsParam;
+
+// Every index build writing checkpoints gets a directory under this one, named by an ObjectId.
+// It holds the keys spilled by the build's BulkBuilders and its latest checkpoint.
+boost::filesystem::path checkpointsPath() {
+    return boost::filesystem::path(storageGlobalParams.dbpath) / "_indexBuildCheckpoints";
+}
+
+const char kCheckpointFileName[] = "checkpoint.bson";
+
+// Bump whenever the checkpoint or the sorter runs it points to change their on-disk format.
+// Checkpoints of any other version are ignored.
+const int kCheckpointFormatVersion = 1;
+
+void writeCheckpointFile(const boost::filesystem::path& dir, const BSONObj& checkpoint) {
+    const boost::filesystem::path path = dir / kCheckpointFileName;
+    const boost::filesystem::path tempPath = dir / (std::string(kCheckpointFileName) + ".tmp");
+
+    boost::filesystem::create_directories(dir);
+    boost::filesystem::remove(tempPath);
+    {
+        File file;
+        file.open(tempPath.string().c_str());
+        file.write(0, checkpoint.objdata(), checkpoint.objsize());
+        uassert(40324,
+                str::stream() << "failed to write index build checkpoint " << tempPath.string(),
+                !file.bad());
+        file.fsync();
+    }
+
+    // Only replace the previous checkpoint once this one is complete, and make both the rename
+    // and the build's directory durable, or a crash could lose the checkpoint or leave a stale one.
+    boost::filesystem::rename(tempPath, path);
+    flushMyDirectory(path);
+    flushMyDirectory(dir);
+}
+
+StatusWith<BSONObj> readCheckpointFile(const boost::filesystem::path& path) {
+    const auto size = boost::filesystem::file_size(path);
+    std::unique_ptr<char[]> buffer(new char[size]);
+    std::ifstream ifs(path.string().c_str(), std::ios_base::in | std::ios_base::binary);
+    ifs.read(buffer.get(), size);
+    if (!ifs) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "failed to read " << path.string() << ": "
+                              << errnoWithDescription()};
+    }
+
+    Status status = validateBSON(buffer.get(), size, BSONVersion::kLatest);
+    if (!status.isOK()) {
+        return status;
+    }
+    return BSONObj(buffer.get()).getOwned();
+}
+
+}  // namespace
 
 /**
  * On rollback sets MultiIndexBlock::_needToCleanup to true.
@@ -98,15 +219,217 @@ private:
     MultiIndexBlock* const _indexer;
 };
 
+/**
+ * Generates the keys of a foreground (bulk) index build on several threads. The collection scan
+ * hands documents over in batches, and every thread owns one BulkBuilder per index, so
+ * generating and sorting keys needs no synchronization. Each thread sorts its keys once the scan
+ * is over; the sorted runs of all threads are merged when the bulk load is committed.
+ */
+class MultiIndexBlock::ParallelKeyGenerator {
+    MONGO_DISALLOW_COPYING(ParallelKeyGenerator);
+
+public:
+    ParallelKeyGenerator(MultiIndexBlock* indexer, size_t numThreads) : _indexer(indexer) {
+        const size_t memoryPerBuilder =
+            IndexAccessMethod::kDefaultMaxBulkMemoryUsageBytes / numThreads;
+        for (size_t i = 0; i < numThreads; i++) {
+            std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks;
+            for (auto& index : _indexer->_indexes) {
+                bulks.push_back(index.real->initiateBulk(memoryPerBuilder));
+            }
+            _bulks.push_back(std::move(bulks));
+        }
+        for (size_t i = 0; i < numThreads; i++) {
+            _threads.emplace_back([this, i] { _run(i); });
+        }
+    }
+
+    ~ParallelKeyGenerator() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _shutdown = true;
+            _queue.clear();
+        }
+        _workAvailable.notify_all();
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Queues a document for key generation. Blocks while the threads are behind. Returns the
+     * first error any thread ran into.
+     */
+    Status insert(const BSONObj& doc, const RecordId& loc) {
+        _batch.emplace_back(doc.getOwned(), loc);
+        if (_batch.size() < kKeyGenerationBatchSize) {
+            return Status::OK();
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _spaceAvailable.wait(
+            lk, [&] { return !_status.isOK() || _queue.size() < 2 * _threads.size(); });
+        if (!_status.isOK()) {
+            return _status;
+        }
+        _queue.push_back(std::move(_batch));
+        _batch.clear();
+        lk.unlock();
+        _workAvailable.notify_one();
+        return Status::OK();
+    }
+
+    /**
+     * Waits for the threads to generate and sort all keys, reporting progress in currentOp, and
+     * hands their BulkBuilders to the indexes being built.
+     */
+    Status finish(OperationContext* txn) {
+        stdx::unique_lock<Client> clientLock(*txn->getClient());
+        ProgressMeterHolder progress(*txn->setMessage_inlock(
+            "Index Build: sorting keys", "Index: Sorting Keys Progress", _threads.size(), 1));
+        clientLock.unlock();
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (!_batch.empty()) {
+            _queue.push_back(std::move(_batch));
+            _batch.clear();
+        }
+        _scanDone = true;
+        _workAvailable.notify_all();
+
+        size_t reported = 0;
+        while (reported < _threads.size()) {
+            _threadDone.wait(lk, [&] { return _threadsDone > reported; });
+            progress->hit(_threadsDone - reported);
+            reported = _threadsDone;
+        }
+        lk.unlock();
+
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+        _threads.clear();
+        progress->finished();
+
+        if (!_status.isOK()) {
+            return _status;
+        }
+
+        for (auto& bulks : _bulks) {
+            for (size_t i = 0; i < bulks.size(); i++) {
+                _indexer->_indexes[i].workerBulks.push_back(std::move(bulks[i]));
+            }
+        }
+        return Status::OK();
+    }
+
+private:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    void _run(size_t thread) {
+        setThreadName(str::stream() << "IndexBuildKeyGenerator-" << thread);
+        auto& bulks = _bulks[thread];
+        const auto& indexes = _indexer->_indexes;
+
+        while (true) {
+            Batch batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _workAvailable.wait(lk, [&] { return _shutdown || _scanDone || !_queue.empty(); });
+                if (_shutdown || (_queue.empty() && _scanDone)) {
+                    break;
+                }
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            _spaceAvailable.notify_one();
+
+            try {
+                for (const auto& doc : batch) {
+                    for (size_t i = 0; i < indexes.size(); i++) {
+                        if (indexes[i].filterExpression &&
+                            !indexes[i].filterExpression->matchesBSON(doc.first)) {
+                            continue;
+                        }
+                        // The scanning thread's OperationContext is not safe to share, and
+                        // generating keys does not need one.
+                        uassertStatusOK(bulks[i]->insert(
+                            nullptr, doc.first, doc.second, indexes[i].options, nullptr));
+                    }
+                }
+            } catch (const DBException& ex) {
+                _fail(ex.toStatus());
+                break;
+            }
+        }
+
+        bool failed;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            failed = _shutdown;
+        }
+        if (!failed) {
+            try {
+                for (auto& bulk : bulks) {
+                    bulk->finishSorting();
+                }
+            } catch (const DBException& ex) {
+                _fail(ex.toStatus());
+            }
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _threadsDone++;
+        _threadDone.notify_all();
+    }
+
+    void _fail(Status status) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_status.isOK()) {
+                _status = std::move(status);
+            }
+            _shutdown = true;
+            _queue.clear();
+        }
+        _workAvailable.notify_all();
+        _spaceAvailable.notify_all();
+    }
+
+    MultiIndexBlock* const _indexer;
+
+    // Indexed by thread, then by the position of the index in MultiIndexBlock::_indexes.
+    std::vector<std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>> _bulks;
+    std::vector<stdx::thread> _threads;
+
+    // Documents not yet handed to the threads. Only used by the scanning thread.
+    Batch _batch;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+    stdx::condition_variable _threadDone;
+    std::deque<Batch> _queue;
+    bool _scanDone = false;
+    bool _shutdown = false;
+    size_t _threadsDone = 0;
+    Status _status = Status::OK();
+};
+
 MultiIndexBlock::MultiIndexBlock(OperationContext* txn, Collection* collection)
     : _collection(collection),
       _txn(txn),
       _buildInBackground(false),
       _allowInterruption(false),
       _ignoreUnique(false),
-      _needToCleanup(true) {}
+      _allowResumingFromCheckpoint(false),
+      _needToCleanup(true),
+      _keepCheckpoints(false) {}
 
 MultiIndexBlock::~MultiIndexBlock() {
+    if (!_keepCheckpoints)
+        _removeCheckpoints();
+
     if (!_needToCleanup || _indexes.empty())
         return;
     while (true) {
@@ -182,6 +505,13 @@ Status MultiIndexBlock::init(const std::vector<BSONObj>& indexSpecs) {
         _buildInBackground = (_buildInBackground && info["background"].trueValue());
     }
 
+    // Checkpoints are only useful if the indexes being built survive a restart.
+    if (_checkpointDir.empty() && !_buildInBackground &&
+        indexBuildCheckpointIntervalSecs.load() > 0 &&
+        _txn->getServiceContext()->getGlobalStorageEngine()->isDurable()) {
+        _checkpointDir = (checkpointsPath() / OID::gen().toString()).string();
+    }
+
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
         StatusWith<BSONObj> statusWithInfo =
@@ -205,7 +535,8 @@ Status MultiIndexBlock::init(const std::vector<BSONObj>& indexSpecs) {
         if (!_buildInBackground) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
-            index.bulk = index.real->initiateBulk();
+            index.bulk = index.real->initiateBulk(
+                IndexAccessMethod::kDefaultMaxBulkMemoryUsageBytes, _checkpointDir);
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -255,8 +586,30 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
 
     unsigned long long n = 0;
 
-    unique_ptr<PlanExecutor> exec(InternalPlanner::collectionScan(
-        _txn, _collection->ns().ns(), _collection, PlanExecutor::YIELD_MANUAL));
+    RecordId resumeAfter;
+    if (_allowResumingFromCheckpoint) {
+        resumeAfter = _resumeFromCheckpoint(&n);
+        progress->hit(static_cast<int>(n));
+    }
+
+    // Keys for bulk builds only go to in-memory sorters, so they can be generated off this
+    // thread. Background builds insert into the live indexes and stay on this thread.
+    unique_ptr<ParallelKeyGenerator> keyGenerator;
+    const int keyGenerationThreads = indexBuildKeyGenerationThreads.load();
+    if (keyGenerationThreads > 1 && !_buildInBackground &&
+        std::all_of(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+            return index.bulk != nullptr;
+        })) {
+        log() << "generating index keys on " << keyGenerationThreads << " threads";
+        keyGenerator = stdx::make_unique<ParallelKeyGenerator>(this, keyGenerationThreads);
+    }
+
+    unique_ptr<PlanExecutor> exec(InternalPlanner::collectionScan(_txn,
+                                                                  _collection->ns().ns(),
+                                                                  _collection,
+                                                                  PlanExecutor::YIELD_MANUAL,
+                                                                  InternalPlanner::FORWARD,
+                                                                  resumeAfter));
     if (_buildInBackground) {
         invariant(_allowInterruption);
         exec->setYieldPolicy(PlanExecutor::YIELD_AUTO, _collection);
@@ -264,12 +617,21 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
         exec->setYieldPolicy(PlanExecutor::WRITE_CONFLICT_RETRY_ONLY, _collection);
     }
 
+    // Checkpoints need all keys to be in the BulkBuilders of '_indexes'.
+    bool writeCheckpoints = !_checkpointDir.empty() && !keyGenerator;
+    Timer sinceCheckpoint;
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
     int retries = 0;  // non-zero when retrying our last document.
     while (retries ||
            (PlanExecutor::ADVANCED == (state = exec->getNextSnapshotted(&objToIndex, &loc)))) {
+        if (!resumeAfter.isNull() && loc == resumeAfter) {
+            // The scan starts with the last document indexed before the checkpoint.
+            continue;
+        }
+
         try {
             if (_allowInterruption)
                 _txn->checkForInterrupt();
@@ -286,7 +648,8 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
             progress->setTotalWhileRunning(_collection->numRecords(_txn));
 
             WriteUnitOfWork wunit(_txn);
-            Status ret = insert(objToIndex.value(), loc);
+            Status ret = keyGenerator ? keyGenerator->insert(objToIndex.value(), loc)
+                                      : insert(objToIndex.value(), loc);
             if (_buildInBackground)
                 exec->saveState();
             if (ret.isOK()) {
@@ -317,6 +680,29 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
             _txn->recoveryUnit()->abandonSnapshot();
             exec->restoreState();  // Handles any WCEs internally.
         }
+
+        if (!writeCheckpoints || retries)
+            continue;
+
+        bool crashAfterCheckpoint = false;
+        MONGO_FAIL_POINT_BLOCK(crashAfterIndexBuildCheckpoint, extraData) {
+            crashAfterCheckpoint = n == static_cast<unsigned long long>(
+                                            extraData.getData()["afterRecords"].numberLong());
+        }
+
+        const int checkpointIntervalSecs = indexBuildCheckpointIntervalSecs.load();
+        if (crashAfterCheckpoint ||
+            (checkpointIntervalSecs > 0 && sinceCheckpoint.seconds() >= checkpointIntervalSecs)) {
+            writeCheckpoints = _writeCheckpoint(loc, n);
+            sinceCheckpoint.reset();
+        }
+
+        if (crashAfterCheckpoint) {
+            log() << "Index build interrupted due to 'crashAfterIndexBuildCheckpoint' failpoint. "
+                     "Exiting after a checkpoint at "
+                  << n << " records.";
+            quickExit(EXIT_TEST);
+        }
     }
 
     uassert(28550,
@@ -333,6 +719,12 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
 
     progress->finished();
 
+    if (keyGenerator) {
+        Status status = keyGenerator->finish(_txn);
+        if (!status.isOK())
+            return status;
+    }
+
     Status ret = doneInserting(dupsOut);
     if (!ret.isOK())
         return ret;
@@ -368,8 +760,11 @@ Status MultiIndexBlock::doneInserting(std::set<RecordId>* dupsOut) {
             continue;
         LOG(1) << "\t bulk commit starting for index: "
                << _indexes[i].block->getEntry()->descriptor()->indexName();
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks =
+            std::move(_indexes[i].workerBulks);
+        bulks.push_back(std::move(_indexes[i].bulk));
         Status status = _indexes[i].real->commitBulk(_txn,
-                                                     std::move(_indexes[i].bulk),
+                                                     std::move(bulks),
                                                      _allowInterruption,
                                                      _indexes[i].options.dupsAllowed,
                                                      dupsOut);
@@ -384,6 +779,7 @@ Status MultiIndexBlock::doneInserting(std::set<RecordId>* dupsOut) {
 void MultiIndexBlock::abortWithoutCleanup() {
     _indexes.clear();
     _needToCleanup = false;
+    _keepCheckpoints = true;
 }
 
 void MultiIndexBlock::commit() {
@@ -395,4 +791,157 @@ void MultiIndexBlock::commit() {
     _needToCleanup = false;
 }
 
+bool MultiIndexBlock::_writeCheckpoint(const RecordId& lastIndexed, unsigned long long numScanned) {
+    const std::string& ns = _collection->ns().ns();
+    Timer t;
+
+    // Only the checkpoint itself needs flushing. If the indexes being built are still in the
+    // catalog after a crash, so are the documents that were there when the build started, and a
+    // foreground build keeps any others from being written until it is done.
+    try {
+        BSONObjBuilder builder;
+        builder.append("version", kCheckpointFormatVersion);
+        builder.append("ns", ns);
+        builder.append("lastIndexed", lastIndexed.repr());
+        builder.append("numScanned", static_cast<long long>(numScanned));
+        {
+            BSONArrayBuilder indexes(builder.subarrayStart("indexes"));
+            for (const auto& index : _indexes) {
+                BSONObjBuilder indexBuilder(indexes.subobjStart());
+                indexBuilder.append("spec", index.block->getEntry()->descriptor()->infoObj());
+                BSONObjBuilder bulkBuilder(indexBuilder.subobjStart("bulk"));
+                index.bulk->persistForResume(&bulkBuilder);
+            }
+        }
+
+        writeCheckpointFile(_checkpointDir, builder.obj());
+    } catch (const std::exception& e) {
+        // The build itself can go on, it just has to start over if it is interrupted.
+        warning() << "failed to write checkpoint of index build on " << ns
+                  << ", no longer writing checkpoints: " << redact(e.what());
+        return false;
+    }
+
+    LOG(1) << "wrote checkpoint of index build on " << ns << " after " << numScanned
+           << " records in " << t.millis() << "ms";
+    return true;
+}
+
+RecordId MultiIndexBlock::_resumeFromCheckpoint(unsigned long long* numScanned) {
+    const std::string& ns = _collection->ns().ns();
+    const auto isSameSpec = [](const BSONObj& lhs, const BSONObj& rhs) {
+        return SimpleBSONObjComparator::kInstance.evaluate(lhs == rhs);
+    };
+
+    // Of the checkpoints of builds of the same indexes, the one that got furthest wins. Older
+    // checkpoints are left behind when a resumed build writes its own.
+    BSONObj checkpoint;
+    boost::system::error_code ec;
+    for (boost::filesystem::directory_iterator it(checkpointsPath(), ec), end; !ec && it != end;
+         it.increment(ec)) {
+        const boost::filesystem::path path = it->path() / kCheckpointFileName;
+        if (!boost::filesystem::exists(path))
+            continue;
+
+        try {
+            BSONObj candidate = uassertStatusOK(readCheckpointFile(path));
+            if (candidate["version"].numberInt() != kCheckpointFormatVersion) {
+                warning() << "ignoring index build checkpoint " << path.string()
+                          << " with unsupported format version " << candidate["version"];
+                continue;
+            }
+            if (candidate["ns"].String() != ns)
+                continue;
+
+            const auto candidateIndexes = candidate["indexes"].Array();
+            const bool sameIndexes = candidateIndexes.size() == _indexes.size() &&
+                std::all_of(_indexes.begin(), _indexes.end(), [&](const IndexToBuild& index) {
+                    const BSONObj spec = index.block->getEntry()->descriptor()->infoObj();
+                    return std::any_of(candidateIndexes.begin(),
+                                       candidateIndexes.end(),
+                                       [&](const BSONElement& candidateIndex) {
+                                           return isSameSpec(candidateIndex["spec"].Obj(), spec);
+                                       });
+                });
+            if (sameIndexes &&
+                (checkpoint.isEmpty() ||
+                 candidate["numScanned"].numberLong() > checkpoint["numScanned"].numberLong())) {
+                checkpoint = candidate;
+            }
+        } catch (const std::exception& e) {
+            warning() << "ignoring index build checkpoint " << path.string() << ": "
+                      << redact(e.what());
+        }
+    }
+
+    if (checkpoint.isEmpty())
+        return RecordId();
+
+    try {
+        // The collection cannot change while a foreground build holds its lock, so the
+        // documents indexed before the checkpoint are still there, in the same order.
+        const RecordId lastIndexed(checkpoint["lastIndexed"].numberLong());
+        Snapshotted<BSONObj> unused;
+        uassert(ErrorCodes::NoSuchKey,
+                str::stream() << "last record indexed " << lastIndexed << " no longer exists",
+                _collection->findDoc(_txn, lastIndexed, &unused));
+
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks;
+        for (const auto& index : _indexes) {
+            uassert(ErrorCodes::IllegalOperation,
+                    "only foreground index builds can be resumed",
+                    index.bulk);
+            const BSONObj spec = index.block->getEntry()->descriptor()->infoObj();
+            for (const auto& checkpointIndex : checkpoint["indexes"].Array()) {
+                if (isSameSpec(checkpointIndex["spec"].Obj(), spec)) {
+                    bulks.push_back(uassertStatusOK(
+                        index.real->resumeBulk(checkpointIndex["bulk"].Obj(), _checkpointDir)));
+                    break;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < _indexes.size(); i++) {
+            _indexes[i].bulk = std::move(bulks[i]);
+        }
+
+        *numScanned = checkpoint["numScanned"].numberLong();
+        log() << "resuming index build on " << ns << " from a checkpoint after " << *numScanned
+              << " records";
+        return lastIndexed;
+    } catch (const DBException& e) {
+        warning() << "cannot resume index build on " << ns
+                  << " from its checkpoint, starting over: " << redact(e);
+        return RecordId();
+    }
+}
+
+void MultiIndexBlock::_removeCheckpoints() {
+    if (_checkpointDir.empty())
+        return;
+
+    // Files still open cannot be removed on Windows.
+    for (auto& index : _indexes) {
+        index.bulk.reset();
+        index.workerBulks.clear();
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(_checkpointDir, ec);
+    if (ec) {
+        warning() << "failed to remove index build checkpoint directory " << _checkpointDir << ": "
+                  << ec.message();
+    }
+    _checkpointDir.clear();
+}
+
+void MultiIndexBlock::removeCheckpointsOfInterruptedBuilds() {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(checkpointsPath(), ec);
+    if (ec) {
+        warning() << "failed to remove index build checkpoints in " << checkpointsPath().string()
+                  << ": " << ec.message();
+    }
+}
+
 }  // namespace mongo
@@ -88,6 +88,21 @@ public:
         _allowInterruption = true;
     }
 
+    /**
+     * Call this before init() to let a foreground build pick up where an interrupted build of the
+     * same indexes left off, if that build wrote a checkpoint. Meant for restarting interrupted
+     * index builds at startup.
+     */
+    void allowResumingFromCheckpoint() {
+        _allowResumingFromCheckpoint = true;
+    }
+
+    /**
+     * Removes the checkpoints written by index builds that were interrupted by a shutdown or
+     * crash. Call once the builds that could resume from them have been restarted.
+     */
+    static void removeCheckpointsOfInterruptedBuilds();
+
     /**
      * By default we enforce the 'unique' flag in specs when building an index by failing.
      * If this is called before init(), we will ignore unique violations. This has no effect if
@@ -188,6 +203,7 @@ public:
 private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
+    class ParallelKeyGenerator;
 
     struct IndexToBuild {
         std::unique_ptr<IndexCatalog::IndexBuildBlock> block;
@@ -196,9 +212,31 @@ private:
         const MatchExpression* filterExpression;  // might be NULL, owned elsewhere
         std::unique_ptr<IndexAccessMethod::BulkBuilder> bulk;
 
+        // Filled by the threads of a ParallelKeyGenerator, committed together with 'bulk'.
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> workerBulks;
+
         InsertDeleteOptions options;
     };
 
+    /**
+     * Makes the keys generated so far, and the position of the collection scan that produced them,
+     * durable so that the build can resume from 'lastIndexed' after a restart. Returns false if
+     * writing the checkpoint failed, in which case no more should be written.
+     */
+    bool _writeCheckpoint(const RecordId& lastIndexed, unsigned long long numScanned);
+
+    /**
+     * Replaces the BulkBuilders with ones holding the keys of the latest checkpoint of an
+     * interrupted build of the same indexes, if there is one that can be used. Returns the last
+     * record indexed before that checkpoint and sets 'numScanned', or returns a null RecordId.
+     */
+    RecordId _resumeFromCheckpoint(unsigned long long* numScanned);
+
+    /**
+     * Removes the checkpoints of this build, and the keys the BulkBuilders spilled next to them.
+     */
+    void _removeCheckpoints();
+
     std::vector<IndexToBuild> _indexes;
 
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
@@ -210,8 +248,14 @@ private:
     bool _buildInBackground;
     bool _allowInterruption;
     bool _ignoreUnique;
+    bool _allowResumingFromCheckpoint;
 
     bool _needToCleanup;
+
+    // Where the BulkBuilders of this MultiIndexBlock spill keys and where it writes checkpoints.
+    // Empty if it does not write checkpoints.
+    std::string _checkpointDir;
+    bool _keepCheckpoints;
 };
 
 }  // namespace mongo
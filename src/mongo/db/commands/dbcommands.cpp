@@ -1286,6 +1286,15 @@ void Command::execCommand(OperationContext* txn,
             opCounters->gotCommand();
         }
 
+        // Requests from other members of the cluster are admitted ahead of regular client
+        // traffic when the storage engine runs short of concurrent transaction tickets.
+        if (AuthorizationManager::get(txn->getServiceContext())->isAuthEnabled() &&
+            AuthorizationSession::get(txn->getClient())
+                ->isAuthorizedForActionsOnResource(ResourcePattern::forClusterResource(),
+                                                   ActionType::internal)) {
+            txn->lockState()->setAdmissionPriority(TicketPriority::kHigh);
+        }
+
         // Handle command option maxTimeMS.
         int maxTimeMS = uassertStatusOK(
             QueryRequest::parseMaxTimeMS(extractedFields[kCmdOptionMaxTimeMSField]));
@@ -51,9 +51,11 @@
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostname_canonicalization.h"
+#include "mongo/util/net/listen.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
+#include "mongo/util/shared_buffer_pool.h"
 #include "mongo/util/time_support.h"
 #include "mongo/util/version.h"
 
@@ -282,6 +284,10 @@ public:
         BSONObjBuilder b;
         networkCounter.append(b);
         appendMessageCompressionStats(&b);
+        SharedBufferPool::appendStats(&b);
+        if (auto listener = Listener::get(txn->getServiceContext())) {
+            listener->appendStats(&b);
+        }
         return b.obj();
     }
 
@@ -298,7 +304,10 @@ public:
     BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const {
         BSONObj result;
         if (getSSLManager()) {
-            result = getSSLManager()->getSSLConfiguration().getServerStatusBSON();
+            BSONObjBuilder b;
+            b.appendElements(getSSLManager()->getSSLConfiguration().getServerStatusBSON());
+            getSSLManager()->appendSessionCacheStats(&b);
+            result = b.obj();
         }
 
         return result;
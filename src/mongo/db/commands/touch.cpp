@@ -46,6 +46,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/warm_up.h"
 #include "mongo/util/timer.h"
 #include "mongo/util/touch_pages.h"
 
@@ -72,7 +73,8 @@ public:
         help << "touch collection\n"
                 "Page in all pages of memory containing every extent for the given collection\n"
                 "{ touch : <collection_name>, [data : true] , [index : true] }\n"
-                " at least one of data or index must be true; default is both are false\n";
+                " at least one of data or index must be true; default is both are false\n"
+                " storage engines that cannot touch extents directly scan the collection instead\n";
     }
     virtual void addRequiredPrivileges(const std::string& dbname,
                                        const BSONObj& cmdObj,
@@ -103,16 +105,54 @@ public:
             return false;
         }
 
-        AutoGetCollectionForRead context(txn, nss);
+        {
+            AutoGetCollectionForRead context(txn, nss);
 
-        Collection* collection = context.getCollection();
-        if (!collection) {
-            errmsg = "collection not found";
-            return false;
+            Collection* collection = context.getCollection();
+            if (!collection) {
+                errmsg = "collection not found";
+                return false;
+            }
+
+            BSONObjBuilder touchResult;
+            Status status = collection->touch(txn, touch_data, touch_indexes, &touchResult);
+            if (status != ErrorCodes::CommandNotSupported) {
+                result.appendElements(touchResult.obj());
+                return appendCommandStatus(result, status);
+            }
+        }
+
+        // The storage engine has no way to page in a collection directly, so read it through
+        // cursors instead. This releases the collection lock between chunks of the scan.
+        if (touch_data) {
+            Timer t;
+            WarmUpOptions options;
+            options.data = true;
+            WarmUpStats stats;
+            Status status = warmUpCollection(txn, nss, options, &stats);
+            if (!status.isOK())
+                return appendCommandStatus(result, status);
+
+            result.append("data",
+                          BSON("numRecords" << stats.records << "bytes" << stats.bytes << "millis"
+                                            << t.millis()));
         }
 
-        return appendCommandStatus(result,
-                                   collection->touch(txn, touch_data, touch_indexes, &result));
+        if (touch_indexes) {
+            Timer t;
+            WarmUpOptions options;
+            options.indexes = true;
+            WarmUpStats stats;
+            Status status = warmUpCollection(txn, nss, options, &stats);
+            if (!status.isOK())
+                return appendCommandStatus(result, status);
+
+            result.append("indexes",
+                          BSON("numKeys" << stats.indexKeys << "bytes" << stats.bytes << "millis"
+                                         << t.millis()));
+        }
+
+        return true;
     }
 };
 static TouchCmd touchCmd;
@@ -314,7 +314,7 @@ LockResult LockerImpl<IsForMMAPV1>::lockGlobalBegin(LockMode mode) {
         auto holder = ticketHolders[mode];
         if (holder) {
             _clientState.store(reader ? kQueuedReader : kQueuedWriter);
-            holder->waitForTicket();
+            holder->waitForTicket(getAdmissionPriority());
         }
         _clientState.store(reader ? kActiveReader : kActiveWriter);
         _modeForTicket = mode;
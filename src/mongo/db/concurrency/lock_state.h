@@ -252,8 +252,16 @@ public:
         return _batchWriter;
     }
 
+    virtual void setAdmissionPriority(TicketPriority priority) {
+        _admissionPriority = priority;
+    }
+    virtual TicketPriority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
 private:
     bool _batchWriter;
+    TicketPriority _admissionPriority = TicketPriority::kNormal;
 };
 
 typedef LockerImpl<false> DefaultLockerImpl;
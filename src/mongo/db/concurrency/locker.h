@@ -33,6 +33,7 @@
 
 #include "mongo/db/concurrency/lock_manager.h"
 #include "mongo/db/concurrency/lock_stats.h"
+#include "mongo/util/concurrency/ticketholder.h"
 
 namespace mongo {
 
@@ -307,8 +308,37 @@ public:
     virtual void setIsBatchWriter(bool newValue) = 0;
     virtual bool isBatchWriter() const = 0;
 
+    /**
+     * Priority class used when the global lock acquisition has to queue for a ticket. Takes
+     * effect on the next acquisition of the global lock.
+     */
+    virtual void setAdmissionPriority(TicketPriority priority) = 0;
+    virtual TicketPriority getAdmissionPriority() const = 0;
+
 protected:
     Locker() {}
 };
 
+/**
+ * Overrides the admission priority of a locker for the lifetime of this object, restoring the
+ * previous priority on destruction.
+ */
+class AdmissionPriorityScope {
+    MONGO_DISALLOW_COPYING(AdmissionPriorityScope);
+
+public:
+    AdmissionPriorityScope(Locker* locker, TicketPriority priority)
+        : _locker(locker), _previous(locker->getAdmissionPriority()) {
+        _locker->setAdmissionPriority(priority);
+    }
+
+    ~AdmissionPriorityScope() {
+        _locker->setAdmissionPriority(_previous);
+    }
+
+private:
+    Locker* const _locker;
+    const TicketPriority _previous;
+};
+
 }  // namespace mongo
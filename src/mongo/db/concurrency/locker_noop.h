@@ -167,6 +167,12 @@ public:
     virtual bool isBatchWriter() const {
         invariant(false);
     }
+
+    virtual void setAdmissionPriority(TicketPriority priority) {}
+
+    virtual TicketPriority getAdmissionPriority() const {
+        return TicketPriority::kNormal;
+    }
 };
 
 }  // namespace mongo
@@ -68,6 +68,7 @@
 #include "mongo/db/dbwebserver.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/ftdc/ftdc_mongod.h"
+#include "mongo/db/hot_data_monitor.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/index_rebuilder.h"
 #include "mongo/db/initialize_server_global_state.h"
@@ -119,7 +120,9 @@
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/transport_layer_asio.h"
 #include "mongo/transport/transport_layer_legacy.h"
+#include "mongo/transport/transport_layer_startup_param.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/cmdline_utils/censor_cmdline.h"
 #include "mongo/util/concurrency/task.h"
@@ -517,6 +520,8 @@ void _initWireSpec() {
 ExitCode _initAndListen(int listenPort) {
     Client::initThread("initandlisten");
 
+    Timer startupTimer;
+
     _initWireSpec();
     auto globalServiceContext = getGlobalServiceContext();
 
@@ -554,10 +559,6 @@ ExitCode _initAndListen(int listenPort) {
 
     checked_cast<ServiceContextMongoD*>(getGlobalServiceContext())->createLockFile();
 
-    transport::TransportLayerLegacy::Options options;
-    options.port = listenPort;
-    options.ipList = serverGlobalParams.bind_ip;
-
     auto sep =
         stdx::make_unique<ServiceEntryPointMongod>(getGlobalServiceContext()->getTransportLayer());
     auto sepPtr = sep.get();
@@ -565,8 +566,27 @@ ExitCode _initAndListen(int listenPort) {
     getGlobalServiceContext()->setServiceEntryPoint(std::move(sep));
 
     // Create, start, and attach the TL
-    auto transportLayer = stdx::make_unique<transport::TransportLayerLegacy>(options, sepPtr);
-    auto res = transportLayer->setup();
+    std::unique_ptr<transport::TransportLayer> transportLayer;
+    Status res = Status::OK();
+    if (transport::isTransportLayerASIO()) {
+        transport::TransportLayerASIO::Options options;
+        options.port = listenPort;
+        options.ipList = serverGlobalParams.bind_ip;
+        options.reactorThreads = transport::getTransportLayerASIOReactorThreads();
+
+        auto asioTransportLayer = stdx::make_unique<transport::TransportLayerASIO>(options, sepPtr);
+        res = asioTransportLayer->setup();
+        transportLayer = std::move(asioTransportLayer);
+    } else {
+        transport::TransportLayerLegacy::Options options;
+        options.port = listenPort;
+        options.ipList = serverGlobalParams.bind_ip;
+
+        auto legacyTransportLayer =
+            stdx::make_unique<transport::TransportLayerLegacy>(options, sepPtr);
+        res = legacyTransportLayer->setup();
+        transportLayer = std::move(legacyTransportLayer);
+    }
     if (!res.isOK()) {
         error() << "Failed to set up listener: " << res;
         return EXIT_NET_ERROR;
@@ -584,7 +604,9 @@ ExitCode _initAndListen(int listenPort) {
         }
     }
 
+    Timer phaseTimer;
     getGlobalServiceContext()->initializeGlobalStorageEngine();
+    log() << "Storage engine initialized in " << phaseTimer.millis() << "ms";
 
 #ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
     if (WiredTigerCustomizationHooks::get(getGlobalServiceContext())->restartRequired()) {
@@ -668,7 +690,9 @@ ExitCode _initAndListen(int listenPort) {
 
     auto startupOpCtx = getGlobalServiceContext()->makeOperationContext(&cc());
 
+    phaseTimer.reset();
     repairDatabasesAndCheckVersion(startupOpCtx.get());
+    log() << "Opened and checked all databases in " << phaseTimer.millis() << "ms";
 
     if (storageGlobalParams.upgrade) {
         log() << "finished checking dbs";
@@ -780,6 +804,12 @@ ExitCode _initAndListen(int listenPort) {
             startTTLBackgroundJob();
         }
 
+        // An ephemeral engine starts empty, so there is nothing to warm up and no cache worth
+        // summarizing for the next restart.
+        if (!getGlobalServiceContext()->getGlobalStorageEngine()->isEphemeral()) {
+            startHotDataMonitor();
+        }
+
         if (!replSettings.usingReplSets() && !replSettings.isSlave() &&
             storageGlobalParams.engine != "devnull") {
             ScopedTransaction transaction(startupOpCtx.get(), MODE_X);
@@ -802,6 +832,7 @@ ExitCode _initAndListen(int listenPort) {
         error() << "Failed to start the listener: " << start.toString();
         return EXIT_NET_ERROR;
     }
+    log() << "Startup completed in " << startupTimer.millis() << "ms";
 
     return waitForShutdown();
 }
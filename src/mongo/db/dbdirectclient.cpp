@@ -127,6 +127,7 @@ bool DBDirectClient::call(Message& toSend, Message& response, bool assertOk, str
     assembleResponse(_txn, toSend, dbResponse, dummyHost);
     verify(!dbResponse.response.empty());
     response = std::move(dbResponse.response);
+    response.makeContiguous();
 
     return true;
 }
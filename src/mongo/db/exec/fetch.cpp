@@ -30,11 +30,16 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -58,7 +63,8 @@ FetchStage::FetchStage(OperationContext* txn,
       _collection(collection),
       _ws(ws),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _idRetrying(WorkingSet::INVALID_ID),
+      _maxBatchSize(supportsDocLocking() ? internalQueryExecFetchBatchSize.load() : 1) {
     _children.emplace_back(child);
 }
 
@@ -71,6 +77,10 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (!_pending.empty() || !_ready.empty()) {
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -79,6 +89,10 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_maxBatchSize > 1) {
+        return workBatched(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -131,7 +145,15 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         }
 
         return returnIfMatches(member, id, out);
-    } else if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+    }
+
+    return returnChildStatus(status, id, out);
+}
+
+PlanStage::StageState FetchStage::returnChildStatus(StageState status,
+                                                    WorkingSetID id,
+                                                    WorkingSetID* out) {
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
         *out = id;
         // If a stage fails, it may create a status WSM to indicate why it
         // failed, in which case 'id' is valid.  If ID is invalid, we
@@ -150,6 +172,108 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::workBatched(WorkingSetID* out) {
+    if (!_ready.empty()) {
+        WorkingSetID id = _ready.front();
+        _ready.pop_front();
+        return returnIfMatches(_ws->get(id), id, out);
+    }
+
+    // Work the child at most once per call, as an unbatched fetch does, so that the executor can
+    // still yield and check for interrupts between any two works. What the child returns is
+    // buffered across calls until the batch is full.
+    if (_pending.size() < _batchSize && !child()->isEOF()) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState status = child()->work(&id);
+
+        if (PlanStage::ADVANCED == status) {
+            WorkingSetMember* member = _ws->get(id);
+            if (member->hasObj()) {
+                // There's no fetching to perform, but we still return it in order.
+                ++_specificStats.alreadyHasObj;
+            } else {
+                verify(WorkingSetMember::RID_AND_IDX == member->getState());
+                verify(member->hasRecordId());
+            }
+            _pending.push_back(id);
+        } else if (PlanStage::NEED_TIME != status && PlanStage::IS_EOF != status) {
+            // The members in '_pending' stay there until we're called again. If we yield in the
+            // meantime, they're flagged as suspicious and checked against their index keys when
+            // they're fetched.
+            return returnChildStatus(status, id, out);
+        }
+
+        if (_pending.size() < _batchSize && !child()->isEOF()) {
+            return PlanStage::NEED_TIME;
+        }
+    }
+
+    if (_pending.empty()) {
+        return PlanStage::NEED_TIME;
+    }
+
+    try {
+        fetchPending();
+    } catch (const WriteConflictException& wce) {
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    _batchSize = std::min(_batchSize * 2, _maxBatchSize);
+
+    if (_ready.empty()) {
+        return PlanStage::NEED_TIME;
+    }
+
+    WorkingSetID id = _ready.front();
+    _ready.pop_front();
+    return returnIfMatches(_ws->get(id), id, out);
+}
+
+void FetchStage::fetchPending() {
+    if (!_cursor)
+        _cursor = _collection->getCursor(getOpCtx());
+
+    // Pairs of the RecordId to fetch and the position of its member in '_pending'.
+    std::vector<std::pair<RecordId, size_t>> toFetch;
+    for (size_t i = 0; i < _pending.size(); ++i) {
+        WorkingSetMember* member = _ws->get(_pending[i]);
+        if (!member->hasObj()) {
+            toFetch.emplace_back(member->recordId, i);
+        }
+    }
+    std::sort(toFetch.begin(), toFetch.end());
+
+    std::vector<RecordId> ids;
+    ids.reserve(toFetch.size());
+    for (const auto& entry : toFetch) {
+        ids.push_back(entry.first);
+    }
+
+    std::vector<boost::optional<Record>> records;
+    records.reserve(ids.size());
+    _cursor->seekExactBatch(ids, &records);
+    invariant(records.size() == ids.size());
+
+    // Nothing below can throw a WriteConflictException.
+    std::vector<const Record*> recordForPending(_pending.size(), nullptr);
+    for (size_t i = 0; i < toFetch.size(); ++i) {
+        recordForPending[toFetch[i].second] = records[i].get_ptr();
+    }
+
+    for (size_t i = 0; i < _pending.size(); ++i) {
+        WorkingSetID id = _pending[i];
+        WorkingSetMember* member = _ws->get(id);
+        if (!member->hasObj() &&
+            !WorkingSetCommon::fetchFromRecord(getOpCtx(), _ws, id, recordForPending[i])) {
+            _ws->free(id);
+            continue;
+        }
+        _ready.push_back(id);
+    }
+    _pending.clear();
+}
+
 void FetchStage::doSaveState() {
     if (_cursor)
         _cursor->saveUnpositioned();
@@ -180,6 +304,16 @@ void FetchStage::doInvalidate(OperationContext* txn, const RecordId& dl, Invalid
             WorkingSetCommon::fetchAndInvalidateRecordId(txn, member, _collection);
         }
     }
+
+    // The same goes for any buffered member.
+    auto invalidateIfMatches = [&](WorkingSetID id) {
+        WorkingSetMember* member = _ws->get(id);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(txn, member, _collection);
+        }
+    };
+    std::for_each(_pending.begin(), _pending.end(), invalidateIfMatches);
+    std::for_each(_ready.begin(), _ready.end(), invalidateIfMatches);
 }
 
 PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
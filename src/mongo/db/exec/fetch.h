@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
@@ -45,6 +47,11 @@ class SeekableRecordCursor;
  * In WorkingSetMember terms, it transitions from RID_AND_IDX to RID_AND_OBJ by reading
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
+ * On storage engines with document-level locking, the stage may buffer up to
+ * internalQueryExecFetchBatchSize members from its child and read their records in RecordId
+ * order, which turns the random lookups of an index range scan into a mostly sequential walk of
+ * the collection. The members are still returned in the order the child produced them.
+ *
  * Preconditions: Valid RecordId.
  */
 class FetchStage : public PlanStage {
@@ -83,6 +90,25 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Handles a status other than ADVANCED or NEED_TIME from our child.
+     */
+    StageState returnChildStatus(StageState status, WorkingSetID id, WorkingSetID* out);
+
+    /**
+     * doWork() when fetching in batches. Works the child at most once per call, buffering its
+     * members in '_pending' until there are '_batchSize' of them or the child is EOF, then
+     * fetches them all and returns them one per call from '_ready'.
+     */
+    StageState workBatched(WorkingSetID* out);
+
+    /**
+     * Reads the records of the members in '_pending' in RecordId order. Moves the members whose
+     * records were found to '_ready', keeping their order, and frees the others. May throw a
+     * WriteConflictException, in which case '_pending' is unchanged.
+     */
+    void fetchPending();
+
     // Collection which is used by this stage. Used to resolve record ids retrieved by child
     // stages. The lifetime of the collection must supersede that of the stage.
     const Collection* _collection;
@@ -98,6 +124,19 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // The most members to fetch in one batch. 1 if we don't fetch in batches.
+    const size_t _maxBatchSize;
+
+    // The size of the next batch. Starts at 1 and doubles after every batch up to '_maxBatchSize',
+    // so that a query which only needs its first few results doesn't read far ahead.
+    size_t _batchSize = 1;
+
+    // Members from our child that are waiting to be fetched, in the order the child returned them.
+    std::vector<WorkingSetID> _pending;
+
+    // Fetched members waiting to be returned, in the order the child returned them.
+    std::deque<WorkingSetID> _ready;
+
     // Stats
     FetchStats _specificStats;
 };
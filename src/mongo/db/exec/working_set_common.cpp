@@ -101,11 +101,22 @@ bool WorkingSetCommon::fetch(OperationContext* txn,
 
     member->obj.reset();
     auto record = cursor->seekExact(member->recordId);
+    return fetchFromRecord(txn, workingSet, id, record.get_ptr());
+}
+
+// static
+bool WorkingSetCommon::fetchFromRecord(OperationContext* txn,
+                                       WorkingSet* workingSet,
+                                       WorkingSetID id,
+                                       const Record* record) {
+    WorkingSetMember* member = workingSet->get(id);
+    invariant(member->hasRecordId());
+
     if (!record) {
         return false;
     }
 
-    member->obj = {txn->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
+    member->obj = {txn->recoveryUnit()->getSnapshotId(), record->data.toBson()};
 
     if (member->isSuspicious) {
         // Make sure that all of the keyData is still valid for this copy of the document.
@@ -37,6 +37,7 @@ class CanonicalQuery;
 class Collection;
 class OperationContext;
 class SeekableRecordCursor;
+struct Record;
 
 class WorkingSetCommon {
 public:
@@ -75,6 +76,15 @@ public:
                       WorkingSetID id,
                       unowned_ptr<SeekableRecordCursor> cursor);
 
+    /**
+     * Same as fetch(), but with the document already read by the caller, for instance as part of a
+     * batch. 'record' is null if there is no record with the member's RecordId.
+     */
+    static bool fetchFromRecord(OperationContext* txn,
+                                WorkingSet* workingSet,
+                                WorkingSetID id,
+                                const Record* record);
+
     static bool fetchIfUnfetched(OperationContext* txn,
                                  WorkingSet* workingSet,
                                  WorkingSetID id,
@@ -0,0 +1,290 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/hot_data_monitor.h"
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/hot_data_summary.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/db/warm_up.h"
+#include "mongo/util/background.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+// Whether to warm the cache from the summary of the previous run on startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(warmUpOnStartup, bool, true);
+
+namespace {
+
+// How often to record the hot data summary. Zero stops recording.
+std::atomic<int> hotDataSummaryIntervalSecs(300);  // NOLINT
+
+class ExportedHotDataSummaryIntervalSecsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedHotDataSummaryIntervalSecsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "hotDataSummaryIntervalSecs",
+              &hotDataSummaryIntervalSecs) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "hotDataSummaryIntervalSecs must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedHotDataSummaryIntervalSecsParam;
+
+// How many collections and indexes the summary keeps.
+std::atomic<int> hotDataSummaryMaxEntries(100);  // NOLINT
+
+class ExportedHotDataSummaryMaxEntriesParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedHotDataSummaryMaxEntriesParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "hotDataSummaryMaxEntries",
+              &hotDataSummaryMaxEntries) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "hotDataSummaryMaxEntries must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedHotDataSummaryMaxEntriesParam;
+
+// Stops the startup warm up after this much data; it should not exceed the cache size, or the
+// coldest entries of the summary would evict the hottest ones. Zero means no limit.
+int warmUpMaxMB = 1024;
+
+class ExportedWarmUpMaxMBParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedWarmUpMaxMBParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), "warmUpMaxMB", &warmUpMaxMB) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue, "warmUpMaxMB must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedWarmUpMaxMBParam;
+
+// Caps the read rate of the startup warm up. Zero means no limit.
+std::atomic<int> warmUpMaxMBPerSec(64);  // NOLINT
+
+class ExportedWarmUpMaxMBPerSecParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedWarmUpMaxMBPerSecParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(), "warmUpMaxMBPerSec", &warmUpMaxMBPerSec) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "warmUpMaxMBPerSec must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedWarmUpMaxMBPerSecParam;
+
+const long long kBytesPerMB = 1024 * 1024;
+
+class HotDataMonitor : public BackgroundJob {
+public:
+    std::string name() const override {
+        return "HotDataMonitor";
+    }
+
+    void run() override {
+        Client::initThread(name().c_str());
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        auto swObj = HotDataSummary::readFile(storageGlobalParams.dbpath);
+        auto swEntries = swObj.isOK() ? HotDataSummary::parse(swObj.getValue())
+                                      : StatusWith<std::vector<HotDataSummary::Entry>>(
+                                            swObj.getStatus());
+        if (swEntries.isOK()) {
+            _summary.seed(swEntries.getValue());
+            if (warmUpOnStartup) {
+                _warmUp(swEntries.getValue());
+            }
+        } else if (swEntries != ErrorCodes::NonExistentPath) {
+            warning() << "Ignoring the hot data summary of the previous run: "
+                      << swEntries.getStatus();
+        }
+
+        Timer sinceLastPass;
+        while (!inShutdown()) {
+            sleepsecs(1);
+
+            const int interval = hotDataSummaryIntervalSecs;
+            if (interval <= 0 || sinceLastPass.seconds() < interval)
+                continue;
+
+            _recordPass();
+            sinceLastPass.reset();
+        }
+    }
+
+private:
+    /**
+     * Reads the entries of the summary, hottest first, until the warm up budget is spent.
+     */
+    void _warmUp(const std::vector<HotDataSummary::Entry>& entries) {
+        if (entries.empty())
+            return;
+
+        const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+        OperationContext* txn = txnPtr.get();
+
+        // Warming the cache must not hold up clients that are already connected.
+        txn->lockState()->setAdmissionPriority(TicketPriority::kLow);
+
+        log() << "Warming up the cache with " << entries.size()
+              << " collections and indexes from the hot data summary";
+
+        Timer t;
+        WarmUpStats stats;
+        try {
+            for (const HotDataSummary::Entry& entry : entries) {
+                txn->checkForInterrupt();
+
+                WarmUpOptions options;
+                options.maxBytes = static_cast<long long>(warmUpMaxMB) * kBytesPerMB;
+                options.maxBytesPerSec = static_cast<long long>(warmUpMaxMBPerSec) * kBytesPerMB;
+                if (options.maxBytes > 0 && stats.bytes >= options.maxBytes)
+                    break;
+
+                if (entry.indexName.empty()) {
+                    options.data = true;
+                } else {
+                    options.indexes = true;
+                    options.indexNames.push_back(entry.indexName);
+                }
+
+                const NamespaceString nss(entry.ns);
+                try {
+                    Status status = warmUpCollection(txn, nss, options, &stats);
+                    if (!status.isOK()) {
+                        LOG(1) << "Skipping warm up of " << nss << ": " << status;
+                    }
+                } catch (const DBException& ex) {
+                    // Interruptions are rethrown by the checkForInterrupt() call above.
+                    LOG(1) << "Skipping warm up of " << nss << ": " << ex.toStatus();
+                }
+            }
+        } catch (const DBException& ex) {
+            log() << "Cache warm up stopped after " << t.millis() << "ms: " << ex.toStatus();
+            return;
+        }
+
+        log() << "Cache warm up read " << stats.records << " records and " << stats.indexKeys
+              << " index keys (" << stats.bytes << " bytes) in " << t.millis() << "ms";
+    }
+
+    /**
+     * Folds the activity since the previous pass into the summary and saves it.
+     */
+    void _recordPass() {
+        Top::UsageMap usage;
+        Top::get(getGlobalServiceContext()).cloneMap(usage);
+
+        const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+        OperationContext* txn = txnPtr.get();
+        txn->lockState()->setAdmissionPriority(TicketPriority::kLow);
+
+        _summary.startPass();
+        for (auto&& entry : usage) {
+            if (inShutdown())
+                return;
+
+            // The local database holds the oplog, whose hot end is always in cache and whose
+            // cold remainder is not worth reading back in.
+            const NamespaceString nss(entry.first);
+            if (!nss.isNormal() || nss.isLocal())
+                continue;
+
+            _summary.observe(nss.ns(), "", entry.second.total.count);
+
+            try {
+                AutoGetCollection autoColl(txn, nss, MODE_IS);
+                Collection* collection = autoColl.getCollection();
+                if (!collection)
+                    continue;
+
+                for (auto&& index : collection->infoCache()->getIndexUsageStats()) {
+                    _summary.observe(nss.ns(), index.first, index.second.accesses.load());
+                }
+            } catch (const DBException& ex) {
+                LOG(1) << "Not recording index usage of " << nss << ": " << ex.toStatus();
+            }
+        }
+        _summary.finishPass();
+
+        const int maxEntries = hotDataSummaryMaxEntries;
+        Status status = HotDataSummary::writeFile(
+            storageGlobalParams.dbpath, _summary.toBSON(maxEntries > 0 ? maxEntries : 0));
+        if (!status.isOK()) {
+            warning() << "Failed to save the hot data summary: " << status;
+        }
+    }
+
+    HotDataSummary _summary;
+};
+
+}  // namespace
+
+void startHotDataMonitor() {
+    HotDataMonitor* hotDataMonitor = new HotDataMonitor();
+    hotDataMonitor->go();
+}
+
+}  // namespace mongo
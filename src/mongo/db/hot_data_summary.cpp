@@ -0,0 +1,256 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/hot_data_summary.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <tuple>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+const std::string kHotDataBasename = "hotData.bson";
+const int kFormatVersion = 1;
+
+}  // namespace
+
+const double HotDataSummary::kDecayPerPass = 0.5;
+const double HotDataSummary::kMinScore = 1.0;
+
+void HotDataSummary::startPass() {
+    for (auto&& entry : _entries) {
+        entry.second.score *= kDecayPerPass;
+    }
+}
+
+void HotDataSummary::observe(StringData ns, StringData indexName, long long cumulativeCount) {
+    auto key = std::make_pair(ns.toString(), indexName.toString());
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        if (cumulativeCount <= 0)
+            return;
+        it = _entries.emplace(std::move(key), State()).first;
+    }
+
+    State& state = it->second;
+    const long long delta = cumulativeCount >= state.lastCount ? cumulativeCount - state.lastCount
+                                                               : cumulativeCount;
+    state.score += delta;
+    state.lastCount = cumulativeCount;
+}
+
+void HotDataSummary::finishPass() {
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.score < kMinScore) {
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void HotDataSummary::seed(const std::vector<Entry>& entries) {
+    for (const Entry& entry : entries) {
+        State& state = _entries[std::make_pair(entry.ns, entry.indexName)];
+        state.score = std::max(state.score, entry.score);
+    }
+}
+
+std::vector<HotDataSummary::Entry> HotDataSummary::ranked(size_t limit) const {
+    std::vector<Entry> out;
+    out.reserve(_entries.size());
+    for (auto&& entry : _entries) {
+        out.emplace_back(entry.first.first, entry.first.second, entry.second.score);
+    }
+
+    // Ties are broken by name so that the order is deterministic.
+    std::sort(out.begin(), out.end(), [](const Entry& lhs, const Entry& rhs) {
+        if (lhs.score != rhs.score)
+            return lhs.score > rhs.score;
+        return std::tie(lhs.ns, lhs.indexName) < std::tie(rhs.ns, rhs.indexName);
+    });
+
+    if (out.size() > limit)
+        out.resize(limit);
+    return out;
+}
+
+BSONObj HotDataSummary::toBSON(size_t limit) const {
+    BSONObjBuilder builder;
+    builder.append("version", kFormatVersion);
+    BSONArrayBuilder entries(builder.subarrayStart("entries"));
+    for (const Entry& entry : ranked(limit)) {
+        BSONObjBuilder entryBuilder(entries.subobjStart());
+        entryBuilder.append("ns", entry.ns);
+        if (!entry.indexName.empty())
+            entryBuilder.append("index", entry.indexName);
+        entryBuilder.append("score", entry.score);
+    }
+    entries.doneFast();
+    return builder.obj();
+}
+
+StatusWith<std::vector<HotDataSummary::Entry>> HotDataSummary::parse(const BSONObj& obj) {
+    BSONElement versionElem = obj["version"];
+    if (!versionElem.isNumber() || versionElem.numberInt() != kFormatVersion) {
+        return {ErrorCodes::UnsupportedFormat,
+                str::stream() << "Unsupported hot data summary version: " << versionElem};
+    }
+
+    BSONElement entriesElem = obj["entries"];
+    if (entriesElem.type() != Array) {
+        return {ErrorCodes::FailedToParse, "Hot data summary is missing its 'entries' array"};
+    }
+
+    std::vector<Entry> entries;
+    for (auto&& elem : entriesElem.Obj()) {
+        if (elem.type() != Object) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Invalid hot data summary entry: " << elem};
+        }
+
+        BSONObj entryObj = elem.Obj();
+        BSONElement nsElem = entryObj["ns"];
+        BSONElement indexElem = entryObj["index"];
+        BSONElement scoreElem = entryObj["score"];
+        if (nsElem.type() != String || (!indexElem.eoo() && indexElem.type() != String) ||
+            !scoreElem.isNumber()) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Invalid hot data summary entry: " << entryObj};
+        }
+
+        entries.emplace_back(nsElem.String(),
+                             indexElem.eoo() ? std::string() : indexElem.String(),
+                             scoreElem.numberDouble());
+    }
+    return entries;
+}
+
+StatusWith<BSONObj> HotDataSummary::readFile(const std::string& dbpath) {
+    boost::filesystem::path path = boost::filesystem::path(dbpath) / kHotDataBasename;
+    std::string filename = path.string();
+
+    boost::uintmax_t fileSize;
+    try {
+        if (!boost::filesystem::exists(path)) {
+            return {ErrorCodes::NonExistentPath,
+                    str::stream() << "Hot data summary " << filename << " not found."};
+        }
+        fileSize = boost::filesystem::file_size(path);
+    } catch (const std::exception& ex) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Unexpected error inspecting " << filename << ": " << ex.what()};
+    }
+
+    if (fileSize == 0 || fileSize > static_cast<boost::uintmax_t>(BSONObjMaxInternalSize)) {
+        return {ErrorCodes::InvalidPath,
+                str::stream() << "Hot data summary " << filename << " has invalid size "
+                              << fileSize};
+    }
+
+    std::vector<char> buffer(fileSize);
+    try {
+        std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+        if (!ifs) {
+            return {ErrorCodes::FileNotOpen,
+                    str::stream() << "Failed to read hot data summary from " << filename};
+        }
+
+        ifs.read(&buffer[0], buffer.size());
+        if (!ifs) {
+            return {ErrorCodes::FileStreamFailed,
+                    str::stream() << "Unable to read BSON data from " << filename};
+        }
+    } catch (const std::exception& ex) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Unexpected error reading BSON data from " << filename << ": "
+                              << ex.what()};
+    }
+
+    Status status = validateBSON(&buffer[0], buffer.size(), BSONVersion::kLatest);
+    if (!status.isOK()) {
+        return {ErrorCodes::FailedToParse,
+                str::stream() << "Failed to convert data in " << filename << " to BSON: "
+                              << status.reason()};
+    }
+    return BSONObj(&buffer[0]).getOwned();
+}
+
+Status HotDataSummary::writeFile(const std::string& dbpath, const BSONObj& obj) {
+    boost::filesystem::path tempPath =
+        boost::filesystem::path(dbpath) / (kHotDataBasename + ".tmp");
+    {
+        std::string filenameTemp = tempPath.string();
+        std::ofstream ofs(filenameTemp.c_str(), std::ios_base::out | std::ios_base::binary);
+        if (!ofs) {
+            return Status(ErrorCodes::FileNotOpen,
+                          str::stream() << "Failed to write hot data summary to " << filenameTemp
+                                        << ": "
+                                        << errnoWithDescription());
+        }
+
+        ofs.write(obj.objdata(), obj.objsize());
+        if (!ofs) {
+            return Status(ErrorCodes::OperationFailed,
+                          str::stream() << "Failed to write BSON data to " << filenameTemp << ": "
+                                        << errnoWithDescription());
+        }
+    }
+
+    // Rename the temporary file over the previous summary so that readers never see a partial
+    // summary.
+    boost::filesystem::path path = boost::filesystem::path(dbpath) / kHotDataBasename;
+    try {
+        boost::filesystem::rename(tempPath, path);
+    } catch (const std::exception& ex) {
+        return Status(ErrorCodes::FileRenameFailed,
+                      str::stream() << "Unexpected error while renaming temporary hot data summary "
+                                    << tempPath.string()
+                                    << " to "
+                                    << path.string()
+                                    << ": "
+                                    << ex.what());
+    }
+
+    return Status::OK();
+}
+
+}  // namespace mongo
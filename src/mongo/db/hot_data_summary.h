@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * HotDataSummary keeps a decaying score of how busy each collection and index has recently been,
+ * so that a restarted mongod can pull the hottest data back into the storage engine's cache
+ * before clients ask for it.
+ *
+ * Scores are fed from cumulative counters (Top's per-collection operation counts and the
+ * per-index access counts of CollectionIndexUsageTracker). Each recording pass first decays every
+ * score by kDecayPerPass and then adds the growth of each counter since the previous pass.
+ * Entries whose score decays below kMinScore are forgotten.
+ *
+ * Not thread safe.
+ */
+class HotDataSummary {
+public:
+    struct Entry {
+        Entry() = default;
+        Entry(std::string ns, std::string indexName, double score)
+            : ns(std::move(ns)), indexName(std::move(indexName)), score(score) {}
+
+        std::string ns;
+
+        // Empty when the entry describes the collection's records rather than one of its indexes.
+        std::string indexName;
+
+        double score = 0;
+    };
+
+    static const double kDecayPerPass;
+    static const double kMinScore;
+
+    /**
+     * Starts a recording pass by decaying every score.
+     */
+    void startPass();
+
+    /**
+     * Credits 'ns' (or its index 'indexName' when non-empty) with the growth of 'cumulativeCount'
+     * since it was last observed. A counter that went backwards was reset, for example because
+     * the collection was dropped and recreated, and is credited with its full value.
+     */
+    void observe(StringData ns, StringData indexName, long long cumulativeCount);
+
+    /**
+     * Ends a recording pass by forgetting the entries that have cooled down below kMinScore.
+     */
+    void finishPass();
+
+    /**
+     * Seeds the scores with entries recorded by a previous process. Their counters are treated as
+     * starting from zero, matching the counters of a freshly started process.
+     */
+    void seed(const std::vector<Entry>& entries);
+
+    /**
+     * Returns at most 'limit' entries, hottest first.
+     */
+    std::vector<Entry> ranked(size_t limit) const;
+
+    /**
+     * Serializes the 'limit' hottest entries as
+     * { version: 1, entries: [ { ns: <string>, [index: <string>,] score: <double> }, ... ] }.
+     */
+    BSONObj toBSON(size_t limit) const;
+
+    /**
+     * Parses the output of toBSON().
+     */
+    static StatusWith<std::vector<Entry>> parse(const BSONObj& obj);
+
+    /**
+     * Reads the summary saved in 'dbpath'. Returns NonExistentPath if no summary has been saved.
+     */
+    static StatusWith<BSONObj> readFile(const std::string& dbpath);
+
+    /**
+     * Atomically replaces the summary saved in 'dbpath' with 'obj'.
+     */
+    static Status writeFile(const std::string& dbpath, const BSONObj& obj);
+
+private:
+    struct State {
+        double score = 0;
+        long long lastCount = 0;
+    };
+
+    // Keyed by (ns, indexName).
+    std::map<std::pair<std::string, std::string>, State> _entries;
+};
+
+}  // namespace mongo
@@ -0,0 +1,185 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/hot_data_summary.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using unittest::TempDir;
+
+TEST(HotDataSummaryTest, RanksByGrowthSinceLastPass) {
+    HotDataSummary summary;
+    summary.startPass();
+    summary.observe("test.a", "", 100);
+    summary.observe("test.b", "", 10);
+    summary.observe("test.b", "x_1", 50);
+    summary.finishPass();
+
+    auto ranked = summary.ranked(10);
+    ASSERT_EQUALS(3U, ranked.size());
+    ASSERT_EQUALS("test.a", ranked[0].ns);
+    ASSERT_EQUALS("", ranked[0].indexName);
+    ASSERT_EQUALS("test.b", ranked[1].ns);
+    ASSERT_EQUALS("x_1", ranked[1].indexName);
+    ASSERT_EQUALS(50.0, ranked[1].score);
+
+    // Only the growth of the counters counts during the next pass; test.a saw no new activity.
+    summary.startPass();
+    summary.observe("test.a", "", 100);
+    summary.observe("test.b", "", 200);
+    summary.observe("test.b", "x_1", 50);
+    summary.finishPass();
+
+    ranked = summary.ranked(10);
+    ASSERT_EQUALS(3U, ranked.size());
+    ASSERT_EQUALS("test.b", ranked[0].ns);
+    ASSERT_EQUALS("", ranked[0].indexName);
+    ASSERT_EQUALS(195.0, ranked[0].score);
+    ASSERT_EQUALS("test.a", ranked[1].ns);
+    ASSERT_EQUALS(50.0, ranked[1].score);
+}
+
+TEST(HotDataSummaryTest, CounterResetCreditsFullCount) {
+    HotDataSummary summary;
+    summary.startPass();
+    summary.observe("test.a", "", 100);
+    summary.finishPass();
+
+    summary.startPass();
+    summary.observe("test.a", "", 8);
+    summary.finishPass();
+
+    auto ranked = summary.ranked(10);
+    ASSERT_EQUALS(1U, ranked.size());
+    ASSERT_EQUALS(58.0, ranked[0].score);
+}
+
+TEST(HotDataSummaryTest, IdleEntriesAreForgotten) {
+    HotDataSummary summary;
+    summary.startPass();
+    summary.observe("test.a", "", 4);
+    summary.observe("test.b", "", 0);
+    summary.finishPass();
+    ASSERT_EQUALS(1U, summary.ranked(10).size());
+
+    for (int i = 0; i < 3; ++i) {
+        summary.startPass();
+        summary.observe("test.a", "", 4);
+        summary.finishPass();
+    }
+    ASSERT_EQUALS(0U, summary.ranked(10).size());
+}
+
+TEST(HotDataSummaryTest, RankedHonorsLimit) {
+    HotDataSummary summary;
+    summary.startPass();
+    for (int i = 1; i <= 5; ++i) {
+        summary.observe("test.c" + std::to_string(i), "", i);
+    }
+    summary.finishPass();
+
+    auto ranked = summary.ranked(2);
+    ASSERT_EQUALS(2U, ranked.size());
+    ASSERT_EQUALS("test.c5", ranked[0].ns);
+    ASSERT_EQUALS("test.c4", ranked[1].ns);
+}
+
+TEST(HotDataSummaryTest, SeededEntriesStartFromZeroCounters) {
+    HotDataSummary summary;
+    summary.seed({{"test.a", "", 40}, {"test.a", "_id_", 30}});
+
+    summary.startPass();
+    summary.observe("test.a", "_id_", 5);
+    summary.finishPass();
+
+    auto ranked = summary.ranked(10);
+    ASSERT_EQUALS(2U, ranked.size());
+    ASSERT_EQUALS("", ranked[0].indexName);
+    ASSERT_EQUALS(20.0, ranked[0].score);
+    ASSERT_EQUALS("_id_", ranked[1].indexName);
+    ASSERT_EQUALS(20.0, ranked[1].score);
+}
+
+TEST(HotDataSummaryTest, BSONRoundTrip) {
+    HotDataSummary summary;
+    summary.startPass();
+    summary.observe("test.a", "", 10);
+    summary.observe("test.a", "x_1", 20);
+    summary.finishPass();
+
+    auto swEntries = HotDataSummary::parse(summary.toBSON(10));
+    ASSERT_OK(swEntries.getStatus());
+    const auto& entries = swEntries.getValue();
+    ASSERT_EQUALS(2U, entries.size());
+    ASSERT_EQUALS("test.a", entries[0].ns);
+    ASSERT_EQUALS("x_1", entries[0].indexName);
+    ASSERT_EQUALS(20.0, entries[0].score);
+    ASSERT_EQUALS("", entries[1].indexName);
+    ASSERT_EQUALS(10.0, entries[1].score);
+}
+
+TEST(HotDataSummaryTest, ParseRejectsUnknownVersion) {
+    auto status = HotDataSummary::parse(BSON("version" << 2 << "entries" << BSONArray()));
+    ASSERT_EQUALS(ErrorCodes::UnsupportedFormat, status.getStatus());
+}
+
+TEST(HotDataSummaryTest, ParseRejectsMalformedEntry) {
+    auto status = HotDataSummary::parse(
+        BSON("version" << 1 << "entries" << BSON_ARRAY(BSON("ns" << 1 << "score" << 1.0))));
+    ASSERT_EQUALS(ErrorCodes::FailedToParse, status.getStatus());
+}
+
+TEST(HotDataSummaryTest, ReadMissingFile) {
+    TempDir tempDir("HotDataSummaryTest_ReadMissingFile");
+    ASSERT_EQUALS(ErrorCodes::NonExistentPath,
+                  HotDataSummary::readFile(tempDir.path()).getStatus());
+}
+
+TEST(HotDataSummaryTest, WriteThenRead) {
+    TempDir tempDir("HotDataSummaryTest_WriteThenRead");
+    HotDataSummary summary;
+    summary.startPass();
+    summary.observe("test.a", "", 10);
+    summary.finishPass();
+
+    BSONObj obj = summary.toBSON(10);
+    ASSERT_OK(HotDataSummary::writeFile(tempDir.path(), obj));
+
+    auto swObj = HotDataSummary::readFile(tempDir.path());
+    ASSERT_OK(swObj.getStatus());
+    ASSERT_BSONOBJ_EQ(obj, swObj.getValue());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -67,4 +67,10 @@ void BtreeAccessMethod::getKeys(const BSONObj& obj,
     _keyGenerator->getKeys(obj, keys, multikeyPaths);
 }
 
+void BtreeAccessMethod::getKeyStrings(const BSONObj& obj,
+                                      KeyStringSet* keys,
+                                      MultikeyPaths* multikeyPaths) const {
+    _keyGenerator->getKeyStrings(obj, keys, multikeyPaths);
+}
+
 }  // namespace mongo
@@ -31,6 +31,7 @@
 #include <boost/optional.hpp>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/query/collation/collation_index_key.h"
@@ -93,6 +94,28 @@ void BtreeKeyGenerator::getKeys(const BSONObj& obj,
     }
 }
 
+void BtreeKeyGenerator::getKeyStrings(const BSONObj& obj,
+                                      KeyStringSet* keys,
+                                      MultikeyPaths* multikeyPaths) const {
+    invariant(keys->empty());
+    getKeyStringsImpl(_fieldNames, _fixed, obj, keys, multikeyPaths);
+    if (keys->empty() && !_isSparse) {
+        keys->add(_nullKey);
+    }
+}
+
+void BtreeKeyGenerator::getKeyStringsImpl(std::vector<const char*> fieldNames,
+                                          std::vector<BSONElement> fixed,
+                                          const BSONObj& obj,
+                                          KeyStringSet* keys,
+                                          MultikeyPaths* multikeyPaths) const {
+    BSONObjSet bsonKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    getKeysImpl(std::move(fieldNames), std::move(fixed), obj, &bsonKeys, multikeyPaths);
+    for (const auto& key : bsonKeys) {
+        keys->add(key);
+    }
+}
+
 static void assertParallelArrays(const char* first, const char* second) {
     std::stringstream ss;
     ss << "cannot index parallel arrays [" << first << "] [" << second << "]";
@@ -283,7 +306,7 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                                               std::vector<BSONElement>* fixed,
                                               const BSONElement& arrEntry,
-                                              BSONObjSet* keys,
+                                              const KeyOutput& out,
                                               unsigned numNotFound,
                                               const BSONElement& arrObjElt,
                                               const std::set<size_t>& arrIdxs,
@@ -301,7 +324,7 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNam
     getKeysImplWithArray(*fieldNames,
                          *fixed,
                          arrEntry.type() == Object ? arrEntry.embeddedObject() : BSONObj(),
-                         keys,
+                         out,
                          numNotFound,
                          positionalInfo,
                          multikeyPaths);
@@ -312,16 +335,48 @@ void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
                                       const BSONObj& obj,
                                       BSONObjSet* keys,
                                       MultikeyPaths* multikeyPaths) const {
+    _getKeys(std::move(fieldNames), std::move(fixed), obj, KeyOutput{keys, nullptr}, multikeyPaths);
+}
+
+void BtreeKeyGeneratorV1::getKeyStringsImpl(std::vector<const char*> fieldNames,
+                                            std::vector<BSONElement> fixed,
+                                            const BSONObj& obj,
+                                            KeyStringSet* keys,
+                                            MultikeyPaths* multikeyPaths) const {
+    _getKeys(std::move(fieldNames), std::move(fixed), obj, KeyOutput{nullptr, keys}, multikeyPaths);
+}
+
+void BtreeKeyGeneratorV1::_addKey(const BSONElement* elements,
+                                  size_t numElements,
+                                  const KeyOutput& out) const {
+    if (out.keyStrings && !_collator) {
+        out.keyStrings->add(elements, numElements);
+        return;
+    }
+
+    BSONObjBuilder b(_sizeTracker);
+    for (size_t i = 0; i < numElements; ++i) {
+        CollationIndexKey::collationAwareIndexKeyAppend(elements[i], _collator, &b);
+    }
+    if (out.keyStrings) {
+        out.keyStrings->add(b.obj());
+    } else {
+        out.bsonKeys->insert(b.obj());
+    }
+}
+
+void BtreeKeyGeneratorV1::_getKeys(std::vector<const char*> fieldNames,
+                                   std::vector<BSONElement> fixed,
+                                   const BSONObj& obj,
+                                   const KeyOutput& out,
+                                   MultikeyPaths* multikeyPaths) const {
     if (_isIdIndex) {
         // we special case for speed
         BSONElement e = obj["_id"];
         if (e.eoo()) {
-            keys->insert(_nullKey);
-        } else {
-            BSONObjBuilder b;
-            CollationIndexKey::collationAwareIndexKeyAppend(e, _collator, &b);
-            keys->insert(b.obj());
+            e = nullElt;
         }
+        _addKey(&e, 1, out);
 
         // The {_id: 1} index can never be multikey because the _id field isn't allowed to be an
         // array value. We therefore always set 'multikeyPaths' as [ [ ] ].
@@ -335,14 +390,14 @@ void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
         invariant(multikeyPaths->empty());
         multikeyPaths->resize(fieldNames.size());
     }
-    getKeysImplWithArray(fieldNames, fixed, obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+    getKeysImplWithArray(fieldNames, fixed, obj, out, 0, _emptyPositionalInfo, multikeyPaths);
 }
 
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
     std::vector<const char*> fieldNames,
     std::vector<BSONElement> fixed,
     const BSONObj& obj,
-    BSONObjSet* keys,
+    const KeyOutput& out,
     unsigned numNotFound,
     const std::vector<PositionalPathInfo>& positionalInfo,
     MultikeyPaths* multikeyPaths) const {
@@ -414,17 +469,13 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         if (_isSparse && numNotFound == fieldNames.size()) {
             return;
         }
-        BSONObjBuilder b(_sizeTracker);
-        for (std::vector<BSONElement>::iterator i = fixed.begin(); i != fixed.end(); ++i) {
-            CollationIndexKey::collationAwareIndexKeyAppend(*i, _collator, &b);
-        }
-        keys->insert(b.obj());
+        _addKey(fixed.data(), fixed.size(), out);
     } else if (arrElt.embeddedObject().firstElement().eoo()) {
         // Empty array, so set matching fields to undefined.
         _getKeysArrEltFixed(&fieldNames,
                             &fixed,
                             undefinedElt,
-                            keys,
+                            out,
                             numNotFound,
                             arrElt,
                             arrIdxs,
@@ -507,7 +558,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
             _getKeysArrEltFixed(&fieldNames,
                                 &fixed,
                                 arrObjElem,
-                                keys,
+                                out,
                                 numNotFound,
                                 arrElt,
                                 arrIdxs,
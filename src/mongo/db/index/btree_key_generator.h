@@ -36,6 +36,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string_set.h"
 
 namespace mongo {
 
@@ -61,6 +62,11 @@ public:
 
     void getKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const;
 
+    /**
+     * Same as getKeys(), but adds the keys to 'keys' as KeyStrings. 'keys' must be empty.
+     */
+    void getKeyStrings(const BSONObj& obj, KeyStringSet* keys, MultikeyPaths* multikeyPaths) const;
+
 protected:
     // These are used by the getKeysImpl(s) below.
     std::vector<const char*> _fieldNames;
@@ -76,6 +82,16 @@ private:
                              BSONObjSet* keys,
                              MultikeyPaths* multikeyPaths) const = 0;
 
+    /**
+     * Generates the keys as getKeysImpl() does and adds them to 'keys'. The default goes through a
+     * BSONObjSet; generators that can produce KeyStrings directly override it.
+     */
+    virtual void getKeyStringsImpl(std::vector<const char*> fieldNames,
+                                   std::vector<BSONElement> fixed,
+                                   const BSONObj& obj,
+                                   KeyStringSet* keys,
+                                   MultikeyPaths* multikeyPaths) const;
+
     std::vector<BSONElement> _fixed;
 };
 
@@ -112,6 +128,14 @@ public:
     virtual ~BtreeKeyGeneratorV1() {}
 
 private:
+    /**
+     * Where generated keys go: exactly one of the members is non-null.
+     */
+    struct KeyOutput {
+        BSONObjSet* bsonKeys;
+        KeyStringSet* keyStrings;
+    };
+
     /**
      * Stores info regarding traversal of a positional path. A path through a document is
      * considered positional if this path element names an array element. Generally this means
@@ -186,13 +210,37 @@ private:
                      BSONObjSet* keys,
                      MultikeyPaths* multikeyPaths) const final;
 
+    /**
+     * Generates the same keys as getKeysImpl(), encoding each one straight into 'keys' rather
+     * than building a BSONObj for it, unless strings must first be mapped through the collator.
+     */
+    void getKeyStringsImpl(std::vector<const char*> fieldNames,
+                           std::vector<BSONElement> fixed,
+                           const BSONObj& obj,
+                           KeyStringSet* keys,
+                           MultikeyPaths* multikeyPaths) const final;
+
+    /**
+     * The body of getKeysImpl() and getKeyStringsImpl().
+     */
+    void _getKeys(std::vector<const char*> fieldNames,
+                  std::vector<BSONElement> fixed,
+                  const BSONObj& obj,
+                  const KeyOutput& out,
+                  MultikeyPaths* multikeyPaths) const;
+
+    /**
+     * Adds the key whose values are 'elements' to 'out'.
+     */
+    void _addKey(const BSONElement* elements, size_t numElements, const KeyOutput& out) const;
+
     /**
      * This recursive method does the heavy-lifting for getKeysImpl().
      */
     void getKeysImplWithArray(std::vector<const char*> fieldNames,
                               std::vector<BSONElement> fixed,
                               const BSONObj& obj,
-                              BSONObjSet* keys,
+                              const KeyOutput& out,
                               unsigned numNotFound,
                               const std::vector<PositionalPathInfo>& positionalInfo,
                               MultikeyPaths* multikeyPaths) const;
@@ -241,7 +289,7 @@ private:
     void _getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                              std::vector<BSONElement>* fixed,
                              const BSONElement& arrEntry,
-                             BSONObjSet* keys,
+                             const KeyOutput& out,
                              unsigned numNotFound,
                              const BSONElement& arrObjElt,
                              const std::set<size_t>& arrIdxs,
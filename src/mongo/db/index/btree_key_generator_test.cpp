@@ -143,6 +143,38 @@ bool testKeygen(const BSONObj& kp,
     if (!match) {
         log() << "Expected: " << dumpMultikeyPaths(expectedMultikeyPaths) << ", "
               << "Actual: " << dumpMultikeyPaths(actualMultikeyPaths);
+        return false;
+    }
+
+    //
+    // Step 4: check that generating the keys as KeyStrings gives the expected keys, encoded.
+    //
+    const Ordering ordering = Ordering::make(kp);
+    KeyStringSet expectedKeyStrings(KeyString::Version::V1, ordering);
+    for (const auto& key : expectedKeys) {
+        expectedKeyStrings.add(key);
+    }
+
+    KeyStringSet actualKeyStrings(KeyString::Version::V1, ordering);
+    MultikeyPaths actualKeyStringMultikeyPaths;
+    keyGen->getKeyStrings(obj, &actualKeyStrings, &actualKeyStringMultikeyPaths);
+
+    const auto difference = KeyStringSet::difference(expectedKeyStrings, actualKeyStrings);
+    match = difference.first.empty() && difference.second.empty();
+    if (!match) {
+        BSONObjSet actualDecodedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        for (size_t i = 0; i < actualKeyStrings.size(); ++i) {
+            actualDecodedKeys.insert(actualKeyStrings[i].toBson());
+        }
+        log() << "Expected: " << dumpKeyset(expectedKeys) << ", "
+              << "Actual KeyStrings: " << dumpKeyset(actualDecodedKeys);
+        return false;
+    }
+
+    match = (expectedMultikeyPaths == actualKeyStringMultikeyPaths);
+    if (!match) {
+        log() << "Expected: " << dumpMultikeyPaths(expectedMultikeyPaths) << ", "
+              << "Actual from KeyStrings: " << dumpMultikeyPaths(actualKeyStringMultikeyPaths);
     }
 
     return match;
@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <boost/filesystem/operations.hpp>
 #include <utility>
 #include <vector>
 
@@ -44,9 +45,11 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
 
@@ -71,6 +74,58 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
                        [](const std::set<std::size_t>& components) { return !components.empty(); });
 }
 
+SortOptions makeBulkSortOptions(size_t maxMemoryUsageBytes, const std::string& tempDir) {
+    return SortOptions()
+        .TempDir(tempDir.empty() ? storageGlobalParams.dbpath + "/_tmp" : tempDir)
+        .ExtSortAllowed()
+        .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+        .MergeThreads(internalQueryExecExternalSortMergeThreads.load())
+        .SpillCompressor(internalQueryExecExternalSortUseZlib.load()
+                             ? SortOptions::Compressor::kZlib
+                             : SortOptions::Compressor::kSnappy);
+}
+
+/**
+ * Adds the path components which cause 'from' to be multikey to 'into'.
+ */
+void mergeMultikeyPaths(MultikeyPaths* into, const MultikeyPaths& from) {
+    if (from.empty()) {
+        return;
+    }
+    if (into->empty()) {
+        *into = from;
+        return;
+    }
+    invariant(into->size() == from.size());
+    for (size_t i = 0; i < from.size(); ++i) {
+        (*into)[i].insert(from[i].begin(), from[i].end());
+    }
+}
+
+Status insertOneKey(SortedDataInterface* index,
+                    OperationContext* txn,
+                    const BSONObj& key,
+                    const RecordId& loc,
+                    bool dupsAllowed) {
+    return index->insert(txn, key, loc, dupsAllowed);
+}
+
+Status insertOneKey(SortedDataInterface* index,
+                    OperationContext* txn,
+                    const KeyStringSet::Key& key,
+                    const RecordId& loc,
+                    bool dupsAllowed) {
+    return index->insertKeyString(txn, key, loc, dupsAllowed);
+}
+
+BSONObj keyToBson(const BSONObj& key) {
+    return key;
+}
+
+BSONObj keyToBson(const KeyStringSet::Key& key) {
+    return key.toBson();
+}
+
 }  // namespace
 
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
@@ -108,7 +163,10 @@ private:
 };
 
 IndexAccessMethod::IndexAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree)
-    : _btreeState(btreeState), _descriptor(btreeState->descriptor()), _newInterface(btree) {
+    : _btreeState(btreeState),
+      _descriptor(btreeState->descriptor()),
+      _newInterface(btree),
+      _ordering(Ordering::make(_descriptor->keyPattern())) {
     verify(IndexDescriptor::isIndexVersionSupported(_descriptor->version()));
 }
 
@@ -127,14 +185,40 @@ Status IndexAccessMethod::insert(OperationContext* txn,
                                  int64_t* numInserted) {
     invariant(numInserted);
     *numInserted = 0;
+    if (auto version = _newInterface->getKeyStringVersion()) {
+        return insertKeyStrings(txn, obj, loc, options, *version, numInserted);
+    }
+
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
     // Delegate to the subclass.
     getKeys(obj, &keys, &multikeyPaths);
 
-    Status ret = Status::OK();
-    for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
-        Status status = _newInterface->insert(txn, *i, loc, options.dupsAllowed);
+    return insertKeys(txn, keys, multikeyPaths, loc, options, numInserted);
+}
+
+Status IndexAccessMethod::insertKeyStrings(OperationContext* txn,
+                                           const BSONObj& obj,
+                                           const RecordId& loc,
+                                           const InsertDeleteOptions& options,
+                                           KeyString::Version version,
+                                           int64_t* numInserted) {
+    KeyStringSet keys(version, _ordering);
+    MultikeyPaths multikeyPaths;
+    getKeyStrings(obj, &keys, &multikeyPaths);
+
+    return insertKeys(txn, keys, multikeyPaths, loc, options, numInserted);
+}
+
+template <typename Keys>
+Status IndexAccessMethod::insertKeys(OperationContext* txn,
+                                     const Keys& keys,
+                                     const MultikeyPaths& multikeyPaths,
+                                     const RecordId& loc,
+                                     const InsertDeleteOptions& options,
+                                     int64_t* numInserted) {
+    for (auto i = keys.begin(); i != keys.end(); ++i) {
+        Status status = insertOneKey(_newInterface.get(), txn, *i, loc, options.dupsAllowed);
 
         // Everything's OK, carry on.
         if (status.isOK()) {
@@ -152,16 +236,17 @@ Status IndexAccessMethod::insert(OperationContext* txn,
             // A document might be indexed multiple times during a background index build
             // if it moves ahead of the collection scan cursor (e.g. via an update).
             if (!_btreeState->isReady(txn)) {
-                LOG(3) << "key " << *i << " already in index during background indexing (ok)";
+                LOG(3) << "key " << keyToBson(*i)
+                       << " already in index during background indexing (ok)";
                 continue;
             }
         }
 
         // Clean up after ourselves.
-        for (BSONObjSet::const_iterator j = keys.begin(); j != i; ++j) {
+        for (auto j = keys.begin(); j != i; ++j) {
             removeOneKey(txn, *j, loc, options.dupsAllowed);
-            *numInserted = 0;
         }
+        *numInserted = 0;
 
         return status;
     }
@@ -170,7 +255,7 @@ Status IndexAccessMethod::insert(OperationContext* txn,
         _btreeState->setMultikey(txn, multikeyPaths);
     }
 
-    return ret;
+    return Status::OK();
 }
 
 void IndexAccessMethod::removeOneKey(OperationContext* txn,
@@ -187,6 +272,20 @@ void IndexAccessMethod::removeOneKey(OperationContext* txn,
     }
 }
 
+void IndexAccessMethod::removeOneKey(OperationContext* txn,
+                                     const KeyStringSet::Key& key,
+                                     const RecordId& loc,
+                                     bool dupsAllowed) {
+    try {
+        _newInterface->unindexKeyString(txn, key, loc, dupsAllowed);
+    } catch (AssertionException& e) {
+        log() << "Assertion failure: _unindex failed " << _descriptor->indexNamespace();
+        log() << "Assertion failure: _unindex failed: " << redact(e)
+              << "  key:" << key.toBson().toString() << "  dl:" << loc;
+        logContext();
+    }
+}
+
 std::unique_ptr<SortedDataInterface::Cursor> IndexAccessMethod::newCursor(OperationContext* txn,
                                                                           bool isForward) const {
     return _newInterface->newCursor(txn, isForward);
@@ -205,6 +304,10 @@ Status IndexAccessMethod::remove(OperationContext* txn,
                                  int64_t* numDeleted) {
     invariant(numDeleted);
     *numDeleted = 0;
+    if (auto version = _newInterface->getKeyStringVersion()) {
+        return removeKeyStrings(txn, obj, loc, options, *version, numDeleted);
+    }
+
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     // There's no need to compute the prefixes of the indexed fields that cause the index to be
     // multikey when removing a document since the index metadata isn't updated when keys are
@@ -220,6 +323,25 @@ Status IndexAccessMethod::remove(OperationContext* txn,
     return Status::OK();
 }
 
+Status IndexAccessMethod::removeKeyStrings(OperationContext* txn,
+                                           const BSONObj& obj,
+                                           const RecordId& loc,
+                                           const InsertDeleteOptions& options,
+                                           KeyString::Version version,
+                                           int64_t* numDeleted) {
+    KeyStringSet keys(version, _ordering);
+    // As in remove(), the multikey metadata isn't updated when keys are deleted.
+    MultikeyPaths* multikeyPaths = nullptr;
+    getKeyStrings(obj, &keys, multikeyPaths);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        removeOneKey(txn, keys[i], loc, options.dupsAllowed);
+        ++*numDeleted;
+    }
+
+    return Status::OK();
+}
+
 Status IndexAccessMethod::initializeAsEmpty(OperationContext* txn) {
     return _newInterface->initAsEmpty(txn);
 }
@@ -285,6 +407,16 @@ long long IndexAccessMethod::getSpaceUsedBytes(OperationContext* txn) const {
     return _newInterface->getSpaceUsedBytes(txn);
 }
 
+void IndexAccessMethod::getKeyStrings(const BSONObj& obj,
+                                      KeyStringSet* keys,
+                                      MultikeyPaths* multikeyPaths) const {
+    BSONObjSet bsonKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    getKeys(obj, &bsonKeys, multikeyPaths);
+    for (const auto& key : bsonKeys) {
+        keys->add(key);
+    }
+}
+
 pair<vector<BSONObj>, vector<BSONObj>> IndexAccessMethod::setDifference(const BSONObjSet& left,
                                                                         const BSONObjSet& right) {
     // Two iterators to traverse the two sets in sorted order.
@@ -328,23 +460,40 @@ Status IndexAccessMethod::validateUpdate(OperationContext* txn,
                                          const InsertDeleteOptions& options,
                                          UpdateTicket* ticket,
                                          const MatchExpression* indexFilter) {
-    if (!indexFilter || indexFilter->matchesBSON(from)) {
-        // There's no need to compute the prefixes of the indexed fields that possibly caused the
-        // index to be multikey when the old version of the document was written since the index
-        // metadata isn't updated when keys are deleted.
-        MultikeyPaths* multikeyPaths = nullptr;
-        getKeys(from, &ticket->oldKeys, multikeyPaths);
-    }
+    // There's no need to compute the prefixes of the indexed fields that possibly caused the
+    // index to be multikey when the old version of the document was written since the index
+    // metadata isn't updated when keys are deleted.
+    MultikeyPaths* oldMultikeyPaths = nullptr;
+
+    if (auto version = _newInterface->getKeyStringVersion()) {
+        ticket->oldKeyStrings = stdx::make_unique<KeyStringSet>(*version, _ordering);
+        ticket->newKeyStrings = stdx::make_unique<KeyStringSet>(*version, _ordering);
+
+        if (!indexFilter || indexFilter->matchesBSON(from)) {
+            getKeyStrings(from, ticket->oldKeyStrings.get(), oldMultikeyPaths);
+        }
+
+        if (!indexFilter || indexFilter->matchesBSON(to)) {
+            getKeyStrings(to, ticket->newKeyStrings.get(), &ticket->newMultikeyPaths);
+        }
+
+        std::tie(ticket->removedKeyStrings, ticket->addedKeyStrings) =
+            KeyStringSet::difference(*ticket->oldKeyStrings, *ticket->newKeyStrings);
+    } else {
+        if (!indexFilter || indexFilter->matchesBSON(from)) {
+            getKeys(from, &ticket->oldKeys, oldMultikeyPaths);
+        }
+
+        if (!indexFilter || indexFilter->matchesBSON(to)) {
+            getKeys(to, &ticket->newKeys, &ticket->newMultikeyPaths);
+        }
 
-    if (!indexFilter || indexFilter->matchesBSON(to)) {
-        getKeys(to, &ticket->newKeys, &ticket->newMultikeyPaths);
+        std::tie(ticket->removed, ticket->added) = setDifference(ticket->oldKeys, ticket->newKeys);
     }
 
     ticket->loc = record;
     ticket->dupsAllowed = options.dupsAllowed;
 
-    std::tie(ticket->removed, ticket->added) = setDifference(ticket->oldKeys, ticket->newKeys);
-
     ticket->_isValid = true;
 
     return Status::OK();
@@ -364,6 +513,10 @@ Status IndexAccessMethod::update(OperationContext* txn,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
+    if (ticket.newKeyStrings) {
+        return updateKeyStrings(txn, ticket, numInserted, numDeleted);
+    }
+
     if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1 ||
         isMultikeyFromPaths(ticket.newMultikeyPaths)) {
         _btreeState->setMultikey(txn, ticket.newMultikeyPaths);
@@ -391,23 +544,85 @@ Status IndexAccessMethod::update(OperationContext* txn,
     return Status::OK();
 }
 
+Status IndexAccessMethod::updateKeyStrings(OperationContext* txn,
+                                           const UpdateTicket& ticket,
+                                           int64_t* numInserted,
+                                           int64_t* numDeleted) {
+    if (ticket.newKeyStrings->size() > 1 || isMultikeyFromPaths(ticket.newMultikeyPaths)) {
+        _btreeState->setMultikey(txn, ticket.newMultikeyPaths);
+    }
+
+    for (const auto& key : ticket.removedKeyStrings) {
+        _newInterface->unindexKeyString(txn, key, ticket.loc, ticket.dupsAllowed);
+    }
+
+    for (const auto& key : ticket.addedKeyStrings) {
+        Status status = _newInterface->insertKeyString(txn, key, ticket.loc, ticket.dupsAllowed);
+        if (!status.isOK()) {
+            if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(txn)) {
+                // Ignore.
+                continue;
+            }
+
+            return status;
+        }
+    }
+
+    *numInserted = ticket.addedKeyStrings.size();
+    *numDeleted = ticket.removedKeyStrings.size();
+
+    return Status::OK();
+}
+
 Status IndexAccessMethod::compact(OperationContext* txn) {
     return this->_newInterface->compact(txn);
 }
 
-std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk() {
-    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor));
+std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
+    size_t maxMemoryUsageBytes, const std::string& tempDir) {
+    std::unique_ptr<BulkBuilder::Sorter> sorter(BulkBuilder::Sorter::make(
+        makeBulkSortOptions(maxMemoryUsageBytes, tempDir),
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, std::move(sorter)));
+}
+
+StatusWith<std::unique_ptr<IndexAccessMethod::BulkBuilder>> IndexAccessMethod::resumeBulk(
+    const BSONObj& persistedState, const std::string& tempDir, size_t maxMemoryUsageBytes) {
+    std::vector<std::string> fileNames;
+    for (const auto& run : persistedState["runs"].Array()) {
+        const std::string fileName = run["file"].String();
+        boost::system::error_code ec;
+        const auto size = boost::filesystem::file_size(fileName, ec);
+        if (ec || static_cast<long long>(size) != run["size"].numberLong()) {
+            return {ErrorCodes::NoSuchKey,
+                    str::stream() << "cannot resume index build of " << _descriptor->indexName()
+                                  << ", sorted keys in " << fileName << " are missing or of the "
+                                  << "wrong size"};
+        }
+        fileNames.push_back(fileName);
+    }
+
+    std::unique_ptr<BulkBuilder::Sorter> sorter(BulkBuilder::Sorter::makeFromExistingRuns(
+        fileNames,
+        makeBulkSortOptions(maxMemoryUsageBytes, tempDir),
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    std::unique_ptr<BulkBuilder> bulk(new BulkBuilder(this, std::move(sorter)));
+
+    bulk->_keysInserted = persistedState["keysInserted"].numberLong();
+    bulk->_everGeneratedMultipleKeys = persistedState["multikey"].trueValue();
+    for (const auto& path : persistedState["multikeyPaths"].Array()) {
+        std::set<size_t> components;
+        for (const auto& component : path.Array()) {
+            components.insert(component.numberInt());
+        }
+        bulk->_indexMultikeyPaths.push_back(std::move(components));
+    }
+    return std::move(bulk);
 }
 
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
-                                            const IndexDescriptor* descriptor)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(100 * 1024 * 1024),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+                                            std::unique_ptr<Sorter> sorter)
+    : _sorter(std::move(sorter)), _real(index) {}
 
 Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
                                               const BSONObj& obj,
@@ -419,17 +634,7 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
     _real->getKeys(obj, &keys, &multikeyPaths);
 
     _everGeneratedMultipleKeys = _everGeneratedMultipleKeys || (keys.size() > 1);
-
-    if (!multikeyPaths.empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = multikeyPaths;
-        } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
-            for (size_t i = 0; i < multikeyPaths.size(); ++i) {
-                _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
-            }
-        }
-    }
+    mergeMultikeyPaths(&_indexMultikeyPaths, multikeyPaths);
 
     for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
         _sorter->add(*it, loc);
@@ -443,20 +648,79 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
     return Status::OK();
 }
 
+void IndexAccessMethod::BulkBuilder::persistForResume(BSONObjBuilder* builder) {
+    invariant(!_sorted);
+
+    {
+        BSONArrayBuilder runs(builder->subarrayStart("runs"));
+        for (const auto& fileName : _sorter->persistDataForResume()) {
+            runs.append(BSON("file" << fileName << "size"
+                                    << static_cast<long long>(
+                                           boost::filesystem::file_size(fileName))));
+        }
+    }
+
+    builder->append("keysInserted", static_cast<long long>(_keysInserted));
+    builder->append("multikey", _everGeneratedMultipleKeys);
+
+    BSONArrayBuilder multikeyPaths(builder->subarrayStart("multikeyPaths"));
+    for (const auto& components : _indexMultikeyPaths) {
+        BSONArrayBuilder path(multikeyPaths.subarrayStart());
+        for (size_t component : components) {
+            path.append(static_cast<int>(component));
+        }
+    }
+}
+
+void IndexAccessMethod::BulkBuilder::finishSorting() {
+    if (!_sorted) {
+        _sorted.reset(_sorter->done());
+    }
+}
 
 Status IndexAccessMethod::commitBulk(OperationContext* txn,
                                      std::unique_ptr<BulkBuilder> bulk,
                                      bool mayInterrupt,
                                      bool dupsAllowed,
                                      set<RecordId>* dupsToDrop) {
+    std::vector<std::unique_ptr<BulkBuilder>> bulks;
+    bulks.push_back(std::move(bulk));
+    return commitBulk(txn, std::move(bulks), mayInterrupt, dupsAllowed, dupsToDrop);
+}
+
+Status IndexAccessMethod::commitBulk(OperationContext* txn,
+                                     std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                                     bool mayInterrupt,
+                                     bool dupsAllowed,
+                                     set<RecordId>* dupsToDrop) {
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
+    int64_t keysInserted = 0;
+    bool everGeneratedMultipleKeys = false;
+    MultikeyPaths indexMultikeyPaths;
+    std::vector<std::shared_ptr<BulkBuilder::Sorter::Iterator>> sorted;
+    for (auto& bulk : bulks) {
+        bulk->finishSorting();
+        sorted.push_back(bulk->_sorted);
+        keysInserted += bulk->_keysInserted;
+        everGeneratedMultipleKeys = everGeneratedMultipleKeys || bulk->_everGeneratedMultipleKeys;
+        mergeMultikeyPaths(&indexMultikeyPaths, bulk->_indexMultikeyPaths);
+    }
+
+    std::shared_ptr<BulkBuilder::Sorter::Iterator> i;
+    if (sorted.size() == 1) {
+        i = sorted.front();
+    } else {
+        i.reset(BulkBuilder::Sorter::Iterator::merge(
+            sorted,
+            SortOptions(),
+            BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    }
 
     stdx::unique_lock<Client> lk(*txn->getClient());
     ProgressMeterHolder pm(*txn->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
                                                    "Index: (2/3) BTree Bottom Up Progress",
-                                                   bulk->_keysInserted,
+                                                   keysInserted,
                                                    10));
     lk.unlock();
 
@@ -465,8 +729,8 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
     MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
         WriteUnitOfWork wunit(txn);
 
-        if (bulk->_everGeneratedMultipleKeys || isMultikeyFromPaths(bulk->_indexMultikeyPaths)) {
-            _btreeState->setMultikey(txn, bulk->_indexMultikeyPaths);
+        if (everGeneratedMultipleKeys || isMultikeyFromPaths(indexMultikeyPaths)) {
+            _btreeState->setMultikey(txn, indexMultikeyPaths);
         }
 
         builder.reset(_newInterface->getBulkBuilder(txn, dupsAllowed));
@@ -32,12 +32,14 @@
 #include <memory>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string_set.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 
 namespace mongo {
@@ -199,7 +201,8 @@ public:
     class BulkBuilder {
     public:
         /**
-         * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod.
+         * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod. Only generates
+         * and buffers keys, so 'txn' is not used and may be null.
          */
         Status insert(OperationContext* txn,
                       const BSONObj& obj,
@@ -207,14 +210,29 @@ public:
                       const InsertDeleteOptions& options,
                       int64_t* numInserted);
 
+        /**
+         * Sorts the keys inserted so far, spilling to disk as needed. No more keys may be inserted
+         * afterwards. commitBulk() does this if it has not been done yet, but calling it early
+         * allows several BulkBuilders of the same index to be sorted on different threads.
+         */
+        void finishSorting();
+
+        /**
+         * Writes the keys inserted so far to stable storage so that the build can be resumed after
+         * a restart, and appends what resumeBulk() needs to recreate this BulkBuilder to
+         * 'builder'. More documents may be inserted afterwards.
+         */
+        void persistForResume(BSONObjBuilder* builder);
+
     private:
         friend class IndexAccessMethod;
 
         using Sorter = mongo::Sorter<BSONObj, RecordId>;
 
-        BulkBuilder(const IndexAccessMethod* index, const IndexDescriptor* descriptor);
+        BulkBuilder(const IndexAccessMethod* index, std::unique_ptr<Sorter> sorter);
 
         std::unique_ptr<Sorter> _sorter;
+        std::shared_ptr<Sorter::Iterator> _sorted;  // Set by finishSorting().
         const IndexAccessMethod* _real;
         int64_t _keysInserted = 0;
 
@@ -233,8 +251,27 @@ public:
      * This can return NULL, meaning bulk mode is not available.
      *
      * It is only legal to initiate bulk when the index is new and empty.
+     *
+     * 'maxMemoryUsageBytes' bounds the memory the BulkBuilder uses for sorting before it spills
+     * keys to disk. Keys are spilled into 'tempDir', or into the _tmp directory under the dbpath if
+     * it is empty. Only a BulkBuilder spilling outside of _tmp, which is cleared at startup, can be
+     * resumed after a restart.
+     */
+    std::unique_ptr<BulkBuilder> initiateBulk(
+        size_t maxMemoryUsageBytes = kDefaultMaxBulkMemoryUsageBytes,
+        const std::string& tempDir = "");
+
+    /**
+     * Recreates a BulkBuilder from what BulkBuilder::persistForResume() appended, holding the keys
+     * that had been inserted into it at the time. Fails if the files holding those keys are gone
+     * or do not match. Otherwise behaves like initiateBulk().
      */
-    std::unique_ptr<BulkBuilder> initiateBulk();
+    StatusWith<std::unique_ptr<BulkBuilder>> resumeBulk(
+        const BSONObj& persistedState,
+        const std::string& tempDir,
+        size_t maxMemoryUsageBytes = kDefaultMaxBulkMemoryUsageBytes);
+
+    static const size_t kDefaultMaxBulkMemoryUsageBytes = 100 * 1024 * 1024;
 
     /**
      * Call this when you are ready to finish your bulk work.
@@ -251,6 +288,16 @@ public:
                       bool dupsAllowed,
                       std::set<RecordId>* dups);
 
+    /**
+     * Like commitBulk() above, but loads the keys of several BulkBuilders of this index, for
+     * example ones filled on different threads. Their sorted keys are merged while loading.
+     */
+    Status commitBulk(OperationContext* txn,
+                      std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                      bool mayInterrupt,
+                      bool dupsAllowed,
+                      std::set<RecordId>* dups);
+
     /**
      * Fills 'keys' with the keys that should be generated for 'obj' on this index.
      *
@@ -264,6 +311,14 @@ public:
                          BSONObjSet* keys,
                          MultikeyPaths* multikeyPaths) const = 0;
 
+    /**
+     * Same as getKeys(), but adds the keys to the empty set 'keys' as KeyStrings. Used instead of
+     * getKeys() when the index can take encoded keys, so that each key is only encoded once.
+     */
+    virtual void getKeyStrings(const BSONObj& obj,
+                               KeyStringSet* keys,
+                               MultikeyPaths* multikeyPaths) const;
+
     /**
      * Splits the sets 'left' and 'right' into two vectors, the first containing the elements that
      * only appeared in 'left', and the second containing only elements that appeared in 'right'.
@@ -288,7 +343,48 @@ private:
                       const RecordId& loc,
                       bool dupsAllowed);
 
+    void removeOneKey(OperationContext* txn,
+                      const KeyStringSet::Key& key,
+                      const RecordId& loc,
+                      bool dupsAllowed);
+
+    /**
+     * Inserts 'keys', a BSONObjSet or a KeyStringSet generated from one document, pointing to
+     * 'loc'. Shared by insert() and insertKeyStrings(): skips keys too long to index unless
+     * failIndexKeyTooLong applies, and keys a background build has already indexed, removes the
+     * keys already inserted on any other error, and marks the index multikey when needed.
+     */
+    template <typename Keys>
+    Status insertKeys(OperationContext* txn,
+                      const Keys& keys,
+                      const MultikeyPaths& multikeyPaths,
+                      const RecordId& loc,
+                      const InsertDeleteOptions& options,
+                      int64_t* numInserted);
+
+    /**
+     * The versions of insert(), remove() and update() for indexes that take KeyStrings in
+     * 'version'.
+     */
+    Status insertKeyStrings(OperationContext* txn,
+                            const BSONObj& obj,
+                            const RecordId& loc,
+                            const InsertDeleteOptions& options,
+                            KeyString::Version version,
+                            int64_t* numInserted);
+    Status removeKeyStrings(OperationContext* txn,
+                            const BSONObj& obj,
+                            const RecordId& loc,
+                            const InsertDeleteOptions& options,
+                            KeyString::Version version,
+                            int64_t* numDeleted);
+    Status updateKeyStrings(OperationContext* txn,
+                            const UpdateTicket& ticket,
+                            int64_t* numInserted,
+                            int64_t* numDeleted);
+
     const std::unique_ptr<SortedDataInterface> _newInterface;
+    const Ordering _ordering;
 };
 
 /**
@@ -311,6 +407,14 @@ private:
     std::vector<BSONObj> removed;
     std::vector<BSONObj> added;
 
+    // Used instead of the BSONObj keys above if the index takes KeyStrings. 'removedKeyStrings'
+    // and 'addedKeyStrings' point into the two sets.
+    std::unique_ptr<KeyStringSet> oldKeyStrings;
+    std::unique_ptr<KeyStringSet> newKeyStrings;
+
+    std::vector<KeyStringSet::Key> removedKeyStrings;
+    std::vector<KeyStringSet::Key> addedKeyStrings;
+
     RecordId loc;
     bool dupsAllowed;
 
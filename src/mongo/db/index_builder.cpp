@@ -84,6 +84,7 @@ void IndexBuilder::run() {
     const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
     OperationContext& txn = *txnPtr;
     txn.lockState()->setIsBatchWriter(true);
+    txn.lockState()->setAdmissionPriority(TicketPriority::kLow);
 
     AuthorizationSession::get(txn.getClient())->grantInternalAuthorization();
 
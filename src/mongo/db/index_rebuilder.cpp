@@ -84,6 +84,7 @@ void checkNS(OperationContext* txn, const std::list<std::string>& nsToCheck) {
 
 
         MultiIndexBlock indexer(txn, collection);
+        indexer.allowResumingFromCheckpoint();
 
         {
             WriteUnitOfWork wunit(txn);
@@ -163,6 +164,9 @@ void restartInProgressIndexesFromLastShutdown(OperationContext* txn) {
             db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collNames);
         }
         checkNS(txn, collNames);
+
+        // Every build that could have resumed from a checkpoint has been restarted.
+        MultiIndexBlock::removeCheckpointsOfInterruptedBuilds();
     } catch (const DBException& e) {
         error() << "Index verification did not complete: " << redact(e);
         fassertFailedNoTrace(18643);
@@ -70,6 +70,11 @@ using std::string;
 OperationContextImpl::OperationContextImpl(Client* client, unsigned opId)
     : OperationContext(client, opId) {
     setLockState(std::move(clientOperationInfoDecoration(client).locker()));
+
+    // Server-internal threads (replication, background jobs) have no user connection and are
+    // admitted ahead of client operations unless they lower their own priority.
+    lockState()->setAdmissionPriority(client->isFromUserConnection() ? TicketPriority::kNormal
+                                                                     : TicketPriority::kHigh);
     StorageEngine* storageEngine = getServiceContext()->getGlobalStorageEngine();
     setRecoveryUnit(storageEngine->newRecoveryUnit(), kNotInUnitOfWork);
 }
@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -590,8 +591,13 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 // We won't be using groups again so free its memory.
                 _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
 
+                // Collators are not safe to share between the threads of a parallel merge.
+                SortOptions opts;
+                if (!pExpCtx->getCollator()) {
+                    opts.MergeThreads(internalQueryExecExternalSortMergeThreads.load());
+                }
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
-                    _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
+                    _sortedFiles, opts, SorterComparator(pExpCtx->getValueComparator())));
 
                 // prepare current to accumulate data
                 _currentAccumulators.reserve(numAccumulators);
@@ -625,7 +631,12 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
 
-    SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    SortedFileWriter<Value, Value> writer(
+        SortOptions()
+            .TempDir(pExpCtx->tempDir)
+            .SpillCompressor(internalQueryExecExternalSortUseZlib.load()
+                                 ? SortOptions::Compressor::kZlib
+                                 : SortOptions::Compressor::kSnappy));
     switch (vpAccumulatorFactory.size()) {  // same as ptrs[i]->second.size() for all i.
         case 0:                             // no values, essentially a distinct
             for (size_t i = 0; i < ptrs.size(); i++) {
@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -239,6 +240,14 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
     if (pExpCtx->extSortAllowed && !pExpCtx->inRouter) {
         opts.extSortAllowed = true;
         opts.tempDir = pExpCtx->tempDir;
+        if (internalQueryExecExternalSortUseZlib.load()) {
+            opts.compressor = SortOptions::Compressor::kZlib;
+        }
+
+        // Collators are not safe to share between the threads of a parallel merge.
+        if (!pExpCtx->getCollator()) {
+            opts.mergeThreads = internalQueryExecExternalSortMergeThreads.load();
+        }
     }
 
     return opts;
@@ -306,7 +315,9 @@ void DocumentSourceSort::populateFromCursors(const vector<DBClientCursor*>& curs
         iterators.push_back(std::make_shared<IteratorFromCursor>(this, cursors[i]));
     }
 
-    _output.reset(MySorter::Iterator::merge(iterators, makeSortOptions(), Comparator(*this)));
+    // The cursors can only be read from this thread.
+    _output.reset(MySorter::Iterator::merge(
+        iterators, makeSortOptions().MergeThreads(1), Comparator(*this)));
     _populated = true;
 }
 
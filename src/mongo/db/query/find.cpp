@@ -72,6 +72,62 @@ using stdx::make_unique;
 // Failpoint for checking whether we've received a getmore.
 MONGO_FP_DECLARE(failReceivedGetmore);
 
+namespace {
+
+/**
+ * Builds the OP_REPLY message for a find or getMore batch. Large documents that the executor
+ * returned as owned BSONObjs are not copied into the reply buffer; they are spliced in as
+ * MessageSegments and written to the socket with scatter-gather I/O.
+ */
+class ReplyBatchBuilder {
+public:
+    // Below this size an extra iovec costs more than copying the document.
+    static const int kMinBorrowedDocumentBytes = 4096;
+
+    explicit ReplyBatchBuilder(int initialSize) : _bb(initialSize) {
+        _bb.skip(sizeof(QueryResult::Value));
+    }
+
+    /**
+     * Number of bytes in the reply so far, including the header and borrowed documents.
+     */
+    int len() const {
+        return _bb.len() + _borrowedBytes;
+    }
+
+    void append(const BSONObj& obj) {
+        if (obj.isOwned() && obj.objsize() >= kMinBorrowedDocumentBytes) {
+            _segments.push_back({obj.sharedBuffer(),
+                                 obj.objdata(),
+                                 static_cast<size_t>(obj.objsize()),
+                                 static_cast<size_t>(_bb.len())});
+            _borrowedBytes += obj.objsize();
+            return;
+        }
+        _bb.appendBuf(obj.objdata(), obj.objsize());
+    }
+
+    /**
+     * The reply header. Its length field must be set from len() before calling release().
+     */
+    QueryResult::View header() {
+        return _bb.buf();
+    }
+
+    Message release() {
+        Message result;
+        result.setData(_bb.release(), std::move(_segments));
+        return result;
+    }
+
+private:
+    BufBuilder _bb;
+    std::vector<MessageSegment> _segments;
+    int _borrowedBytes = 0;
+};
+
+}  // namespace
+
 bool isCursorTailable(const ClientCursor* cursor) {
     return cursor->queryOptions() & QueryOption_CursorTailable;
 }
@@ -168,7 +224,7 @@ void endQueryOp(OperationContext* txn,
 namespace {
 
 /**
- * Uses 'cursor' to fill out 'bb' with the batch of result documents to
+ * Uses 'cursor' to fill out 'reply' with the batch of result documents to
  * be returned by this getMore.
  *
  * Returns the number of documents in the batch in 'numResults', which must be initialized to
@@ -181,7 +237,7 @@ namespace {
  */
 void generateBatch(int ntoreturn,
                    ClientCursor* cursor,
-                   BufBuilder* bb,
+                   ReplyBatchBuilder* reply,
                    int* numResults,
                    Timestamp* slaveReadTill,
                    PlanExecutor::ExecState* state) {
@@ -191,13 +247,13 @@ void generateBatch(int ntoreturn,
     while (!FindCommon::enoughForGetMore(ntoreturn, *numResults) &&
            PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
         // If we can't fit this result inside the current batch, then we stash it for later.
-        if (!FindCommon::haveSpaceForNext(obj, *numResults, bb->len())) {
+        if (!FindCommon::haveSpaceForNext(obj, *numResults, reply->len())) {
             exec->enqueue(obj);
             break;
         }
 
         // Add result to output buffer.
-        bb->appendBuf((void*)obj.objdata(), obj.objsize());
+        reply->append(obj);
 
         // Count the result.
         (*numResults)++;
@@ -300,8 +356,7 @@ Message getMore(OperationContext* txn,
     const int InitialBufSize =
         512 + sizeof(QueryResult::Value) + FindCommon::kMaxBytesToReturnToClientAtOnce;
 
-    BufBuilder bb(InitialBufSize);
-    bb.skip(sizeof(QueryResult::Value));
+    ReplyBatchBuilder reply(InitialBufSize);
 
     if (NULL == cc) {
         cursorid = 0;
@@ -383,7 +438,7 @@ Message getMore(OperationContext* txn,
         PlanSummaryStats preExecutionStats;
         Explain::getSummaryStats(*exec, &preExecutionStats);
 
-        generateBatch(ntoreturn, cc, &bb, &numResults, &slaveReadTill, &state);
+        generateBatch(ntoreturn, cc, &reply, &numResults, &slaveReadTill, &state);
 
         // If this is an await data cursor, and we hit EOF without generating any results, then
         // we block waiting for new data to arrive.
@@ -407,7 +462,7 @@ Message getMore(OperationContext* txn,
 
             // We woke up because either the timed_wait expired, or there was more data. Either
             // way, attempt to generate another batch of results.
-            generateBatch(ntoreturn, cc, &bb, &numResults, &slaveReadTill, &state);
+            generateBatch(ntoreturn, cc, &reply, &numResults, &slaveReadTill, &state);
         }
 
         PlanSummaryStats postExecutionStats;
@@ -478,15 +533,15 @@ Message getMore(OperationContext* txn,
         }
     }
 
-    QueryResult::View qr = bb.buf();
-    qr.msgdata().setLen(bb.len());
+    QueryResult::View qr = reply.header();
+    qr.msgdata().setLen(reply.len());
     qr.msgdata().setOperation(opReply);
     qr.setResultFlags(resultFlags);
     qr.setCursorId(cursorid);
     qr.setStartingFrom(startingResult);
     qr.setNReturned(numResults);
     LOG(5) << "getMore returned " << numResults << " results\n";
-    return Message(bb.release());
+    return reply.release();
 }
 
 std::string runQuery(OperationContext* txn,
@@ -569,11 +624,10 @@ std::string runQuery(OperationContext* txn,
     uassertStatusOK(serveReadsStatus);
 
     // Run the query.
-    // bb is used to hold query results
+    // reply is used to hold query results
     // this buffer should contain either requested documents per query or
     // explain information, but not both
-    BufBuilder bb(FindCommon::kInitReplyBufferSize);
-    bb.skip(sizeof(QueryResult::Value));
+    ReplyBatchBuilder reply(FindCommon::kInitReplyBufferSize);
 
     // How many results have we obtained from the executor?
     int numResults = 0;
@@ -592,13 +646,13 @@ std::string runQuery(OperationContext* txn,
 
     while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
         // If we can't fit this result inside the current batch, then we stash it for later.
-        if (!FindCommon::haveSpaceForNext(obj, numResults, bb.len())) {
+        if (!FindCommon::haveSpaceForNext(obj, numResults, reply.len())) {
             exec->enqueue(obj);
             break;
         }
 
         // Add result to output buffer.
-        bb.appendBuf((void*)obj.objdata(), obj.objsize());
+        reply.append(obj);
 
         // Count the result.
         ++numResults;
@@ -685,16 +739,16 @@ std::string runQuery(OperationContext* txn,
     }
 
     // Fill out the output buffer's header.
-    QueryResult::View queryResultView = bb.buf();
+    QueryResult::View queryResultView = reply.header();
     queryResultView.setCursorId(ccId);
     queryResultView.setResultFlagsToOk();
-    queryResultView.msgdata().setLen(bb.len());
+    queryResultView.msgdata().setLen(reply.len());
     queryResultView.msgdata().setOperation(opReply);
     queryResultView.setStartingFrom(0);
     queryResultView.setNReturned(numResults);
 
     // Add the results from the query into the output buffer.
-    result.setData(bb.release());
+    result = reply.release();
 
     // curOp.debug().exhaust is set above.
     return curOp.debug().exhaust ? nss.ns() : "";
@@ -62,6 +62,52 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+std::atomic<int> internalQueryExecExternalSortMergeThreads(1);  // NOLINT
+
+namespace {
+class ExportedExternalSortMergeThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedExternalSortMergeThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "internalQueryExecExternalSortMergeThreads",
+              &internalQueryExecExternalSortMergeThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryExecExternalSortMergeThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    }
+} exportedExternalSortMergeThreadsParam;
+}  // namespace
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecExternalSortUseZlib, bool, false);
+
+std::atomic<int> internalQueryExecFetchBatchSize(1);  // NOLINT
+
+namespace {
+class ExportedFetchBatchSizeParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFetchBatchSizeParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "internalQueryExecFetchBatchSize",
+              &internalQueryExecFetchBatchSize) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryExecFetchBatchSize must be greater than or equal to 1");
+        }
+        return Status::OK();
+    }
+} exportedFetchBatchSizeParam;
+}  // namespace
+
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
@@ -99,6 +99,19 @@ extern std::atomic<int> internalQueryMaxScansToExplode;  // NOLINT
 
 extern std::atomic<int> internalQueryExecMaxBlockingSortBytes;  // NOLINT
 
+// How many threads an external sort may use to merge its spilled runs. Each thread merges a
+// subset of the runs, reading and decompressing ahead of the final merge. 1 merges on the
+// calling thread only. Must be between 1 and 64.
+extern std::atomic<int> internalQueryExecExternalSortMergeThreads;  // NOLINT
+
+// Compress the runs that an external sort spills to disk with zlib rather than snappy.
+extern std::atomic<bool> internalQueryExecExternalSortUseZlib;  // NOLINT
+
+// The most RecordIds a FETCH stage buffers from its child and reads in RecordId order, on storage
+// engines with document-level locking. 1 reads each record as soon as its RecordId arrives. Must be
+// at least 1.
+extern std::atomic<int> internalQueryExecFetchBatchSize;  // NOLINT
+
 // Yield after this many "should yield?" checks.
 extern std::atomic<int> internalQueryExecYieldIterations;  // NOLINT
 
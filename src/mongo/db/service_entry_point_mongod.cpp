@@ -34,16 +34,23 @@
 
 #include <vector>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/instance.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/transport/service_entry_point_utils.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/ticket.h"
 #include "mongo/transport/transport_layer.h"
+#include "mongo/transport/transport_layer_startup_param.h"
+#include "mongo/util/concurrency/adaptive_thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/thread_idle_callback.h"
@@ -53,6 +60,74 @@
 namespace mongo {
 namespace {
 
+// Bounds on the number of threads executing requests when sessions are run asynchronously on top
+// of the asio transport layer. 0 means the number of cores for the minimum, and 16 times the
+// number of cores for the maximum.
+int serviceWorkerMinThreads = 0;
+int serviceWorkerThreads = 0;
+
+// Checks a new minimum or maximum against the other bound. Each parameter checks the other, so a
+// conflicting pair is rejected whichever of them is set last.
+Status validateServiceWorkerBounds(const std::string& name, int minThreads, int maxThreads) {
+    if (minThreads < 0 || maxThreads < 0) {
+        return Status(ErrorCodes::BadValue, name + " must be greater than or equal to 0");
+    }
+    if (minThreads > 0 && maxThreads > 0 && minThreads > maxThreads) {
+        return Status(ErrorCodes::BadValue,
+                      "serviceWorkerMinThreads must not be greater than serviceWorkerThreads");
+    }
+    return Status::OK();
+}
+
+class ExportedServiceWorkerMinThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedServiceWorkerMinThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "serviceWorkerMinThreads",
+              &serviceWorkerMinThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        return validateServiceWorkerBounds(name(), potentialNewValue, serviceWorkerThreads);
+    }
+} exportedServiceWorkerMinThreadsParam;
+
+class ExportedServiceWorkerThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedServiceWorkerThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), "serviceWorkerThreads", &serviceWorkerThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        return validateServiceWorkerBounds(name(), serviceWorkerMinThreads, potentialNewValue);
+    }
+} exportedServiceWorkerThreadsParam;
+
+// A worker thread is added once a request has been queued for longer than this, unless the CPUs
+// are already saturated.
+int serviceWorkerTargetQueueLatencyMicros = 1000;
+
+class ExportedServiceWorkerTargetQueueLatencyMicrosParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedServiceWorkerTargetQueueLatencyMicrosParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "serviceWorkerTargetQueueLatencyMicros",
+              &serviceWorkerTargetQueueLatencyMicros) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "serviceWorkerTargetQueueLatencyMicros must be greater than or equal "
+                          "to 0");
+        }
+        return Status::OK();
+    }
+} exportedServiceWorkerTargetQueueLatencyMicrosParam;
+
 // Set up proper headers for formatting an exhaust request, if we need to
 bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     MsgData::View header = dbresponse.response.header();
@@ -85,14 +160,144 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+
+/**
+ * Runs 'inMessage' through mongod and formats the reply in 'dbresponse'. Returns true if the
+ * reply is a batch of an exhaust cursor, in which case 'inMessage' has been replaced with the
+ * getMore that produces the next batch and no new Message should be sourced from the client.
+ */
+bool processMessage(transport::Session* session, Message* inMessage, DbResponse* dbresponse) {
+    {
+        auto opCtx = cc().makeOperationContext();
+        assembleResponse(opCtx.get(), *inMessage, *dbresponse, session->remote());
+
+        // opCtx must go out of scope here so that the operation cannot show
+        // up in currentOp results after the response reaches the client
+    }
+
+    Message& toSink = dbresponse->response;
+    if (toSink.empty()) {
+        return false;
+    }
+
+    toSink.header().setId(nextMessageId());
+    toSink.header().setResponseToMsgId(inMessage->header().getId());
+
+    // If this is an exhaust cursor, don't source more Messages
+    return dbresponse->exhaustNS.size() > 0 && setExhaustMessage(inMessage, *dbresponse);
+}
+
 }  // namespace
 
 using transport::Session;
 using transport::TransportLayer;
 
-ServiceEntryPointMongod::ServiceEntryPointMongod(TransportLayer* tl) : _tl(tl) {}
+/**
+ * The state of a Session that is run asynchronously. It is kept alive by the outstanding
+ * TransportLayer operation or worker pool task, of which there is at most one at a time.
+ */
+struct ServiceEntryPointMongod::AsyncSession {
+    explicit AsyncSession(Session session) : session(std::move(session)) {}
+
+    Session session;
+
+    // The Client for this Session; null while it is attached to a worker thread.
+    ServiceContext::UniqueClient client;
+
+    Message inMessage;
+    DbResponse dbresponse;
+    bool inExhaust = false;
+    int64_t counter = 0;
+};
+
+ServiceEntryPointMongod::ServiceEntryPointMongod(TransportLayer* tl) : _tl(tl) {
+    if (!transport::isTransportLayerASIO()) {
+        return;
+    }
+
+    const size_t numCores = std::max(1u, stdx::thread::hardware_concurrency());
+
+    AdaptiveThreadPool::Options options;
+    options.poolName = "ServiceWorkers";
+    options.threadNamePrefix = "conn-worker-";
+    options.minThreads =
+        serviceWorkerMinThreads > 0 ? static_cast<size_t>(serviceWorkerMinThreads) : numCores;
+    options.maxThreads =
+        serviceWorkerThreads > 0 ? static_cast<size_t>(serviceWorkerThreads) : 16 * numCores;
+    options.minThreads = std::min(options.minThreads, options.maxThreads);
+    options.targetQueueLatency = Microseconds(serviceWorkerTargetQueueLatencyMicros);
+
+    _workerPool = stdx::make_unique<AdaptiveThreadPool>(options);
+    _workerPool->startup();
+}
+
+ServiceEntryPointMongod::~ServiceEntryPointMongod() = default;
+
+void ServiceEntryPointMongod::shutdown() {
+    if (!_workerPool) {
+        return;
+    }
+
+    // Requests that are still queued or running find the TransportLayer shut down when they try
+    // to sink their responses, and end their Sessions.
+    _workerPool->shutdown();
+    _workerPool->join();
+}
+
+void ServiceEntryPointMongod::appendWorkerPoolStats(BSONObjBuilder* bob) const {
+    if (!_workerPool) {
+        return;
+    }
+
+    const auto stats = _workerPool->getStats();
+    bob->append("threads", static_cast<long long>(stats.numThreads));
+    bob->append("idleThreads", static_cast<long long>(stats.numIdleThreads));
+    bob->append("activeRequests", static_cast<long long>(_nWorkers.load()));
+    bob->append("queueDepth", static_cast<long long>(stats.numPendingTasks));
+    bob->append("oldestQueuedMicros", durationCount<Microseconds>(stats.oldestPendingTaskAge));
+    bob->append("totalRequests", static_cast<long long>(stats.totalTasksExecuted));
+    bob->append("totalQueueWaitMicros", durationCount<Microseconds>(stats.totalQueueWaitTime));
+    bob->append("totalExecutionMicros", durationCount<Microseconds>(stats.totalExecutionTime));
+    bob->append("threadsStarted", static_cast<long long>(stats.totalThreadsStarted));
+    bob->append("threadsRetired", static_cast<long long>(stats.totalThreadsRetired));
+    bob->append("cpuSaturatedIntervals", static_cast<long long>(stats.totalCpuSaturatedIntervals));
+    bob->append("cpuUtilization", stats.cpuUtilization);
+}
+
+namespace {
+
+class ServiceExecutorServerStatusSection final : public ServerStatusSection {
+public:
+    ServiceExecutorServerStatusSection() : ServerStatusSection("serviceExecutor") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* txn,
+                            const BSONElement& configElement) const override {
+        auto sep = txn->getServiceContext()->getServiceEntryPoint();
+        if (!sep) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder bob;
+        checked_cast<ServiceEntryPointMongod*>(sep)->appendWorkerPoolStats(&bob);
+        return bob.obj();
+    }
+} serviceExecutorServerStatusSection;
+
+}  // namespace
 
 void ServiceEntryPointMongod::startSession(Session&& session) {
+    if (_workerPool) {
+        auto state = std::make_shared<AsyncSession>(std::move(session));
+        state->client = getGlobalServiceContext()->makeClient(
+            str::stream() << "conn" << state->session.id(), &state->session);
+        _asyncSourceMessage(state);
+        return;
+    }
+
     launchWrappedServiceEntryWorkerThread(std::move(session), [this](Session* session) {
         _nWorkers.fetchAndAdd(1);
         auto guard = MakeGuard([&] { _nWorkers.fetchAndSubtract(1); });
@@ -120,33 +325,14 @@ void ServiceEntryPointMongod::_sessionLoop(Session* session) {
             uassertStatusOK(status);
         }
 
-        // 2. Pass sourced Message up to mongod
+        // 2. Pass sourced Message up to mongod and format our response, if we have one
         DbResponse dbresponse;
-        {
-            auto opCtx = cc().makeOperationContext();
-            assembleResponse(opCtx.get(), inMessage, dbresponse, session->remote());
-
-            // opCtx must go out of scope here so that the operation cannot show
-            // up in currentOp results after the response reaches the client
-        }
+        inExhaust = processMessage(session, &inMessage, &dbresponse);
 
-        // 3. Format our response, if we have one
+        // 3. Sink our response to the client
         Message& toSink = dbresponse.response;
         if (!toSink.empty()) {
-            toSink.header().setId(nextMessageId());
-            toSink.header().setResponseToMsgId(inMessage.header().getId());
-
-            // If this is an exhaust cursor, don't source more Messages
-            if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&inMessage, dbresponse)) {
-                inExhaust = true;
-            } else {
-                inExhaust = false;
-            }
-
-            // 4. Sink our response to the client
             uassertStatusOK(session->sinkMessage(toSink).wait());
-        } else {
-            inExhaust = false;
         }
 
         if ((counter++ & 0xf) == 0) {
@@ -155,4 +341,91 @@ void ServiceEntryPointMongod::_sessionLoop(Session* session) {
     }
 }
 
+void ServiceEntryPointMongod::_asyncSourceMessage(const AsyncSessionHandle& state) {
+    state->inMessage.reset();
+    state->session.sourceMessage(&state->inMessage).asyncWait([this, state](Status status) {
+        if (!status.isOK()) {
+            if (!ErrorCodes::isInterruption(status.code()) &&
+                !ErrorCodes::isNetworkError(status.code())) {
+                log() << "Error receiving request from client, closing client connection: "
+                      << status;
+            }
+            return _asyncEndSession(state);
+        }
+
+        _scheduleProcessMessage(state);
+    });
+}
+
+void ServiceEntryPointMongod::_scheduleProcessMessage(const AsyncSessionHandle& state) {
+    auto status = _workerPool->schedule([this, state] { _asyncProcessMessage(state); });
+    if (!status.isOK()) {
+        log() << "Failed to schedule request for execution, closing client connection: "
+              << status;
+        _asyncEndSession(state);
+    }
+}
+
+void ServiceEntryPointMongod::_asyncProcessMessage(const AsyncSessionHandle& state) {
+    Client::setCurrent(std::move(state->client));
+    _nWorkers.fetchAndAdd(1);
+
+    bool failed = false;
+    try {
+        state->dbresponse = DbResponse();
+        state->inExhaust = processMessage(&state->session, &state->inMessage, &state->dbresponse);
+    } catch (const DBException& e) {
+        log() << "DBException handling request, closing client connection: " << e;
+        failed = true;
+    } catch (const std::exception& e) {
+        error() << "Uncaught std::exception: " << e.what() << ", terminating";
+        quickExit(EXIT_UNCAUGHT);
+    }
+
+    if ((state->counter++ & 0xf) == 0) {
+        markThreadIdle();
+    }
+
+    // The Client must be detached before any further work is started for this Session, since
+    // that work may complete on another thread.
+    _nWorkers.fetchAndSubtract(1);
+    state->client = Client::releaseCurrent();
+
+    if (failed) {
+        return _asyncEndSession(state);
+    }
+
+    const Message& toSink = state->dbresponse.response;
+    if (toSink.empty()) {
+        return _asyncSourceMessage(state);
+    }
+
+    state->session.sinkMessage(toSink).asyncWait([this, state](Status status) {
+        if (!status.isOK()) {
+            return _asyncEndSession(state);
+        }
+
+        if (state->inExhaust) {
+            _scheduleProcessMessage(state);
+        } else {
+            _asyncSourceMessage(state);
+        }
+    });
+}
+
+void ServiceEntryPointMongod::_asyncEndSession(const AsyncSessionHandle& state) {
+    auto tl = state->session.getTransportLayer();
+    tl->end(state->session);
+
+    if (!serverGlobalParams.quiet) {
+        auto conns = tl->sessionStats().numOpenSessions;
+        const char* word = (conns == 1 ? " connection" : " connections");
+        log() << "end connection " << state->session.remote() << " (" << conns << word
+              << " now open)";
+    }
+
+    // The Client refers to the Session, so it must go away first.
+    state->client.reset();
+}
+
 }  // namespace mongo
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -36,14 +37,25 @@
 
 namespace mongo {
 
+class AdaptiveThreadPool;
+class BSONObjBuilder;
+
 namespace transport {
 class Session;
 class TransportLayer;
 }  // namespace transport
 
 /**
- * The entry point from the TransportLayer into Mongod. startSession() spawns and
- * detaches a new thread for each incoming connection (transport::Session).
+ * The entry point from the TransportLayer into Mongod.
+ *
+ * With the legacy transport layer, startSession() spawns and detaches a new thread for each
+ * incoming connection (transport::Session).
+ *
+ * With the asio transport layer, no thread is dedicated to a Session. Messages are sourced and
+ * sunk asynchronously by the TransportLayer, and each complete request is handed to a bounded
+ * pool of worker threads, which adopts the Session's Client for the duration of the request.
+ * The pool grows and shrinks with the measured queueing delay and CPU utilization (see
+ * AdaptiveThreadPool), so connections can be oversubscribed without oversubscribing cores.
  */
 class ServiceEntryPointMongod final : public ServiceEntryPoint {
     MONGO_DISALLOW_COPYING(ServiceEntryPointMongod);
@@ -51,19 +63,41 @@ class ServiceEntryPointMongod final : public ServiceEntryPoint {
 public:
     explicit ServiceEntryPointMongod(transport::TransportLayer* tl);
 
-    virtual ~ServiceEntryPointMongod() = default;
+    virtual ~ServiceEntryPointMongod();
 
     void startSession(transport::Session&& session) override;
 
+    /**
+     * Shuts down and joins the request worker pool, if there is one.
+     */
+    void shutdown() override;
+
     std::size_t getNumberOfActiveWorkerThreads() const {
         return _nWorkers.load();
     }
 
+    /**
+     * Appends the statistics of the request worker pool, if there is one, to "bob". Appends
+     * nothing when every Session runs on its own thread.
+     */
+    void appendWorkerPoolStats(BSONObjBuilder* bob) const;
+
 private:
+    struct AsyncSession;
+    using AsyncSessionHandle = std::shared_ptr<AsyncSession>;
+
     void _sessionLoop(transport::Session* session);
 
+    void _asyncSourceMessage(const AsyncSessionHandle& state);
+    void _scheduleProcessMessage(const AsyncSessionHandle& state);
+    void _asyncProcessMessage(const AsyncSessionHandle& state);
+    void _asyncEndSession(const AsyncSessionHandle& state);
+
     transport::TransportLayer* _tl;
     AtomicWord<std::size_t> _nWorkers;
+
+    // Only set when sessions are run asynchronously on top of the asio transport layer.
+    std::unique_ptr<AdaptiveThreadPool> _workerPool;
 };
 
 }  // namespace mongo
@@ -48,8 +48,11 @@
 #include "mongo/db/sorter/sorter.h"
 
 #include <boost/filesystem/operations.hpp>
+#include <cstring>
+#include <exception>
 #include <snappy.h>
 #include <vector>
+#include <zlib.h>
 
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
@@ -59,9 +62,13 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/file.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/print.h"
 #include "mongo/util/unowned_ptr.h"
@@ -80,6 +87,81 @@ inline std::string myErrnoWithDescription() {
     return sb.str();
 }
 
+// Compressed blocks start with one of these, so files can be read back whichever compressor
+// the SortOptions name. Zlib blocks then hold their uncompressed size, snappy ones already do.
+const char kSnappyBlock = 's';
+const char kZlibBlock = 'z';
+
+/** Replaces 'out' with the compressed form of the 'size' bytes at 'data'. */
+inline void compressBlock(SortOptions::Compressor compressor,
+                          const char* data,
+                          size_t size,
+                          std::string* out) {
+    if (compressor == SortOptions::Compressor::kSnappy) {
+        // Compress straight after the type byte rather than shifting the block up to make room.
+        out->resize(1 + snappy::MaxCompressedLength(size));
+        (*out)[0] = kSnappyBlock;
+        size_t compressedSize;
+        snappy::RawCompress(data, size, &(*out)[1], &compressedSize);
+        out->resize(1 + compressedSize);
+        return;
+    }
+
+    const uint32_t uncompressedSize = size;
+    uLongf compressedSize = ::compressBound(size);
+    out->resize(1 + sizeof(uncompressedSize) + compressedSize);
+    (*out)[0] = kZlibBlock;
+    std::memcpy(&(*out)[1], &uncompressedSize, sizeof(uncompressedSize));
+    const int ret = ::compress2(reinterpret_cast<Bytef*>(&(*out)[1 + sizeof(uncompressedSize)]),
+                                &compressedSize,
+                                reinterpret_cast<const Bytef*>(data),
+                                size,
+                                Z_DEFAULT_COMPRESSION);
+    massert(40325, str::stream() << "zlib compression failed with " << ret, ret == Z_OK);
+    out->resize(1 + sizeof(uncompressedSize) + compressedSize);
+}
+
+/** Returns the decompressed form of a block compressed by compressBlock(). */
+inline std::unique_ptr<char[]> decompressBlock(const char* data,
+                                               size_t size,
+                                               size_t* uncompressedSize) {
+    massert(40326, "compressed block is empty", size > 0);
+    const char type = data[0];
+    data++;
+    size--;
+
+    if (type == kSnappyBlock) {
+        dassert(snappy::IsValidCompressedBuffer(data, size));
+
+        massert(17061,
+                "couldn't get uncompressed length",
+                snappy::GetUncompressedLength(data, size, uncompressedSize));
+
+        std::unique_ptr<char[]> out(new char[*uncompressedSize]);
+        massert(17062, "decompression failed", snappy::RawUncompress(data, size, out.get()));
+        return out;
+    }
+
+    massert(40327,
+            str::stream() << "unknown compressed block type " << static_cast<int>(type),
+            type == kZlibBlock && size >= sizeof(uint32_t));
+
+    uint32_t expectedSize;
+    std::memcpy(&expectedSize, data, sizeof(expectedSize));
+    data += sizeof(expectedSize);
+    size -= sizeof(expectedSize);
+
+    std::unique_ptr<char[]> out(new char[expectedSize]);
+    uLongf length = expectedSize;
+    const int ret = ::uncompress(
+        reinterpret_cast<Bytef*>(out.get()), &length, reinterpret_cast<const Bytef*>(data), size);
+    massert(40328,
+            str::stream() << "zlib decompression failed with " << ret,
+            ret == Z_OK && length == expectedSize);
+    *uncompressedSize = length;
+    return out;
+}
+
 template <typename Data, typename Comparator>
 void compIsntSane(const Comparator& comp, const Data& lhs, const Data& rhs) {
     PRINT(typeid(comp).name());
@@ -120,16 +202,28 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
-/** Ensures a named file is deleted when this object goes out of scope */
+/** Ensures a named file is deleted when this object goes out of scope, unless kept */
 class FileDeleter {
 public:
     FileDeleter(const std::string& fileName) : _fileName(fileName) {}
     ~FileDeleter() {
-        DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName);)
+        if (!_keep) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName);)
+        }
+    }
+
+    const std::string& fileName() const {
+        return _fileName;
+    }
+
+    /// Leaves the file in place when this object goes out of scope.
+    void keep() {
+        _keep = true;
     }
 
 private:
     const std::string _fileName;
+    bool _keep = false;
 };
 
 /** Returns results from sorted in-memory storage */
@@ -247,17 +341,9 @@ private:
             return;
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
-
         size_t uncompressedSize;
-        massert(17061,
-                "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
-
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
-        massert(17062,
-                "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
+        std::unique_ptr<char[]> decompressionBuffer =
+            decompressBlock(_buffer.get(), blockSize, &uncompressedSize);
 
         // hold on to decompressed data and throw out compressed data at block exit
         _buffer.swap(decompressionBuffer);
@@ -289,7 +375,11 @@ private:
     std::ifstream _file;
 };
 
-/** Merge-sorts results from 0 or more FileIterators */
+/**
+ * Merge-sorts results from 0 or more iterators using a tournament tree of losers. Producing a
+ * result takes one comparison per level of the tree, so about log2(k) comparisons for k inputs,
+ * and never moves the inputs around. Ties go to the earlier input, which keeps the merge stable.
+ */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
 public:
@@ -300,35 +390,47 @@ public:
     MergeIterator(const std::vector<std::shared_ptr<Input>>& iters,
                   const SortOptions& opts,
                   const Comparator& comp)
-        : _opts(opts),
-          _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
+        : _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
-          _greater(comp) {
+          _comp(comp) {
         for (size_t i = 0; i < iters.size(); i++) {
             if (iters[i]->more()) {
-                _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+                _streams.emplace_back(iters[i]->next(), iters[i]);
             }
         }
 
-        if (_heap.empty()) {
+        _numActive = _streams.size();
+        if (_streams.empty()) {
             _remaining = 0;
             return;
         }
 
-        std::make_heap(_heap.begin(), _heap.end(), _greater);
-        std::pop_heap(_heap.begin(), _heap.end(), _greater);
-        _current = _heap.back();
-        _heap.pop_back();
+        // Leaf i of the tree is node k + i, the parent of node n is n / 2 and node 1 is the root.
+        // Play every match bottom-up, keeping the loser in the node and passing the winner on.
+        const size_t k = _streams.size();
+        std::vector<size_t> winners(2 * k);
+        for (size_t i = 0; i < k; i++) {
+            winners[k + i] = i;
+        }
+        _tree.resize(k);
+        for (size_t node = k - 1; node >= 1; node--) {
+            const size_t lhs = winners[2 * node];
+            const size_t rhs = winners[2 * node + 1];
+            const bool lhsWins = beats(lhs, rhs);
+            winners[node] = lhsWins ? lhs : rhs;
+            _tree[node] = lhsWins ? rhs : lhs;
+        }
+        _tree[0] = winners[1];
     }
 
     bool more() {
-        if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+        if (_remaining > 0 && (_first || _numActive > 1 || _streams[_tree[0]].rest->more()))
             return true;
 
         // We are done so clean up resources.
         // Can't do this in next() due to lifetime guarantees of unowned Data.
-        _heap.clear();
-        _current.reset();
+        _streams.clear();
+        _tree.clear();
         _remaining = 0;
 
         return false;
@@ -341,76 +443,191 @@ public:
 
         if (_first) {
             _first = false;
-            return _current->current();
+            return _streams[_tree[0]].current;
         }
 
-        if (!_current->advance()) {
-            verify(!_heap.empty());
+        // Only the input that won the last round changed, so only its path to the root needs to
+        // be replayed.
+        size_t winner = _tree[0];
+        Stream& stream = _streams[winner];
+        if (stream.rest->more()) {
+            stream.current = stream.rest->next();
+        } else {
+            stream.exhausted = true;
+            _numActive--;
+        }
 
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            _current = _heap.back();
-            _heap.pop_back();
-        } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            std::swap(_current, _heap.back());
-            std::push_heap(_heap.begin(), _heap.end(), _greater);
+        for (size_t node = (_streams.size() + winner) / 2; node >= 1; node /= 2) {
+            if (beats(_tree[node], winner)) {
+                std::swap(_tree[node], winner);
+            }
         }
+        _tree[0] = winner;
 
-        return _current->current();
+        verify(!_streams[winner].exhausted);
+        return _streams[winner].current;
     }
 
-
 private:
-    class Stream {  // Data + Iterator
-    public:
-        Stream(size_t fileNum, const Data& first, std::shared_ptr<Input> rest)
-            : fileNum(fileNum), _current(first), _rest(rest) {}
+    struct Stream {  // Data + Iterator
+        Stream(const Data& first, std::shared_ptr<Input> rest) : current(first), rest(rest) {}
 
-        const Data& current() const {
-            return _current;
-        }
-        bool more() {
-            return _rest->more();
+        Data current;
+        std::shared_ptr<Input> rest;
+        bool exhausted = false;
+    };
+
+    /** Returns true if the current data of stream 'lhs' comes before that of stream 'rhs'. */
+    bool beats(size_t lhs, size_t rhs) const {
+        if (_streams[lhs].exhausted)
+            return false;
+        if (_streams[rhs].exhausted)
+            return true;
+
+        // first compare data
+        dassertCompIsSane(_comp, _streams[lhs].current, _streams[rhs].current);
+        int ret = _comp(_streams[lhs].current, _streams[rhs].current);
+        if (ret)
+            return ret < 0;
+
+        // then compare stream numbers to ensure stability
+        return lhs < rhs;
+    }
+
+    unsigned long long _remaining;
+    bool _first;
+    const Comparator _comp;
+    std::vector<Stream> _streams;
+    size_t _numActive;  // Streams that have not run out of data.
+
+    // _tree[0] is the stream with the current result; the other nodes hold the loser of their
+    // match.
+    std::vector<size_t> _tree;
+};
+
+/**
+ * Merges some of the inputs of a parallel merge on a thread of its own and hands the results to
+ * the final merge in batches. Reading and decompressing the spilled blocks of those inputs
+ * happens on that thread as well, ahead of the final merge.
+ */
+template <typename Key, typename Value, typename Comparator>
+class BackgroundMergeIterator : public SortIteratorInterface<Key, Value> {
+public:
+    typedef SortIteratorInterface<Key, Value> Input;
+    typedef std::pair<Key, Value> Data;
+
+    BackgroundMergeIterator(const std::vector<std::shared_ptr<Input>>& iters,
+                            const SortOptions& opts,
+                            const Comparator& comp)
+        : _thread([this, iters, opts, comp] { _mergeInputs(iters, opts, comp); }) {}
+
+    ~BackgroundMergeIterator() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _cancelled = true;
         }
-        bool advance() {
-            if (!_rest->more())
-                return false;
+        _producerCV.notify_one();
+        _thread.join();
+    }
 
-            _current = _rest->next();
+    bool more() {
+        if (_position < _batch.size())
             return true;
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _consumerCV.wait(lk, [&] { return !_batches.empty() || _done; });
+        if (_batches.empty()) {
+            if (_error) {
+                // Rethrown once, like the error would have been by a MergeIterator.
+                std::exception_ptr error;
+                std::swap(error, _error);
+                std::rethrow_exception(error);
+            }
+            return false;
         }
 
-        const size_t fileNum;
+        _batch = std::move(_batches.front());
+        _batches.pop_front();
+        _position = 0;
+        lk.unlock();
+        _producerCV.notify_one();
+        return true;
+    }
 
-    private:
-        Data _current;
-        std::shared_ptr<Input> _rest;
-    };
+    Data next() {
+        verify(_position < _batch.size());
+        return std::move(_batch[_position++]);
+    }
 
-    class STLComparator {  // uses greater rather than less-than to maintain a MinHeap
-    public:
-        explicit STLComparator(const Comparator& comp) : _comp(comp) {}
-        bool operator()(unowned_ptr<const Stream> lhs, unowned_ptr<const Stream> rhs) const {
-            // first compare data
-            dassertCompIsSane(_comp, lhs->current(), rhs->current());
-            int ret = _comp(lhs->current(), rhs->current());
-            if (ret)
-                return ret > 0;
+private:
+    // A batch is handed over once it holds this many results or this many bytes.
+    static const size_t kMaxBatchSize = 1024;
+    static const size_t kMaxBatchBytes = 1024 * 1024;
+
+    // Batches merged ahead of the final merge.
+    static const size_t kMaxQueuedBatches = 4;
+
+    void _mergeInputs(const std::vector<std::shared_ptr<Input>>& iters,
+                      const SortOptions& opts,
+                      const Comparator& comp) {
+        try {
+            MergeIterator<Key, Value, Comparator> merged(iters, opts, comp);
+            std::vector<Data> batch;
+            size_t batchBytes = 0;
+            while (merged.more()) {
+                // The results outlive the blocks they were read from.
+                Data data = merged.next();
+                batchBytes += data.first.memUsageForSorter() + data.second.memUsageForSorter();
+                batch.emplace_back(data.first.getOwned(), data.second.getOwned());
+
+                if (batch.size() >= kMaxBatchSize || batchBytes >= kMaxBatchBytes) {
+                    if (!_handOver(std::move(batch)))
+                        return;
+                    batch = std::vector<Data>();
+                    batchBytes = 0;
+                }
+            }
 
-            // then compare fileNums to ensure stability
-            return lhs->fileNum > rhs->fileNum;
+            if (!batch.empty() && !_handOver(std::move(batch)))
+                return;
+        } catch (...) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _error = std::current_exception();
         }
 
-    private:
-        const Comparator _comp;
-    };
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _done = true;
+        }
+        _consumerCV.notify_one();
+    }
 
-    SortOptions _opts;
-    unsigned long long _remaining;
-    bool _first;
-    std::shared_ptr<Stream> _current;
-    std::vector<std::shared_ptr<Stream>> _heap;  // MinHeap
-    STLComparator _greater;                      // named so calls make sense
+    /** Returns false if this iterator was destroyed before the batch could be handed over. */
+    bool _handOver(std::vector<Data> batch) {
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _producerCV.wait(lk, [&] { return _batches.size() < kMaxQueuedBatches || _cancelled; });
+            if (_cancelled)
+                return false;
+            _batches.push_back(std::move(batch));
+        }
+        _consumerCV.notify_one();
+        return true;
+    }
+
+    // Only used by the consumer.
+    std::vector<Data> _batch;
+    size_t _position = 0;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _producerCV;
+    stdx::condition_variable _consumerCV;
+    std::deque<std::vector<Data>> _batches;
+    std::exception_ptr _error;
+    bool _done = false;
+    bool _cancelled = false;
+
+    stdx::thread _thread;  // Must be last, as it uses everything above.
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -429,6 +646,23 @@ public:
         verify(_opts.limit == 0);
     }
 
+    /// Starts out with the runs in 'fileNames', which are never removed by this Sorter.
+    NoLimitSorter(const std::vector<std::string>& fileNames,
+                  const SortOptions& opts,
+                  const Comparator& comp,
+                  const Settings& settings = Settings())
+        : NoLimitSorter(opts, comp, settings) {
+        verify(_opts.extSortAllowed);
+        for (const auto& fileName : fileNames) {
+            auto file = std::make_shared<FileDeleter>(fileName);
+            file->keep();
+            _iters.push_back(
+                std::make_shared<FileIterator<Key, Value>>(fileName, _settings, file));
+            _runFiles.push_back(file);
+        }
+        _numPersistedRuns = _runFiles.size();
+    }
+
     void add(const Key& key, const Value& val) {
         _data.push_back(std::make_pair(key, val));
 
@@ -449,6 +683,29 @@ public:
         return Iterator::merge(_iters, _opts, _comp);
     }
 
+    std::vector<std::string> persistDataForResume() {
+        spill();
+
+        // Runs from earlier calls have already been flushed.
+        for (; _numPersistedRuns < _runFiles.size(); _numPersistedRuns++) {
+            const auto& run = _runFiles[_numPersistedRuns];
+            File file;
+            file.open(run->fileName().c_str());
+            massert(40319,
+                    str::stream() << "error opening file \"" << run->fileName() << "\": "
+                                  << myErrnoWithDescription(),
+                    !file.bad());
+            file.fsync();
+            run->keep();
+        }
+
+        std::vector<std::string> fileNames;
+        for (const auto& run : _runFiles) {
+            fileNames.push_back(run->fileName());
+        }
+        return fileNames;
+    }
+
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
         return _iters.size();
@@ -503,6 +760,7 @@ private:
             writer.addAlreadySorted(_data.front().first, _data.front().second);
         }
 
+        _runFiles.push_back(writer.file());
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
 
         _memUsed = 0;
@@ -514,6 +772,10 @@ private:
     size_t _memUsed;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+
+    // The files behind '_iters'. The first '_numPersistedRuns' were flushed and are kept.
+    std::vector<std::shared_ptr<FileDeleter>> _runFiles;
+    size_t _numPersistedRuns = 0;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -559,6 +821,10 @@ public:
         return _best.first.memUsageForSorter() + _best.second.memUsageForSorter();
     }
 
+    std::vector<std::string> persistDataForResume() {
+        msgasserted(40320, "Only sorters without a limit can persist their data for resuming");
+    }
+
 private:
     const Comparator _comp;
     Data _best;
@@ -656,6 +922,10 @@ public:
         return _memUsed;
     }
 
+    std::vector<std::string> persistDataForResume() {
+        msgasserted(40321, "Only sorters without a limit can persist their data for resuming");
+    }
+
 private:
     class STLComparator {
     public:
@@ -823,7 +1093,7 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _compressor(opts.compressor) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -874,7 +1144,7 @@ void SortedFileWriter<Key, Value>::spill() {
         return;
 
     std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
+    sorter::compressBlock(_compressor, outBuffer, size, &compressed);
     verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
     const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
@@ -933,7 +1203,21 @@ SortIteratorInterface<Key, Value>* SortIteratorInterface<Key, Value>::merge(
     const std::vector<std::shared_ptr<SortIteratorInterface>>& iters,
     const SortOptions& opts,
     const Comparator& comp) {
-    return new sorter::MergeIterator<Key, Value, Comparator>(iters, opts, comp);
+    if (opts.mergeThreads <= 1 || iters.empty())
+        return new sorter::MergeIterator<Key, Value, Comparator>(iters, opts, comp);
+
+    // Each thread merges a contiguous range of the inputs, so ties still come out in input order.
+    const size_t numThreads = std::min(opts.mergeThreads, iters.size());
+    std::vector<std::shared_ptr<SortIteratorInterface>> partialMerges;
+    for (size_t i = 0; i < numThreads; i++) {
+        const std::vector<std::shared_ptr<SortIteratorInterface>> inputs(
+            iters.begin() + iters.size() * i / numThreads,
+            iters.begin() + iters.size() * (i + 1) / numThreads);
+        partialMerges.push_back(
+            std::make_shared<sorter::BackgroundMergeIterator<Key, Value, Comparator>>(
+                inputs, opts, comp));
+    }
+    return new sorter::MergeIterator<Key, Value, Comparator>(partialMerges, opts, comp);
 }
 
 template <typename Key, typename Value>
@@ -959,4 +1243,22 @@ Sorter<Key, Value>* Sorter<Key, Value>::make(const SortOptions& opts,
             return new sorter::TopKSorter<Key, Value, Comparator>(opts, comp, settings);
     }
 }
+
+template <typename Key, typename Value>
+template <typename Comparator>
+Sorter<Key, Value>* Sorter<Key, Value>::makeFromExistingRuns(
+    const std::vector<std::string>& fileNames,
+    const SortOptions& opts,
+    const Comparator& comp,
+    const Settings& settings) {
+    massert(40322,
+            "Attempting to resume an external sort from mongos. This is not allowed.",
+            !isMongos());
+
+    massert(40323,
+            "Resuming a sort requires external sorting with a limit of 0",
+            opts.extSortAllowed && opts.limit == 0 && !opts.tempDir.empty());
+
+    return new sorter::NoLimitSorter<Key, Value, Comparator>(fileNames, opts, comp, settings);
+}
 }
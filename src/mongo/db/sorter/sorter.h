@@ -93,13 +93,24 @@ class FileDeleter;
  * Runtime options that control the Sorter's behavior
  */
 struct SortOptions {
+    /// How data spilled to disk is compressed. Snappy is faster, zlib makes smaller files.
+    enum class Compressor { kSnappy, kZlib };
+
     unsigned long long limit;    /// number of KV pairs to be returned. 0 for no limit.
     size_t maxMemoryUsageBytes;  /// Approximate.
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
+    size_t mergeThreads;         /// Threads merging, and reading ahead, subsets of the inputs
+                                 /// of a merge. 1 merges everything on the calling thread.
+    Compressor compressor;       /// Used for blocks written to disk.
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          mergeThreads(1),
+          compressor(Compressor::kSnappy) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -122,6 +133,16 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& MergeThreads(size_t newMergeThreads) {
+        mergeThreads = newMergeThreads;
+        return *this;
+    }
+
+    SortOptions& SpillCompressor(Compressor newCompressor) {
+        compressor = newCompressor;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -167,9 +188,28 @@ public:
                         const Comparator& comp,
                         const Settings& settings = Settings());
 
+    /**
+     * Makes a Sorter without a limit that starts out holding the runs an earlier Sorter wrote to
+     * 'fileNames' in persistDataForResume(). 'opts' must allow external sorting. The files are
+     * left in place; removing them is up to the caller.
+     */
+    template <typename Comparator>
+    static Sorter* makeFromExistingRuns(const std::vector<std::string>& fileNames,
+                                        const SortOptions& opts,
+                                        const Comparator& comp,
+                                        const Settings& settings = Settings());
+
     virtual void add(const Key&, const Value&) = 0;
     virtual Iterator* done() = 0;  /// Can't add more data after calling done()
 
+    /**
+     * Writes everything added so far to disk, flushes it to stable storage and returns the names
+     * of the files holding it, each a sorted run. The Sorter no longer removes these files, so
+     * they survive a restart and can be passed to makeFromExistingRuns(). More data may be added
+     * afterwards. Only supported without a limit.
+     */
+    virtual std::vector<std::string> persistDataForResume() = 0;
+
     virtual ~Sorter() {}
 
     // TEMP these are here for compatibility. Will be replaced with a general stats API
@@ -196,10 +236,16 @@ public:
     void addAlreadySorted(const Key&, const Value&);
     Iterator* done();  /// Can't add more data after calling done()
 
+    /// The file being written. It is removed once this and all Iterators over it are gone.
+    std::shared_ptr<sorter::FileDeleter> file() const {
+        return _fileDeleter;
+    }
+
 private:
     void spill();
 
     const Settings _settings;
+    const SortOptions::Compressor _compressor;
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
@@ -221,6 +267,7 @@ private:
     template class ::mongo::sorter::LimitOneSorter<Key, Value, Comparator>;              \
     template class ::mongo::sorter::TopKSorter<Key, Value, Comparator>;                  \
     template class ::mongo::sorter::MergeIterator<Key, Value, Comparator>;               \
+    template class ::mongo::sorter::BackgroundMergeIterator<Key, Value, Comparator>;     \
     template class ::mongo::sorter::InMemIterator<Key, Value>;                           \
     template class ::mongo::sorter::FileIterator<Key, Value>;                            \
     /* factory functions */                                                              \
@@ -230,4 +277,10 @@ private:
             const SortOptions& opts,                                                     \
             const Comparator& comp);                                                     \
     template ::mongo::Sorter<Key, Value>* ::mongo::Sorter<Key, Value>::make<Comparator>( \
-        const SortOptions& opts, const Comparator& comp, const Settings& settings);
+        const SortOptions& opts, const Comparator& comp, const Settings& settings);     \
+    template ::mongo::Sorter<Key, Value>*                                                \
+    ::mongo::Sorter<Key, Value>::makeFromExistingRuns<Comparator>(                       \
+        const std::vector<std::string>& fileNames,                                       \
+        const SortOptions& opts,                                                         \
+        const Comparator& comp,                                                          \
+        const Settings& settings);
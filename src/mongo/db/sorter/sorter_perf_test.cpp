@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Throughput of the external sorter's spill and merge phases. Each case logs a THROUGHPUT line;
+ * the assertions only check that the output is sorted and complete.
+ *
+ * This is too slow to run with the unit tests, so it is built as a standalone program that is
+ * only run by hand.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter.h"
+
+#include <boost/filesystem.hpp>
+#include <memory>
+#include <random>
+
+#include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+// Stub to avoid including the server_options library.
+bool isMongos() {
+    return false;
+}
+
+// Stub to avoid including the server environment library.
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
+    return Status::OK();
+}
+
+namespace {
+
+using KeySorter = Sorter<BSONObj, RecordId>;
+
+// Compares index-style keys; ties are broken by RecordId, as in an index build.
+class KeyComparator {
+public:
+    int operator()(const KeySorter::Data& lhs, const KeySorter::Data& rhs) const {
+        const int cmp = lhs.first.woCompare(rhs.first, BSONObj(), false);
+        if (cmp != 0)
+            return cmp;
+        return lhs.second.compare(rhs.second);
+    }
+};
+
+const int kNumKeys = 1000 * 1000;
+
+// Small enough that the sort spills a few hundred runs.
+const size_t kMaxMemoryUsageBytes = 512 * 1024;
+
+std::vector<BSONObj> makeKeys() {
+    std::vector<BSONObj> keys;
+    keys.reserve(kNumKeys);
+    std::mt19937 gen(1234);
+    for (int i = 0; i < kNumKeys; i++) {
+        const int value = gen() % (kNumKeys / 4);
+        keys.push_back(BSON("" << value << ""
+                               << "user" + std::to_string(value % 1000)));
+    }
+    return keys;
+}
+
+long long directorySizeBytes(const std::string& path) {
+    long long size = 0;
+    for (boost::filesystem::directory_iterator it(path), end; it != end; ++it) {
+        size += boost::filesystem::file_size(it->path());
+    }
+    return size;
+}
+
+/**
+ * Sorts kNumKeys keys with the given options and logs the spill and merge rates, plus the size
+ * of the spilled runs.
+ */
+void runSort(const std::string& description, SortOptions opts) {
+    static const std::vector<BSONObj> keys = makeKeys();
+
+    unittest::TempDir tempDir("sorterPerfTest");
+    opts.TempDir(tempDir.path()).ExtSortAllowed().MaxMemoryUsageBytes(kMaxMemoryUsageBytes);
+    std::unique_ptr<KeySorter> sorter(KeySorter::make(opts, KeyComparator()));
+
+    Timer spillTimer;
+    for (int i = 0; i < kNumKeys; i++) {
+        sorter->add(keys[i], RecordId(i + 1));
+    }
+    std::unique_ptr<KeySorter::Iterator> it(sorter->done());
+    const double spillSecs = spillTimer.micros() / 1000000.0;
+    const long long spilledBytes = directorySizeBytes(tempDir.path());
+
+    Timer mergeTimer;
+    int count = 0;
+    BSONObj last;
+    while (it->more()) {
+        KeySorter::Data data = it->next();
+        if (count > 0) {
+            ASSERT_LTE(last.woCompare(data.first, BSONObj(), false), 0);
+        }
+        last = data.first.getOwned();
+        count++;
+    }
+    const double mergeSecs = mergeTimer.micros() / 1000000.0;
+    ASSERT_EQ(kNumKeys, count);
+
+    log() << "THROUGHPUT sorter " << description << ": spill keys/s: " << kNumKeys / spillSecs
+          << ", merge keys/s: " << kNumKeys / mergeSecs << ", runs: " << sorter->numFiles()
+          << ", spilled bytes: " << spilledBytes;
+}
+
+TEST(SorterPerf, MergeByThreadCount) {
+    for (size_t threads : {1, 2, 4, 8}) {
+        runSort(str::stream() << "with " << threads << " merge thread(s)",
+                SortOptions().MergeThreads(threads));
+    }
+}
+
+TEST(SorterPerf, SpillByCompressor) {
+    runSort("with snappy spills", SortOptions().SpillCompressor(SortOptions::Compressor::kSnappy));
+    runSort("with zlib spills", SortOptions().SpillCompressor(SortOptions::Compressor::kZlib));
+}
+
+}  // namespace
+}  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+MONGO_CREATE_SORTER(mongo::BSONObj, mongo::RecordId, mongo::KeyComparator);
@@ -274,6 +274,15 @@ public:
             ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
                                         make_shared<IntIterator>(0, 10 * 1000 * 1000));
         }
+        {  // big, zlib
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(
+                SortOptions(opts).SpillCompressor(SortOptions::Compressor::kZlib));
+            for (int i = 0; i < 1000 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                        make_shared<IntIterator>(0, 1000 * 1000));
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
@@ -333,6 +342,31 @@ public:
                 mergeIterators(iterators, ASC, SortOptions().Limit(10)),
                 make_shared<LimitIterator>(10, make_shared<IntIterator>(0, 20, 1)));
         }
+        {  // test parallel merge, with more threads than some subsets have inputs
+            std::shared_ptr<IWIterator> iterators[] = {
+                make_shared<IntIterator>(0, 1000, 5),  // 0, 5, ... 995
+                make_shared<IntIterator>(1, 1000, 5),  // 1, 6, ... 996
+                make_shared<IntIterator>(2, 1000, 5),  // 2, 7, ... 997
+                make_shared<EmptyIterator>(),
+                make_shared<IntIterator>(3, 1000, 5),  // 3, 8, ... 998
+                make_shared<IntIterator>(4, 1000, 5),  // 4, 9, ... 999
+            };
+
+            ASSERT_ITERATORS_EQUIVALENT(
+                mergeIterators(iterators, ASC, SortOptions().MergeThreads(4)),
+                make_shared<IntIterator>(0, 1000, 1));
+        }
+        {  // test parallel merge with a limit
+            std::shared_ptr<IWIterator> iterators[] = {
+                make_shared<IntIterator>(30, 0, -3),  // 30, 27, ... 3
+                make_shared<IntIterator>(29, 0, -3),  // 29, 26, ... 2
+                make_shared<IntIterator>(28, 0, -3),  // 28, 25, ... 1
+            };
+
+            ASSERT_ITERATORS_EQUIVALENT(
+                mergeIterators(iterators, DESC, SortOptions().MergeThreads(2).Limit(10)),
+                make_shared<LimitIterator>(10, make_shared<IntIterator>(30, 0, -1)));
+        }
     }
 };
 
@@ -521,6 +555,17 @@ public:
 };
 
 
+// Spills with zlib and merges the spilled runs on several threads.
+template <size_t MergeThreads, bool Random = true>
+class LotsOfDataParallelMerge : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return Parent::adjustSortOptions(opts)
+            .MergeThreads(MergeThreads)
+            .SpillCompressor(SortOptions::Compressor::kZlib);
+    }
+};
+
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     typedef LotsOfDataLittleMemory<Random> Parent;
@@ -544,6 +589,63 @@ class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     }
     enum { MEM_LIMIT = 32 * 1024 };
 };
+
+class PersistDataForResume {
+public:
+    void run() {
+        unittest::TempDir tempDir("sorterPersistDataForResumeTests");
+        const SortOptions opts =
+            SortOptions().TempDir(tempDir.path()).MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed();
+
+        std::vector<std::string> fileNames;
+        {
+            std::unique_ptr<IWSorter> sorter(IWSorter::make(opts, IWComparator(ASC)));
+            for (int i = 0; i < NUM_ITEMS; i += 2)
+                sorter->add(i, -i);
+            fileNames = sorter->persistDataForResume();
+            ASSERT_GREATER_THAN(fileNames.size(), 1U);
+
+            // Runs spilled after persisting are still removed with the sorter.
+            for (int i = 1; i < NUM_ITEMS; i += 2)
+                sorter->add(i, -i);
+            ASSERT_GREATER_THAN(static_cast<size_t>(sorter->numFiles()), fileNames.size());
+        }
+        ASSERT_EQUALS(numFilesIn(tempDir.path()), fileNames.size());
+
+        {
+            std::unique_ptr<IWSorter> sorter(
+                IWSorter::makeFromExistingRuns(fileNames, opts, IWComparator(ASC)));
+            for (int i = 1; i < NUM_ITEMS; i += 2)
+                sorter->add(i, -i);
+
+            const std::vector<std::string> allFileNames = sorter->persistDataForResume();
+            ASSERT_GREATER_THAN(allFileNames.size(), fileNames.size());
+            ASSERT(std::equal(fileNames.begin(), fileNames.end(), allFileNames.begin()));
+            fileNames = allFileNames;
+
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter->done()),
+                                        make_shared<IntIterator>(0, NUM_ITEMS));
+        }
+
+        // Persisted runs are left for the caller to remove, even once they have been read back.
+        ASSERT_EQUALS(numFilesIn(tempDir.path()), fileNames.size());
+
+        std::unique_ptr<IWSorter> limited(
+            IWSorter::make(SortOptions(opts).Limit(10), IWComparator(ASC)));
+        ASSERT_THROWS(limited->persistDataForResume(), DBException);
+    }
+
+private:
+    static size_t numFilesIn(const std::string& path) {
+        return std::distance(boost::filesystem::directory_iterator(path),
+                             boost::filesystem::directory_iterator());
+    }
+
+    enum Constants {
+        NUM_ITEMS = 100 * 1000,
+        MEM_LIMIT = 64 * 1024,
+    };
+};
 }
 
 class SorterSuite : public mongo::unittest::Suite {
@@ -559,12 +661,15 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataParallelMerge<2, /*random=*/false>>();
+        add<SorterTests::LotsOfDataParallelMerge<4, /*random=*/true>>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/true>>();    // fits in mem
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/false>>();  // spills
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/true>>();   // spills
+        add<SorterTests::PersistDataForResume>();
     }
 };
 
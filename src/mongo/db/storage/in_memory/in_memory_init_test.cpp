@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/in_memory/in_memory_global_options.h"
+#include "mongo/db/storage/storage_engine_metadata.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+class InMemoryFactoryTest : public mongo::unittest::Test {
+private:
+    virtual void setUp() {
+        ServiceContext* globalEnv = getGlobalServiceContext();
+        ASSERT_TRUE(globalEnv);
+        ASSERT_TRUE(getGlobalServiceContext()->isRegisteredStorageEngine(kInMemoryEngineName));
+        std::unique_ptr<StorageFactoriesIterator> sfi(
+            getGlobalServiceContext()->makeStorageFactoriesIterator());
+        ASSERT_TRUE(sfi);
+        bool found = false;
+        while (sfi->more()) {
+            const StorageEngine::Factory* currentFactory = sfi->next();
+            if (currentFactory->getCanonicalName() == kInMemoryEngineName) {
+                found = true;
+                factory = currentFactory;
+                break;
+            }
+        }
+        ASSERT_TRUE(found);
+    }
+
+    virtual void tearDown() {
+        factory = NULL;
+    }
+
+protected:
+    const StorageEngine::Factory* factory;
+};
+
+// Nothing persists across restarts, so the options recorded by a previous run never conflict.
+TEST_F(InMemoryFactoryTest, ValidateMetadataAcceptsAnyOptions) {
+    // It is fine to specify an invalid data directory for the metadata
+    // as long as we do not invoke read() or write().
+    StorageEngineMetadata metadata("no_such_directory");
+    metadata.setStorageEngineOptions(fromjson("{directoryPerDB: true}"));
+
+    StorageGlobalParams storageOptions;
+    storageOptions.directoryperdb = false;
+    ASSERT_OK(factory->validateMetadata(metadata, storageOptions));
+}
+
+TEST_F(InMemoryFactoryTest, CreateMetadataOptionsIsEmpty) {
+    StorageGlobalParams storageOptions;
+    storageOptions.directoryperdb = true;
+    ASSERT_TRUE(factory->createMetadataOptions(storageOptions).isEmpty());
+}
+
+TEST_F(InMemoryFactoryTest, ValidateCollectionStorageOptions) {
+    ASSERT_OK(
+        factory->validateCollectionStorageOptions(fromjson("{configString: 'split_pct=88'}")));
+    ASSERT_NOT_OK(factory->validateCollectionStorageOptions(fromjson("{unknownField: 1}")));
+}
+
+}  // namespace
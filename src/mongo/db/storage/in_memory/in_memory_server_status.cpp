@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/in_memory/in_memory_server_status.h"
+
+#include <wiredtiger.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/in_memory/in_memory_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+void appendStatistic(BSONObjBuilder* bob, WT_SESSION* s, const char* name, int statisticsKey) {
+    auto value = WiredTigerUtil::getStatisticsValueAs<long long>(
+        s, "statistics:", "statistics=(fast)", statisticsKey);
+    if (value.isOK()) {
+        bob->append(name, value.getValue());
+    }
+}
+
+}  // namespace
+
+InMemoryServerStatusSection::InMemoryServerStatusSection(WiredTigerKVEngine* engine)
+    : ServerStatusSection(kInMemoryEngineName), _engine(engine) {}
+
+bool InMemoryServerStatusSection::includeByDefault() const {
+    return true;
+}
+
+BSONObj InMemoryServerStatusSection::generateSection(OperationContext* txn,
+                                                     const BSONElement& configElement) const {
+    // As with the "wiredTiger" section, do not open a transaction just to read statistics.
+    WiredTigerSession* session = WiredTigerRecoveryUnit::get(txn)->getSessionNoTxn(txn);
+    invariant(session);
+
+    WT_SESSION* s = session->getSession();
+    invariant(s);
+
+    BSONObjBuilder bob;
+    appendStatistic(&bob, s, "maximumBytesConfigured", WT_STAT_CONN_CACHE_BYTES_MAX);
+    appendStatistic(&bob, s, "bytesInUse", WT_STAT_CONN_CACHE_BYTES_INUSE);
+    appendStatistic(&bob, s, "dirtyBytes", WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    appendStatistic(&bob, s, "pagesEvicted", WT_STAT_CONN_CACHE_EVICTION_CLEAN);
+    appendStatistic(&bob, s, "modifiedPagesEvicted", WT_STAT_CONN_CACHE_EVICTION_DIRTY);
+    appendStatistic(&bob, s, "pagesEvictedByApplicationThreads", WT_STAT_CONN_CACHE_EVICTION_APP);
+    appendStatistic(&bob, s, "evictionFailures", WT_STAT_CONN_CACHE_EVICTION_FAIL);
+    bob.append("writesRejectedMemoryFull",
+               static_cast<long long>(WiredTigerUtil::getCacheFullErrorCount()));
+
+    return bob.obj();
+}
+
+}  // namespace mongo
@@ -38,7 +38,9 @@
 #include <type_traits>
 
 #include "mongo/base/data_view.h"
+#include "mongo/db/fts/unicode/byte_vector.h"
 #include "mongo/platform/bits.h"
+#include "mongo/platform/endian.h"
 #include "mongo/platform/strnlen.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
@@ -229,10 +231,30 @@ const uint8_t kGreater = 254;
 
 // some utility functions
 namespace {
+/**
+ * Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. Descending fields are stored
+ * inverted, so this runs over every byte of them on both encode and decode. 'dst' may equal 'src'.
+ */
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    using unicode::ByteVector;
+    const ByteVector allOnes(-1);
+    for (; end - input >= ByteVector::size; input += ByteVector::size, output += ByteVector::size) {
+        (ByteVector::load(input) ^ allOnes).store(output);
+    }
+#endif
+
+    for (; end - input >= 8; input += 8, output += 8) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+    }
+
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -284,10 +306,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     invariant(end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -314,10 +334,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
-
+    memcpy_flipBits(&out[0], out.data(), out.size());
     return out;
 }
 }  // namespace
@@ -333,6 +350,14 @@ void KeyString::resetToKey(const BSONObj& obj, Ordering ord, Discriminator discr
     _appendAllElementsForIndexing(obj, ord, discriminator);
 }
 
+void KeyString::resetToKey(const BSONElement* elements, size_t numElements, Ordering ord) {
+    resetToEmpty();
+    for (size_t i = 0; i < numElements; i++) {
+        _appendBsonValue(elements[i], ord.get(i) == -1, NULL);
+    }
+    _append(kEnd, false);
+}
+
 // ----------------------------------------------------------------------
 // -----------   APPEND CODE  -------------------------------------------
 // ----------------------------------------------------------------------
@@ -1847,17 +1872,32 @@ void KeyString::TypeBits::appendDecimalExponent(uint8_t storedExponentBits) {
         appendBit((storedExponentBits >> bitPos) & 1);
 }
 
-uint8_t KeyString::TypeBits::Reader::readBit() {
+uint32_t KeyString::TypeBits::Reader::readBits(uint8_t numBits) {
+    dassert(numBits > 0 && numBits <= 24);
     if (_typeBits._isAllZeros)
         return 0;
 
     const uint8_t byte = (_curBit / 8) + 1;
     const uint8_t offsetInByte = _curBit % 8;
-    _curBit++;
-
-    dassert(byte <= _typeBits.getSizeByte());
-
-    return (_typeBits._buf[byte] & (1 << offsetInByte)) ? 1 : 0;
+    _curBit += numBits;
+
+    const size_t bytesUsed = _typeBits.getSizeByte() + 1;
+    dassert((_curBit + 7) / 8 < bytesUsed);
+
+    // Bits are appended starting from the least significant bit of each byte, so one
+    // little-endian load brings all of the requested bits into reading order.
+    uint32_t window = 0;
+    memcpy(&window, _typeBits._buf + byte, std::min(sizeof(window), bytesUsed - byte));
+    window = endian::littleToNative(window) >> offsetInByte;
+
+    // The first bit read is the most significant bit of the result, so reverse the window and
+    // keep its top 'numBits' bits.
+    window = ((window >> 1) & 0x55555555) | ((window & 0x55555555) << 1);
+    window = ((window >> 2) & 0x33333333) | ((window & 0x33333333) << 2);
+    window = ((window >> 4) & 0x0F0F0F0F) | ((window & 0x0F0F0F0F) << 4);
+    window = ((window >> 8) & 0x00FF00FF) | ((window & 0x00FF00FF) << 8);
+    window = (window >> 16) | (window << 16);
+    return window >> (32 - numBits);
 }
 
 uint8_t KeyString::TypeBits::Reader::readZero() {
@@ -1865,9 +1905,7 @@ uint8_t KeyString::TypeBits::Reader::readZero() {
 
     // For keyString v1, negative and decimal zeros require at least 3 more bits.
     if (_typeBits.version != Version::V0 && res == kSpecialZeroPrefix) {
-        res = (res << 1) | readBit();
-        res = (res << 1) | readBit();
-        res = (res << 1) | readBit();
+        res = (res << 3) | readBits(3);
     }
     if (res == kV1NegativeDoubleZero || res == kV0NegativeDoubleZero)
         res = kNegativeDoubleZero;
@@ -1875,17 +1913,11 @@ uint8_t KeyString::TypeBits::Reader::readZero() {
 }
 
 uint32_t KeyString::TypeBits::Reader::readDecimalZero(uint8_t zeroType) {
-    uint32_t whichZero = zeroType - TypeBits::kDecimalZero0xxx;
-    for (int bitPos = 11; bitPos >= 0; bitPos--)
-        whichZero = (whichZero << 1) | readBit();
-
-    return whichZero;
+    const uint32_t zeroPrefix = zeroType - TypeBits::kDecimalZero0xxx;
+    return (zeroPrefix << 12) | readBits(12);
 }
 
 uint8_t KeyString::TypeBits::Reader::readDecimalExponent() {
-    uint8_t exponentBits = 0;
-    for (int bitPos = kStoredDecimalExponentBits - 1; bitPos >= 0; bitPos--)
-        exponentBits = (exponentBits << 1) | readBit();
-    return exponentBits;
+    return readBits(kStoredDecimalExponentBits);
 }
 }  // namespace mongo
@@ -209,11 +209,10 @@ public:
             explicit Reader(const TypeBits& typeBits) : _curBit(0), _typeBits(typeBits) {}
 
             uint8_t readStringLike() {
-                return readBit();
+                return readBits(1);
             }
             uint8_t readNumeric() {
-                uint8_t highBit = readBit();
-                return (highBit << 1) | readBit();
+                return readBits(2);
             }
             uint8_t readZero();
 
@@ -225,7 +224,11 @@ public:
             uint8_t readDecimalExponent();
 
         private:
-            uint8_t readBit();
+            /**
+             * Reads the next 'numBits' bits, from 1 to 24. The first bit read becomes the most
+             * significant bit of the result.
+             */
+            uint32_t readBits(uint8_t numBits);
 
             size_t _curBit;
             const TypeBits& _typeBits;
@@ -319,6 +322,14 @@ public:
 
     void resetToKey(const BSONObj& obj, Ordering ord, RecordId recordId);
     void resetToKey(const BSONObj& obj, Ordering ord, Discriminator discriminator = kInclusive);
+
+    /**
+     * Resets to the key whose values are 'elements', in key pattern order. Produces the same
+     * KeyString as resetToKey() on an object holding those values under empty field names, without
+     * building that object. The elements' own field names are ignored.
+     */
+    void resetToKey(const BSONElement* elements, size_t numElements, Ordering ord);
+
     void resetFromBuffer(const void* buffer, size_t size) {
         _buffer.reset();
         memcpy(_buffer.skip(size), buffer, size);
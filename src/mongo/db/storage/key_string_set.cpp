@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/key_string_set.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mongo {
+
+namespace {
+
+int compareBytes(const char* left, size_t leftSize, const char* right, size_t rightSize) {
+    const int cmp = memcmp(left, right, std::min(leftSize, rightSize));
+    if (cmp != 0)
+        return cmp;
+    if (leftSize == rightSize)
+        return 0;
+    return leftSize < rightSize ? -1 : 1;
+}
+
+int compareKeys(const KeyStringSet::Key& left, const KeyStringSet::Key& right) {
+    return compareBytes(left.getBuffer(), left.getSize(), right.getBuffer(), right.getSize());
+}
+
+bool typeBitsEqual(const KeyString::TypeBits& left, const KeyString::TypeBits& right) {
+    return compareBytes(left.getBuffer(), left.getSize(), right.getBuffer(), right.getSize()) == 0;
+}
+
+}  // namespace
+
+BSONObj KeyStringSet::Key::toBson() const {
+    return KeyString::toBson(getBuffer(), getSize(), _set->_ordering, getTypeBits());
+}
+
+KeyStringSet::KeyStringSet(KeyString::Version version, Ordering ordering)
+    : _ordering(ordering), _scratch(version) {}
+
+void KeyStringSet::add(const BSONObj& key) {
+    _scratch.resetToKey(key, _ordering);
+    _addScratch(key.objsize());
+}
+
+void KeyStringSet::add(const BSONElement* elements, size_t numElements) {
+    _scratch.resetToKey(elements, numElements, _ordering);
+
+    // The key as a BSONObj would hold each value under an empty field name, plus the object's
+    // size prefix and terminating byte.
+    int bsonSize = 4 + 1;
+    for (size_t i = 0; i < numElements; i++) {
+        bsonSize += elements[i].size() - elements[i].fieldNameSize() + 1;
+    }
+    _addScratch(bsonSize);
+}
+
+void KeyStringSet::_addScratch(int bsonSize) {
+    const char* const data = _scratch.getBuffer();
+    const size_t size = _scratch.getSize();
+
+    // Documents rarely have more than a handful of keys, so a binary search and insert into
+    // '_sorted' is cheaper than a node-based set.
+    const auto pos = std::lower_bound(
+        _sorted.begin(), _sorted.end(), 0, [&](size_t entryIndex, int) {
+            const Entry& entry = _entries[entryIndex];
+            return compareBytes(_buffer.buf() + entry.offset, entry.size, data, size) < 0;
+        });
+    if (pos != _sorted.end()) {
+        const Entry& entry = _entries[*pos];
+        if (compareBytes(_buffer.buf() + entry.offset, entry.size, data, size) == 0) {
+            return;
+        }
+    }
+
+    const size_t offset = _buffer.len();
+    memcpy(_buffer.skip(size), data, size);
+    _sorted.insert(pos, _entries.size());
+    _entries.emplace_back(offset, size, bsonSize, _scratch.getTypeBits());
+}
+
+void KeyStringSet::clear() {
+    _buffer.reset();
+    _entries.clear();
+    _sorted.clear();
+}
+
+std::pair<std::vector<KeyStringSet::Key>, std::vector<KeyStringSet::Key>> KeyStringSet::difference(
+    const KeyStringSet& left, const KeyStringSet& right) {
+    std::vector<Key> onlyLeft;
+    std::vector<Key> onlyRight;
+
+    size_t leftIndex = 0;
+    size_t rightIndex = 0;
+    while (leftIndex < left.size() && rightIndex < right.size()) {
+        const Key leftKey = left[leftIndex];
+        const Key rightKey = right[rightIndex];
+        const int cmp = compareKeys(leftKey, rightKey);
+        if (cmp == 0) {
+            if (!typeBitsEqual(leftKey.getTypeBits(), rightKey.getTypeBits())) {
+                onlyLeft.push_back(leftKey);
+                onlyRight.push_back(rightKey);
+            }
+            ++leftIndex;
+            ++rightIndex;
+        } else if (cmp > 0) {
+            onlyRight.push_back(rightKey);
+            ++rightIndex;
+        } else {
+            onlyLeft.push_back(leftKey);
+            ++leftIndex;
+        }
+    }
+
+    for (; leftIndex < left.size(); ++leftIndex) {
+        onlyLeft.push_back(left[leftIndex]);
+    }
+    for (; rightIndex < right.size(); ++rightIndex) {
+        onlyRight.push_back(right[rightIndex]);
+    }
+
+    return {std::move(onlyLeft), std::move(onlyRight)};
+}
+
+}  // namespace mongo
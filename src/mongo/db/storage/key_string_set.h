@@ -0,0 +1,201 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo {
+
+/**
+ * The distinct index keys of one document, encoded as KeyStrings (without RecordIds) into a single
+ * buffer. Keys are deduplicated by comparing their encoded bytes, which treats keys the same way
+ * as the index does, and are kept in index order.
+ *
+ * This lets the write path encode each key once, rather than building a BSONObj per key in a
+ * BSONObjSet and having the storage engine encode it again.
+ */
+class KeyStringSet {
+    MONGO_DISALLOW_COPYING(KeyStringSet);
+
+    struct Entry;
+
+public:
+    /**
+     * One key of a KeyStringSet. It points into the set, so it is only valid until the set is
+     * next modified or destroyed.
+     */
+    class Key {
+    public:
+        const char* getBuffer() const {
+            return _set->_buffer.buf() + _entry->offset;
+        }
+
+        size_t getSize() const {
+            return _entry->size;
+        }
+
+        const KeyString::TypeBits& getTypeBits() const {
+            return _entry->typeBits;
+        }
+
+        /**
+         * The objsize() that this key has as a BSONObj, which index key size limits are defined
+         * in terms of.
+         */
+        int getBSONSize() const {
+            return _entry->bsonSize;
+        }
+
+        /**
+         * Decodes the key. Meant for error messages and logging.
+         */
+        BSONObj toBson() const;
+
+    private:
+        friend class KeyStringSet;
+
+        Key(const KeyStringSet* set, const Entry* entry) : _set(set), _entry(entry) {}
+
+        const KeyStringSet* _set;
+        const Entry* _entry;
+    };
+
+    /**
+     * Visits the keys of a KeyStringSet in index order.
+     */
+    class const_iterator {
+    public:
+        Key operator*() const {
+            return (*_set)[_i];
+        }
+
+        const_iterator& operator++() {
+            ++_i;
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _i == other._i;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return _i != other._i;
+        }
+
+    private:
+        friend class KeyStringSet;
+
+        const_iterator(const KeyStringSet* set, size_t i) : _set(set), _i(i) {}
+
+        const KeyStringSet* _set;
+        size_t _i;
+    };
+
+    KeyStringSet(KeyString::Version version, Ordering ordering);
+
+    /**
+     * Adds the key 'key', whose field names must be empty, unless an equal key is already present.
+     */
+    void add(const BSONObj& key);
+
+    /**
+     * Adds the key whose values are 'elements', in key pattern order, unless an equal key is
+     * already present. The elements' field names are ignored.
+     */
+    void add(const BSONElement* elements, size_t numElements);
+
+    /**
+     * Removes all keys but keeps the memory allocated for them.
+     */
+    void clear();
+
+    bool empty() const {
+        return _sorted.empty();
+    }
+
+    size_t size() const {
+        return _sorted.size();
+    }
+
+    /**
+     * Returns the i-th key in index order.
+     */
+    Key operator[](size_t i) const {
+        return Key(this, &_entries[_sorted[i]]);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, size());
+    }
+
+    /**
+     * Splits 'left' and 'right' into the keys only in 'left' and the keys only in 'right'. Keys
+     * that encode equal but have different TypeBits count as different, since the index entry
+     * for them must be rewritten.
+     */
+    static std::pair<std::vector<Key>, std::vector<Key>> difference(const KeyStringSet& left,
+                                                                    const KeyStringSet& right);
+
+private:
+    struct Entry {
+        Entry(size_t offset, size_t size, int bsonSize, const KeyString::TypeBits& typeBits)
+            : offset(offset), size(size), bsonSize(bsonSize), typeBits(typeBits) {}
+
+        size_t offset;
+        size_t size;
+        int bsonSize;
+        KeyString::TypeBits typeBits;
+    };
+
+    /**
+     * Adds the key in '_scratch' unless an equal key is already present.
+     */
+    void _addScratch(int bsonSize);
+
+    const Ordering _ordering;
+
+    // Each key is encoded here first, so that a duplicate is never copied into '_buffer'.
+    KeyString _scratch;
+
+    StackBufBuilder _buffer;
+    std::vector<Entry> _entries;  // In the order they were added.
+    std::vector<size_t> _sorted;  // Indexes into '_entries', in index order.
+};
+
+}  // namespace mongo
@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/key_string_set.h"
+
+#include <cstring>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kAscending = Ordering::make(BSON("a" << 1 << "b" << 1));
+const Ordering kDescending = Ordering::make(BSON("a" << -1 << "b" << 1));
+
+bool keyEquals(const KeyStringSet::Key& key, const KeyString& expected) {
+    return key.getSize() == expected.getSize() &&
+        memcmp(key.getBuffer(), expected.getBuffer(), key.getSize()) == 0;
+}
+
+TEST(KeyStringSetTest, KeysAreKeptInIndexOrder) {
+    for (auto ordering : {kAscending, kDescending}) {
+        KeyStringSet set(KeyString::Version::V1, ordering);
+        set.add(BSON("" << 3 << "" << "x"));
+        set.add(BSON("" << 1 << "" << "y"));
+        set.add(BSON("" << 2 << "" << "z"));
+        ASSERT_EQ(3U, set.size());
+
+        for (size_t i = 1; i < set.size(); ++i) {
+            const KeyString previous(KeyString::Version::V1, set[i - 1].toBson(), ordering);
+            const KeyString current(KeyString::Version::V1, set[i].toBson(), ordering);
+            ASSERT_LT(previous.compare(current), 0);
+        }
+    }
+}
+
+TEST(KeyStringSetTest, IteratesInIndexOrder) {
+    KeyStringSet set(KeyString::Version::V1, kDescending);
+    ASSERT(set.begin() == set.end());
+
+    set.add(BSON("" << 1 << "" << "x"));
+    set.add(BSON("" << 3 << "" << "y"));
+    set.add(BSON("" << 2 << "" << "z"));
+
+    size_t i = 0;
+    for (auto key : set) {
+        ASSERT_LT(i, set.size());
+        ASSERT_BSONOBJ_EQ(set[i].toBson(), key.toBson());
+        ++i;
+    }
+    ASSERT_EQ(3U, i);
+}
+
+TEST(KeyStringSetTest, DuplicateKeysAreAddedOnce) {
+    KeyStringSet set(KeyString::Version::V1, kAscending);
+    set.add(BSON("" << 1 << "" << 2));
+    set.add(BSON("" << 1 << "" << 2));
+    ASSERT_EQ(1U, set.size());
+
+    // Numerically equal values encode to the same key, so only the first one is kept.
+    set.add(BSON("" << 1.0 << "" << 2LL));
+    ASSERT_EQ(1U, set.size());
+    ASSERT_BSONOBJ_EQ(BSON("" << 1 << "" << 2), set[0].toBson());
+    ASSERT_EQ(BSONType::NumberInt, set[0].toBson().firstElement().type());
+}
+
+TEST(KeyStringSetTest, ElementsEncodeLikeAnObject) {
+    const BSONObj doc = BSON("a" << 5.5 << "b" << BSON("c" << "str"));
+    const BSONElement elements[] = {doc["a"], doc["b"]};
+
+    KeyStringSet set(KeyString::Version::V1, kDescending);
+    set.add(elements, 2);
+    ASSERT_EQ(1U, set.size());
+
+    const BSONObj key = BSON("" << 5.5 << "" << BSON("c" << "str"));
+    const KeyString expected(KeyString::Version::V1, key, kDescending);
+    ASSERT(keyEquals(set[0], expected));
+    ASSERT_EQ(key.objsize(), set[0].getBSONSize());
+    ASSERT_BSONOBJ_EQ(key, set[0].toBson());
+
+    set.add(key);
+    ASSERT_EQ(1U, set.size());
+}
+
+TEST(KeyStringSetTest, ClearRemovesAllKeys) {
+    KeyStringSet set(KeyString::Version::V1, kAscending);
+    set.add(BSON("" << 1 << "" << 1));
+    set.clear();
+    ASSERT(set.empty());
+
+    set.add(BSON("" << 2 << "" << 2));
+    ASSERT_EQ(1U, set.size());
+    ASSERT_BSONOBJ_EQ(BSON("" << 2 << "" << 2), set[0].toBson());
+}
+
+TEST(KeyStringSetTest, Difference) {
+    KeyStringSet left(KeyString::Version::V1, kAscending);
+    left.add(BSON("" << 1 << "" << 1));
+    left.add(BSON("" << 2 << "" << 2));
+    left.add(BSON("" << 3 << "" << 3));
+
+    KeyStringSet right(KeyString::Version::V1, kAscending);
+    right.add(BSON("" << 2 << "" << 2));
+    right.add(BSON("" << 3.0 << "" << 3));
+    right.add(BSON("" << 4 << "" << 4));
+
+    const auto difference = KeyStringSet::difference(left, right);
+
+    // {3, 3} and {3.0, 3} encode to the same key, but with different TypeBits, so they differ.
+    ASSERT_EQ(2U, difference.first.size());
+    ASSERT_BSONOBJ_EQ(BSON("" << 1 << "" << 1), difference.first[0].toBson());
+    ASSERT_BSONOBJ_EQ(BSON("" << 3 << "" << 3), difference.first[1].toBson());
+
+    ASSERT_EQ(2U, difference.second.size());
+    ASSERT_EQ(BSONType::NumberDouble, difference.second[0].toBson().firstElement().type());
+    ASSERT_BSONOBJ_EQ(BSON("" << 4 << "" << 4), difference.second[1].toBson());
+}
+
+}  // namespace
+}  // namespace mongo
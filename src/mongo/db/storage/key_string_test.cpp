@@ -47,6 +47,7 @@
 #include "mongo/db/storage/key_string.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
@@ -381,6 +382,28 @@ TEST_F(KeyStringTest, LotsOfNumbers2) {
     }
 }
 
+TEST_F(KeyStringTest, LongStringsWithNuls) {
+    // Covers every alignment of NUL bytes relative to the 8 and 16 byte blocks that strings are
+    // copied and inverted in.
+    for (size_t len : {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100}) {
+        const std::string plain(len, 'x');
+        ROUNDTRIP(version, BSON("" << plain));
+        ROUNDTRIP(version, BSON("" << BSONSymbol(plain)));
+        ROUNDTRIP(version, BSON("" << BSONCode(plain)));
+        for (size_t nulPos = 0; nulPos < len; nulPos++) {
+            std::string withNul = plain;
+            withNul[nulPos] = '\0';
+            ROUNDTRIP(version, BSON("" << withNul << "" << plain));
+            withNul[len - 1] = '\0';
+            ROUNDTRIP(version, BSON("" << withNul));
+
+            const KeyString a(version, BSON("" << withNul), ONE_DESCENDING);
+            const KeyString b(version, BSON("" << plain), ONE_DESCENDING);
+            ASSERT_GREATER_THAN(a, b);
+        }
+    }
+}
+
 TEST_F(KeyStringTest, RecordIdOrder1) {
     Ordering ordering = Ordering::make(BSON("a" << 1));
 
@@ -1155,3 +1178,86 @@ TEST_F(KeyStringTest, UniformDecimalPerf) {
     }
     perfTest(version, numbers);
 }
+
+namespace {
+/**
+ * Returns compound keys shaped like those of a {tenant: 1, email: 1, name: 1, created: 1} index,
+ * with the long shared prefixes that make string-heavy indexes expensive to encode and compare.
+ */
+std::vector<BSONObj> makeCompoundStringKeys() {
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<int> tenant(0, 99);
+    std::uniform_int_distribution<int> user(0, 1000 * 1000);
+
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++) {
+        const int id = user(gen);
+        keys.push_back(BSON("" << ("tenant-" + std::to_string(tenant(gen))) << ""
+                               << ("user" + std::to_string(id) + "@mail.example.com")
+                               << ""
+                               << ("Firstname Lastname " + std::to_string(id))
+                               << ""
+                               << Date_t::fromMillisSinceEpoch(id)));
+    }
+    return keys;
+}
+
+/**
+ * Encodes, decodes and compares the keys enough times to take at least kMinPerfMicros
+ * microseconds for each, and logs the time per key.
+ */
+void compoundPerfTest(KeyString::Version version, Ordering ord, StringData orderDesc) {
+    const std::vector<BSONObj> keys = makeCompoundStringKeys();
+
+    std::vector<std::unique_ptr<KeyString>> encoded;
+    uint64_t micros = 0;
+    uint64_t iters;
+    for (iters = 1; iters < (1 << 30) && micros < kMinPerfMicros; iters *= 2) {
+        Timer t;
+        for (uint64_t i = 0; i < iters; i++) {
+            encoded.clear();
+            for (const auto& key : keys) {
+                encoded.push_back(stdx::make_unique<KeyString>(version, key, ord, RecordId(1)));
+            }
+        }
+        micros = t.micros();
+    }
+    const double encodeNanos = 1E3 * micros / static_cast<double>(iters * keys.size());
+
+    micros = 0;
+    for (iters = 1; iters < (1 << 30) && micros < kMinPerfMicros; iters *= 2) {
+        Timer t;
+        for (uint64_t i = 0; i < iters; i++) {
+            for (size_t k = 0; k < keys.size(); k++) {
+                const BSONObj converted = toBson(*encoded[k], ord);
+                invariant(converted.objsize() == keys[k].objsize());
+            }
+        }
+        micros = t.micros();
+    }
+    const double decodeNanos = 1E3 * micros / static_cast<double>(iters * keys.size());
+
+    micros = 0;
+    int64_t sum = 0;
+    for (iters = 1; iters < (1 << 30) && micros < kMinPerfMicros; iters *= 2) {
+        Timer t;
+        for (uint64_t i = 0; i < iters; i++) {
+            for (size_t k = 1; k < encoded.size(); k++) {
+                sum += encoded[k - 1]->compare(*encoded[k]);
+            }
+        }
+        micros = t.micros();
+    }
+    const double compareNanos = 1E3 * micros / static_cast<double>(iters * (keys.size() - 1));
+
+    log() << mongo::KeyString::versionToString(version) << " compound string keys, " << orderDesc
+          << ": " << encodeNanos << " ns per encode, " << decodeNanos << " ns per decode, "
+          << compareNanos << " ns per compare" << (kDebugBuild ? " (DEBUG BUILD!)" : "")
+          << " checksum " << sum;
+}
+}  // namespace
+
+TEST_F(KeyStringTest, CompoundStringKeyPerf) {
+    compoundPerfTest(version, ALL_ASCENDING, "ascending");
+    compoundPerfTest(version, Ordering::make(BSON("a" << -1 << "b" << -1)), "descending");
+}
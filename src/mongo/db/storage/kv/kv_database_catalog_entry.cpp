@@ -38,6 +38,7 @@
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
@@ -240,7 +241,11 @@ void KVDatabaseCatalogEntry::initCollection(OperationContext* opCtx,
                                             const std::string& ns,
                                             bool forRepair) {
     invariant(!_collections.count(ns));
+    registerCollection(ns, openCollection(opCtx, ns, forRepair));
+}
 
+std::unique_ptr<KVCollectionCatalogEntry> KVDatabaseCatalogEntry::openCollection(
+    OperationContext* opCtx, const std::string& ns, bool forRepair) const {
     const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
 
     RecordStore* rs;
@@ -254,9 +259,16 @@ void KVDatabaseCatalogEntry::initCollection(OperationContext* opCtx,
         invariant(rs);
     }
 
+    return stdx::make_unique<KVCollectionCatalogEntry>(
+        _engine->getEngine(), _engine->getCatalog(), ns, ident, rs);
+}
+
+void KVDatabaseCatalogEntry::registerCollection(
+    const std::string& ns, std::unique_ptr<KVCollectionCatalogEntry> collection) {
+    invariant(!_collections.count(ns));
+
     // No change registration since this is only for committed collections
-    _collections[ns] =
-        new KVCollectionCatalogEntry(_engine->getEngine(), _engine->getCatalog(), ns, ident, rs);
+    _collections[ns] = collection.release();
 }
 
 void KVDatabaseCatalogEntry::reinitCollectionAfterRepair(OperationContext* opCtx,
@@ -31,6 +31,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include "mongo/db/catalog/database_catalog_entry.h"
@@ -86,6 +87,18 @@ public:
 
     void initCollection(OperationContext* opCtx, const std::string& ns, bool forRepair);
 
+    /**
+     * The two halves of initCollection. openCollection() opens the record store of a committed
+     * collection and only reads shared catalog state, so it may be called concurrently for
+     * different collections. registerCollection() adds the result to this database and must not
+     * run concurrently with any other access to it.
+     */
+    std::unique_ptr<KVCollectionCatalogEntry> openCollection(OperationContext* opCtx,
+                                                             const std::string& ns,
+                                                             bool forRepair) const;
+    void registerCollection(const std::string& ns,
+                            std::unique_ptr<KVCollectionCatalogEntry> collection);
+
     void initCollectionBeforeRepair(OperationContext* opCtx, const std::string& ns);
     void reinitCollectionAfterRepair(OperationContext* opCtx, const std::string& ns);
 
@@ -32,12 +32,19 @@
 
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 
+#include <algorithm>
+
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/kv/kv_collection_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -46,7 +53,39 @@ using std::vector;
 
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
+
+// Threads used to open the record stores of all collections at startup. 0 picks one per core.
+int storageEngineCatalogLoadThreads = 0;
+
+class ExportedCatalogLoadThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedCatalogLoadThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "storageEngineCatalogLoadThreads",
+              &storageEngineCatalogLoadThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "storageEngineCatalogLoadThreads must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedCatalogLoadThreadsParam;
+
+// Catalogs with fewer collections than this are not worth starting threads for.
+const size_t kMinCollectionsPerLoadThread = 64;
+
+size_t catalogLoadThreads(size_t numCollections) {
+    size_t threads = storageEngineCatalogLoadThreads;
+    if (threads == 0) {
+        threads = std::max(1U, stdx::thread::hardware_concurrency());
+    }
+    return std::max<size_t>(1, std::min(threads, numCollections / kMinCollectionsPerLoadThread));
 }
+}  // namespace
 
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
 public:
@@ -75,6 +114,7 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
 
     OperationContextNoop opCtx(_engine->newRecoveryUnit());
 
+    Timer phaseTimer;
     bool catalogExists = engine->hasIdent(&opCtx, catalogInfo);
 
     if (options.forRepair && catalogExists) {
@@ -107,10 +147,14 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
 
     std::vector<std::string> collections;
     _catalog->getAllCollections(&collections);
+    log() << "Read storage engine catalog with " << collections.size() << " collections in "
+          << phaseTimer.millis() << "ms";
 
+    phaseTimer.reset();
+    std::vector<KVDatabaseCatalogEntry*> collectionDbs;
+    collectionDbs.reserve(collections.size());
     for (size_t i = 0; i < collections.size(); i++) {
-        std::string coll = collections[i];
-        NamespaceString nss(coll);
+        NamespaceString nss(collections[i]);
         string dbName = nss.db().toString();
 
         // No rollback since this is only for committed dbs.
@@ -118,9 +162,57 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
         if (!db) {
             db = new KVDatabaseCatalogEntry(dbName, this);
         }
+        collectionDbs.push_back(db);
+    }
 
-        db->initCollection(&opCtx, coll, options.forRepair);
+    // Opening a record store can involve reading table metadata and sizes, which adds up to
+    // minutes with hundreds of thousands of collections, so spread the work over several
+    // threads when the record stores are safe to use concurrently.
+    const size_t numThreads = _supportsDocLocking ? catalogLoadThreads(collections.size()) : 1;
+    if (numThreads == 1) {
+        for (size_t i = 0; i < collections.size(); i++) {
+            collectionDbs[i]->initCollection(&opCtx, collections[i], options.forRepair);
+        }
+    } else {
+        std::vector<std::unique_ptr<KVCollectionCatalogEntry>> opened(collections.size());
+        AtomicUInt64 nextCollection;
+        stdx::mutex errorMutex;
+        Status firstError = Status::OK();
+
+        auto openCollections = [&] {
+            OperationContextNoop workerOpCtx(_engine->newRecoveryUnit());
+            try {
+                for (size_t i = nextCollection.fetchAndAdd(1); i < collections.size();
+                     i = nextCollection.fetchAndAdd(1)) {
+                    opened[i] = collectionDbs[i]->openCollection(
+                        &workerOpCtx, collections[i], options.forRepair);
+                }
+            } catch (const DBException& ex) {
+                stdx::lock_guard<stdx::mutex> lk(errorMutex);
+                if (firstError.isOK()) {
+                    firstError = ex.toStatus();
+                }
+                // Stop the other threads from picking up more collections.
+                nextCollection.store(collections.size());
+            }
+            workerOpCtx.recoveryUnit()->abandonSnapshot();
+        };
+
+        std::vector<stdx::thread> workers;
+        for (size_t i = 0; i < numThreads; i++) {
+            workers.emplace_back(openCollections);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        uassertStatusOK(firstError);
+
+        for (size_t i = 0; i < collections.size(); i++) {
+            collectionDbs[i]->registerCollection(collections[i], std::move(opened[i]));
+        }
     }
+    log() << "Opened " << collections.size() << " collections in " << phaseTimer.millis()
+          << "ms using " << numThreads << " thread(s)";
 
     opCtx.recoveryUnit()->abandonSnapshot();
 
@@ -130,6 +222,8 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
         return;
     }
     {
+        phaseTimer.reset();
+
         // get all idents
         std::set<std::string> allIdents;
         {
@@ -156,6 +250,8 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
             _engine->dropIdent(&opCtx, toRemove);
             wuow.commit();
         }
+        log() << "Reconciled storage engine idents with the catalog in " << phaseTimer.millis()
+              << "ms";
     }
 }
 
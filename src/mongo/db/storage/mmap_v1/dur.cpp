@@ -86,6 +86,7 @@
 #include "mongo/db/storage/mmap_v1/aligned_builder.h"
 #include "mongo/db/storage/mmap_v1/commit_notifier.h"
 #include "mongo/db/storage/mmap_v1/dur_commitjob.h"
+#include "mongo/db/storage/mmap_v1/dur_group_commit_scheduler.h"
 #include "mongo/db/storage/mmap_v1/dur_journal.h"
 #include "mongo/db/storage/mmap_v1/dur_journal_writer.h"
 #include "mongo/db/storage/mmap_v1/dur_recover.h"
@@ -93,6 +94,7 @@
 #include "mongo/db/storage/mmap_v1/durable_mapped_file.h"
 #include "mongo/db/storage/mmap_v1/mmap_v1_options.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/platform/bits.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
@@ -120,6 +122,13 @@ namespace {
 stdx::mutex flushMutex;
 stdx::condition_variable flushRequested;
 
+// Decides when the flush thread starts the next group commit. Protected by flushMutex.
+GroupCommitScheduler groupCommitScheduler;
+
+Microseconds nowMicros() {
+    return Microseconds(static_cast<long long>(curTimeMicros64()));
+}
+
 // This is waited on for getlasterror acknowledgements. It means that data has been written to
 // the journal, but not necessarily applied to the shared view, so it is all right to
 // acknowledge the user operation, but NOT all right to delete the journal files for example.
@@ -138,9 +147,9 @@ enum {
     NumCommitsBeforeRemap = 10,
 
     // How many outstanding journal flushes should be allowed before applying writer back
-    // pressure. Size of 1 allows two journal blocks to be in the process of being written -
-    // one on the journal writer's buffer and one blocked waiting to be picked up.
-    NumAsyncJournalWrites = 1,
+    // pressure. Size of 2 double buffers the journal: the next commit can be prepared into one
+    // buffer while the journal writer is writing and syncing the other.
+    NumAsyncJournalWrites = 2,
 };
 
 // Remap loop state
@@ -501,6 +510,29 @@ void Stats::S::_asObj(BSONObjBuilder* builder) const {
     if (storageGlobalParams.journalCommitIntervalMs != 0) {
         b << "journalCommitIntervalMs" << storageGlobalParams.journalCommitIntervalMs.load();
     }
+
+    BSONObjBuilder groupCommitBuilder(b.subobjStart("groupCommit"));
+    const auto appendHistogram = [&groupCommitBuilder](
+        const char* name, const char* unit, const uint64_t* histogram) {
+        BSONArrayBuilder arrayBuilder(groupCommitBuilder.subarrayStart(name));
+        for (int i = 0; i < NumHistogramBuckets; i++) {
+            if (histogram[i] == 0)
+                continue;
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append(unit, i == 0 ? 0LL : 1LL << (i - 1));
+            entryBuilder.append("count", static_cast<long long>(histogram[i]));
+            entryBuilder.doneFast();
+        }
+        arrayBuilder.doneFast();
+    };
+    appendHistogram("batchSizes", "waiters", _commitBatchSizes);
+    appendHistogram("waitTimes", "micros", _commitWaitMicros);
+    groupCommitBuilder.doneFast();
+}
+
+void Stats::S::_addToHistogram(uint64_t* histogram, uint64_t value) {
+    const int bucket = value == 0 ? 0 : 64 - countLeadingZeros64(value);
+    histogram[std::min(bucket, static_cast<int>(NumHistogramBuckets) - 1)]++;
 }
 
 
@@ -522,6 +554,12 @@ bool DurableImpl::commitNow(OperationContext* txn) {
 
     AutoYieldFlushLockForMMAPV1Commit flushLockYield(txn->lockState());
 
+    {
+        stdx::lock_guard<stdx::mutex> lk(flushMutex);
+        groupCommitScheduler.noteWaiter(nowMicros());
+        groupCommitScheduler.requestCommit();
+    }
+
     // There is always just one waiting anyways
     flushRequested.notify_one();
 
@@ -534,6 +572,14 @@ bool DurableImpl::commitNow(OperationContext* txn) {
 }
 
 bool DurableImpl::waitUntilDurable() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(flushMutex);
+        groupCommitScheduler.noteWaiter(nowMicros());
+    }
+
+    // Let the flush thread decide how long to wait for others to batch with
+    flushRequested.notify_one();
+
     commitNotify.awaitBeyondNow();
     return true;
 }
@@ -558,6 +604,10 @@ bool DurableImpl::commitIfNeeded() {
     }
 
     // Just wake up the flush thread
+    {
+        stdx::lock_guard<stdx::mutex> lk(flushMutex);
+        groupCommitScheduler.requestCommit();
+    }
     flushRequested.notify_one();
     return true;
 }
@@ -591,6 +641,11 @@ void DurableImpl::closingFileNotification() {
 void DurableImpl::commitAndStopDurThread() {
     CommitNotifier::When when = commitNotify.now();
 
+    {
+        stdx::lock_guard<stdx::mutex> lk(flushMutex);
+        groupCommitScheduler.requestCommit();
+    }
+
     // There is always just one waiting anyways
     flushRequested.notify_one();
 
@@ -677,7 +732,8 @@ static void durThread(ClockSource* cs, int64_t serverStartMs) {
     }
 
     // Spawn the journal writer thread
-    JournalWriter journalWriter(&commitNotify, &applyToDataFilesNotify, NumAsyncJournalWrites);
+    JournalWriter journalWriter(
+        &commitNotify, &applyToDataFilesNotify, &groupCommitScheduler, NumAsyncJournalWrites);
     journalWriter.start();
 
     // Used as an estimate of how much / how fast to remap
@@ -692,7 +748,7 @@ static void durThread(ClockSource* cs, int64_t serverStartMs) {
         }
 
         // +1 so it never goes down to zero
-        const int64_t oneThird = (ms / 3) + 1;
+        const Milliseconds oneThird((ms / 3) + 1);
 
         // Reset the stats based on the reset interval
         if (stats.curr()->getCurrentDurationMillis() > DurStatsResetIntervalMillis) {
@@ -700,24 +756,33 @@ static void durThread(ClockSource* cs, int64_t serverStartMs) {
         }
 
         try {
-            stdx::unique_lock<stdx::mutex> lock(flushMutex);
+            GroupCommitScheduler::Batch batch;
+            {
+                stdx::unique_lock<stdx::mutex> lock(flushMutex);
+
+                while (shutdownRequested.loadRelaxed() == 0) {
+                    // Commit early if the number of written bytes is growing
+                    const Microseconds timeUntilCommit = groupCommitScheduler.timeUntilCommit(
+                        nowMicros(),
+                        Milliseconds(ms),
+                        commitJob.bytes() > UncommittedBytesLimit / 2);
+                    if (timeUntilCommit == Microseconds(0)) {
+                        break;
+                    }
 
-            for (unsigned i = 0; i <= 2; i++) {
-                if (stdx::cv_status::no_timeout ==
-                    flushRequested.wait_for(lock, Milliseconds(oneThird).toSystemDuration())) {
-                    // Someone forced a flush
-                    break;
+                    // Writers do not wake this thread up, so the uncommitted bytes are checked at
+                    // least every third of the interval.
+                    flushRequested.wait_for(
+                        lock, std::min<Microseconds>(timeUntilCommit, oneThird).toSystemDuration());
                 }
 
-                if (commitNotify.nWaiting()) {
-                    // One or more getLastError j:true is pending
-                    break;
-                }
+                batch = groupCommitScheduler.startCommit(nowMicros());
+            }
 
-                if (commitJob.bytes() > UncommittedBytesLimit / 2) {
-                    // The number of written bytes is growing
-                    break;
-                }
+            Stats::S::_addToHistogram(stats.curr()->_commitBatchSizes, batch.waitTimes.size());
+            for (auto&& waitTime : batch.waitTimes) {
+                Stats::S::_addToHistogram(stats.curr()->_commitWaitMicros,
+                                          durationCount<Microseconds>(waitTime));
             }
 
             // The commit logic itself
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/mmap_v1/dur_group_commit_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mongo {
+namespace dur {
+
+namespace {
+
+// Weight of the newest sample in the moving averages
+const double kAverageWeight = 1.0 / 8;
+
+// A batch is committed early once it holds this many times the recent average batch size, so
+// that batches can grow while more waiters keep arriving.
+const double kBatchGrowthFactor = 1.5;
+
+}  // namespace
+
+void GroupCommitScheduler::noteWaiter(Microseconds now) {
+    _waiterArrivals.push_back(now);
+}
+
+Microseconds GroupCommitScheduler::timeUntilCommit(Microseconds now,
+                                                   Milliseconds interval,
+                                                   bool tooManyUncommittedBytes) const {
+    if (_commitRequested || tooManyUncommittedBytes) {
+        return Microseconds(0);
+    }
+
+    Microseconds deadline;
+    if (_waiterArrivals.empty()) {
+        deadline = _lastCommitStart + interval;
+    } else if (_waiterArrivals.size() >= targetBatchSize()) {
+        return Microseconds(0);
+    } else {
+        deadline = _waiterArrivals.front() + batchWindow(interval);
+    }
+
+    return std::max(deadline - now, Microseconds(0));
+}
+
+GroupCommitScheduler::Batch GroupCommitScheduler::startCommit(Microseconds now) {
+    Batch batch;
+    batch.waitTimes.reserve(_waiterArrivals.size());
+    for (auto&& arrival : _waiterArrivals) {
+        batch.waitTimes.push_back(std::max(now - arrival, Microseconds(0)));
+    }
+
+    if (!_waiterArrivals.empty()) {
+        _avgBatchSize += (_waiterArrivals.size() - _avgBatchSize) * kAverageWeight;
+    }
+
+    _waiterArrivals.clear();
+    _commitRequested = false;
+    _lastCommitStart = now;
+
+    return batch;
+}
+
+void GroupCommitScheduler::noteJournalWrite(Microseconds latency) {
+    // Only the journal writer thread updates the average, so there are no concurrent stores.
+    const long long avg = _avgJournalWriteMicros.load();
+    const long long sample = durationCount<Microseconds>(latency);
+    _avgJournalWriteMicros.store(avg + static_cast<long long>((sample - avg) * kAverageWeight));
+}
+
+Microseconds GroupCommitScheduler::batchWindow(Milliseconds interval) const {
+    // Never hold a waiter longer than the fixed schedule did, which looked for waiters every
+    // third of the interval.
+    const Microseconds maxWindow = Microseconds(interval) / 3;
+    return std::min(Microseconds(_avgJournalWriteMicros.load() / 2), maxWindow);
+}
+
+size_t GroupCommitScheduler::targetBatchSize() const {
+    // A thread which usually commits alone never waits for others.
+    return std::max(static_cast<size_t>(std::floor(_avgBatchSize * kBatchGrowthFactor)),
+                    size_t(1));
+}
+
+}  // namespace dur
+}  // namespace mongo
@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace dur {
+
+/**
+ * Decides when the durability thread should start the next group commit.
+ *
+ * Without anyone waiting, a commit is done every journal commit interval. Threads waiting for
+ * their writes to reach the journal (j:true, getLastError with j) are batched: the first one to
+ * arrive opens a window of about half of the observed journal write latency, so that the cost of
+ * one journal write and fsync is shared by everyone who shows up while it would have been in
+ * progress anyway. The batch is committed early once it is larger than recent batches were, and
+ * right away when a commit is forced or the uncommitted bytes grow large.
+ *
+ * Not thread-safe, except for noteJournalWrite. The durability code calls everything else under
+ * the mutex which the durability thread waits on.
+ */
+class GroupCommitScheduler {
+    MONGO_DISALLOW_COPYING(GroupCommitScheduler);
+
+public:
+    /**
+     * The threads which were waiting for a group commit when it started.
+     */
+    struct Batch {
+        // How long each of the waiting threads had been waiting for the commit to start.
+        std::vector<Microseconds> waitTimes;
+    };
+
+    GroupCommitScheduler() = default;
+
+    /**
+     * Records that a thread started waiting for the next commit to reach the journal.
+     */
+    void noteWaiter(Microseconds now);
+
+    /**
+     * Requests the next commit to start without delay, as for fsync or shutdown.
+     */
+    void requestCommit() {
+        _commitRequested = true;
+    }
+
+    /**
+     * Returns how long the durability thread should wait before starting the next commit, or
+     * zero if it should start it now. 'interval' is the journal commit interval and
+     * 'tooManyUncommittedBytes' whether enough writes accumulated to commit them regardless.
+     */
+    Microseconds timeUntilCommit(Microseconds now,
+                                 Milliseconds interval,
+                                 bool tooManyUncommittedBytes) const;
+
+    /**
+     * Called when the durability thread starts a commit. Returns the waiters batched into it and
+     * resets the scheduler for the next commit.
+     */
+    Batch startCommit(Microseconds now);
+
+    /**
+     * Records how long writing and syncing one commit to the journal took. Called by the journal
+     * writer thread.
+     */
+    void noteJournalWrite(Microseconds latency);
+
+    /**
+     * The longest a waiter is held back to batch it with others, given the journal commit
+     * interval.
+     */
+    Microseconds batchWindow(Milliseconds interval) const;
+
+    /**
+     * Number of waiters at which a batch is committed without waiting for the window to close.
+     */
+    size_t targetBatchSize() const;
+
+private:
+    bool _commitRequested = false;
+
+    // Arrival times of the threads waiting for the next commit
+    std::vector<Microseconds> _waiterArrivals;
+
+    Microseconds _lastCommitStart{0};
+
+    // Exponential moving averages of the size of batches with waiters in them and of how long the
+    // journal writes took.
+    double _avgBatchSize = 0;
+    AtomicInt64 _avgJournalWriteMicros{0};
+};
+
+}  // namespace dur
+}  // namespace mongo
@@ -0,0 +1,160 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/mmap_v1/dur_group_commit_scheduler.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace dur {
+namespace {
+
+const Milliseconds kInterval(100);
+
+TEST(GroupCommitSchedulerTest, CommitsEveryIntervalWithoutWaiters) {
+    GroupCommitScheduler scheduler;
+    scheduler.startCommit(Microseconds(0));
+
+    ASSERT_EQ(Microseconds(kInterval),
+              scheduler.timeUntilCommit(Microseconds(0), kInterval, false));
+    ASSERT_EQ(Microseconds(40000),
+              scheduler.timeUntilCommit(Microseconds(60000), kInterval, false));
+    ASSERT_EQ(Microseconds(0), scheduler.timeUntilCommit(Microseconds(100000), kInterval, false));
+}
+
+TEST(GroupCommitSchedulerTest, CommitsRightAwayWhenRequested) {
+    GroupCommitScheduler scheduler;
+    scheduler.startCommit(Microseconds(0));
+
+    ASSERT_EQ(Microseconds(0), scheduler.timeUntilCommit(Microseconds(10), kInterval, true));
+
+    scheduler.requestCommit();
+    ASSERT_EQ(Microseconds(0), scheduler.timeUntilCommit(Microseconds(10), kInterval, false));
+
+    // The request is reset by the commit
+    scheduler.startCommit(Microseconds(10));
+    ASSERT_NOT_EQUALS(Microseconds(0),
+                      scheduler.timeUntilCommit(Microseconds(10), kInterval, false));
+}
+
+TEST(GroupCommitSchedulerTest, LoneWaiterDoesNotWait) {
+    GroupCommitScheduler scheduler;
+    scheduler.noteJournalWrite(Microseconds(8000));
+
+    for (int i = 0; i < 10; i++) {
+        const Microseconds now(i * 1000000);
+        scheduler.noteWaiter(now);
+        ASSERT_EQ(Microseconds(0), scheduler.timeUntilCommit(now, kInterval, false));
+
+        auto batch = scheduler.startCommit(now);
+        ASSERT_EQ(1U, batch.waitTimes.size());
+        ASSERT_EQ(Microseconds(0), batch.waitTimes[0]);
+    }
+
+    ASSERT_EQ(1U, scheduler.targetBatchSize());
+}
+
+TEST(GroupCommitSchedulerTest, BatchWindowFollowsJournalWriteLatency) {
+    GroupCommitScheduler scheduler;
+    ASSERT_EQ(Microseconds(0), scheduler.batchWindow(kInterval));
+
+    for (int i = 0; i < 100; i++) {
+        scheduler.noteJournalWrite(Microseconds(8000));
+    }
+    ASSERT_GT(scheduler.batchWindow(kInterval), Microseconds(3500));
+    ASSERT_LTE(scheduler.batchWindow(kInterval), Microseconds(4000));
+
+    // Waiters are never held back longer than a third of the commit interval
+    for (int i = 0; i < 100; i++) {
+        scheduler.noteJournalWrite(Seconds(1));
+    }
+    ASSERT_EQ(Microseconds(kInterval) / 3, scheduler.batchWindow(kInterval));
+}
+
+TEST(GroupCommitSchedulerTest, BatchesConcurrentWaiters) {
+    GroupCommitScheduler scheduler;
+    for (int i = 0; i < 100; i++) {
+        scheduler.noteJournalWrite(Microseconds(10000));
+    }
+
+    // Commits of four waiters each make the scheduler wait for more than four
+    Microseconds now(0);
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < 4; j++) {
+            scheduler.noteWaiter(now);
+        }
+        scheduler.startCommit(now);
+        now += Milliseconds(1);
+    }
+    ASSERT_EQ(5U, scheduler.targetBatchSize());
+
+    // The first waiter opens a window of half the journal write latency
+    scheduler.noteWaiter(now);
+    const Microseconds window = scheduler.timeUntilCommit(now, kInterval, false);
+    ASSERT_GT(window, Microseconds(0));
+    ASSERT_EQ(scheduler.batchWindow(kInterval), window);
+
+    now += Milliseconds(2);
+    for (int j = 0; j < 3; j++) {
+        scheduler.noteWaiter(now);
+    }
+    ASSERT_EQ(window - Milliseconds(2), scheduler.timeUntilCommit(now, kInterval, false));
+
+    // Reaching the target size commits without waiting for the window to close
+    scheduler.noteWaiter(now);
+    ASSERT_EQ(Microseconds(0), scheduler.timeUntilCommit(now, kInterval, false));
+
+    auto batch = scheduler.startCommit(now);
+    ASSERT_EQ(5U, batch.waitTimes.size());
+    ASSERT_EQ(Microseconds(Milliseconds(2)), batch.waitTimes[0]);
+    ASSERT_EQ(Microseconds(0), batch.waitTimes[4]);
+}
+
+TEST(GroupCommitSchedulerTest, WindowClosesForSmallBatch) {
+    GroupCommitScheduler scheduler;
+    for (int i = 0; i < 100; i++) {
+        scheduler.noteJournalWrite(Microseconds(10000));
+    }
+    for (int i = 0; i < 50; i++) {
+        scheduler.noteWaiter(Microseconds(0));
+        scheduler.noteWaiter(Microseconds(0));
+        scheduler.startCommit(Microseconds(0));
+    }
+
+    scheduler.noteWaiter(Microseconds(0));
+    const Microseconds window = scheduler.batchWindow(kInterval);
+    ASSERT_GT(scheduler.timeUntilCommit(window - Microseconds(1), kInterval, false),
+              Microseconds(0));
+    ASSERT_EQ(Microseconds(0), scheduler.timeUntilCommit(window, kInterval, false));
+}
+
+}  // namespace
+}  // namespace dur
+}  // namespace mongo
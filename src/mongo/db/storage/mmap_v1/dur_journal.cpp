@@ -785,30 +785,33 @@ void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed)
     verify(compressedLength < max);
     b.skip(compressedLength);
 
-    // footer
-    unsigned L = 0xffffffff;
-    {
-        // pad to alignment, and set the total section length in the JSectHeader
-        verify(0xffffe000 == (~(Alignment - 1)));
-        unsigned lenUnpadded = b.len() + sizeof(JSectFooter);
-        L = (lenUnpadded + Alignment - 1) & (~(Alignment - 1));
-        dassert(L >= lenUnpadded);
-
-        ((JSectHeader*)b.atOfs(0))->setSectionLen(lenUnpadded);
-
-        JSectFooter f(b.buf(), b.len());  // computes checksum
-        b.appendStruct(f);
-        dassert(b.len() == lenUnpadded);
-
-        b.skip(L - lenUnpadded);
-        dassert(b.len() % Alignment == 0);
-    }
-
     try {
         stdx::lock_guard<SimpleMutex> lk(_curLogFileMutex);
 
-        // must already be open -- so that _curFileId is correct for previous buffer building
-        verify(_curLogFile);
+        // The next section may already have been prepared while the previous one was being
+        // written, so the file this section goes to is only known now.
+        if (_curLogFile == 0)
+            _open();
+        ((JSectHeader*)b.atOfs(0))->fileId = _curFileId;
+
+        // footer
+        unsigned L = 0xffffffff;
+        {
+            // pad to alignment, and set the total section length in the JSectHeader
+            verify(0xffffe000 == (~(Alignment - 1)));
+            unsigned lenUnpadded = b.len() + sizeof(JSectFooter);
+            L = (lenUnpadded + Alignment - 1) & (~(Alignment - 1));
+            dassert(L >= lenUnpadded);
+
+            ((JSectHeader*)b.atOfs(0))->setSectionLen(lenUnpadded);
+
+            JSectFooter f(b.buf(), b.len());  // computes checksum
+            b.appendStruct(f);
+            dassert(b.len() == lenUnpadded);
+
+            b.skip(L - lenUnpadded);
+            dassert(b.len() % Alignment == 0);
+        }
 
         stats.curr()->_uncompressedBytes += uncompressed.len();
         unsigned w = b.len();
@@ -83,7 +83,8 @@ unsigned long long journalReadLSN();
 bool haveJournalFiles(bool anyFiles = false);
 
 /**
- * Writes the specified uncompressed buffer to the journal.
+ * Writes the specified uncompressed buffer to the journal. The header's fileId is filled in with
+ * the journal file the section ends up in.
  */
 void WRITETOJOURNAL(const JSectHeader& h, const AlignedBuilder& uncompressed);
 
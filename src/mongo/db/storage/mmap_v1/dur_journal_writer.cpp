@@ -34,6 +34,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
+#include "mongo/db/storage/mmap_v1/dur_group_commit_scheduler.h"
 #include "mongo/db/storage/mmap_v1/dur_journal.h"
 #include "mongo/db/storage/mmap_v1/dur_recover.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
@@ -111,9 +112,11 @@ private:
 
 JournalWriter::JournalWriter(CommitNotifier* commitNotify,
                              CommitNotifier* applyToDataFilesNotify,
+                             GroupCommitScheduler* groupCommitScheduler,
                              size_t numBuffers)
     : _commitNotify(commitNotify),
       _applyToDataFilesNotify(applyToDataFilesNotify),
+      _groupCommitScheduler(groupCommitScheduler),
       _shutdownRequested(false),
       _journalQueue(numBuffers),
       _lastCommitNumber(0),
@@ -230,12 +233,14 @@ void JournalWriter::_journalWriterThread() {
                 continue;
             }
 
-            LOG(4) << "Journaling commit number " << buffer->_commitNumber << " (journal file "
-                   << buffer->_header.fileId << ", sequence " << buffer->_header.seqNumber
-                   << ", size " << buffer->_builder.len() << " bytes)";
+            LOG(4) << "Journaling commit number " << buffer->_commitNumber << " (sequence "
+                   << buffer->_header.seqNumber << ", size " << buffer->_builder.len()
+                   << " bytes)";
 
             // This performs synchronous I/O to the journal file and will block.
+            Timer t;
             WRITETOJOURNAL(buffer->_header, buffer->_builder);
+            _groupCommitScheduler->noteJournalWrite(Microseconds(t.micros()));
 
             // Data is now persisted in the journal, which is sufficient for acknowledging
             // durability.
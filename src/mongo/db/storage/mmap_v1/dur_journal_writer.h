@@ -39,6 +39,8 @@
 namespace mongo {
 namespace dur {
 
+class GroupCommitScheduler;
+
 /**
  * Manages the thread and queues used for writing the journal to disk and notify parties with
  * are waiting on the write concern.
@@ -111,12 +113,16 @@ public:
      *      flushed at this point, the journal files before this point are not necessary. The
      *      caller retains ownership and the notify object must outlive the journal writer
      *      object.
+     * @param groupCommitScheduler Told how long each journal write took, so it can size the
+     *      group commit batches. The caller retains ownership and it must outlive the journal
+     *      writer object.
      * @param numBuffers How many buffers to create to hold outstanding writes. If there are
      *      more than this number of journal writes that have not completed, the write calls
      *      will block.
      */
     JournalWriter(CommitNotifier* commitNotify,
                   CommitNotifier* applyToDataFilesNotify,
+                  GroupCommitScheduler* groupCommitScheduler,
                   size_t numBuffers);
     ~JournalWriter();
 
@@ -182,6 +188,9 @@ private:
     // This gets notified as journal buffers are done being applied to the shared view
     CommitNotifier* const _applyToDataFilesNotify;
 
+    // Not owned and needs to outlive the journal writer object
+    GroupCommitScheduler* const _groupCommitScheduler;
+
     // Wraps and controls the journal writer thread
     stdx::thread _journalWriterThreadHandle;
 
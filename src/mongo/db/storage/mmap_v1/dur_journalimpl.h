@@ -70,16 +70,6 @@ public:
 
     void cleanup(bool log);  // closes and removes journal files
 
-    unsigned long long curFileId() const {
-        return _curFileId;
-    }
-
-    void assureLogFileOpen() {
-        stdx::lock_guard<SimpleMutex> lk(_curLogFileMutex);
-        if (_curLogFile == 0)
-            _open();
-    }
-
     /** open a journal file to journal operations to. */
     void open();
 
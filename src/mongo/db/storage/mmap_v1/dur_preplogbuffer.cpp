@@ -60,7 +60,6 @@ using std::stringstream;
 
 namespace dur {
 
-extern Journal j;
 extern CommitJob commitJob;
 
 const RelativePath local = RelativePath::fromRelativePath("local");
@@ -180,7 +179,10 @@ static void _PREPLOGBUFFER(JSectHeader& h,
     // Invalidate the total length, we will fill it in later.
     h.setSectionLen(0xffffffff);
     h.seqNumber = generateNextSeqNumber(cs, serverStartMs);
-    h.fileId = j.curFileId();
+
+    // The journal writer may still be writing the previous section and switch to a new journal
+    // file after it, so the file id is only filled in once this section is being written.
+    h.fileId = 0;
 
     // Ops other than basic writes (DurOp's) go first
     const std::vector<std::shared_ptr<DurOp>>& durOps = commitJob.ops();
@@ -201,7 +203,6 @@ void PREPLOGBUFFER(/*out*/ JSectHeader& outHeader,
                    ClockSource* cs,
                    int64_t serverStartMs) {
     Timer t;
-    j.assureLogFileOpen();  // so fileId is set
     _PREPLOGBUFFER(outHeader, outBuffer, cs, serverStartMs);
     stats.curr()->_prepLogBufferMicros += t.micros();
 }
@@ -35,6 +35,7 @@
 #include "mongo/db/storage/mmap_v1/dur_recover.h"
 
 #include <cstring>
+#include <deque>
 #include <fcntl.h>
 #include <iomanip>
 #include <iostream>
@@ -42,6 +43,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/mmap_v1/compress.h"
 #include "mongo/db/storage/mmap_v1/dur_commitjob.h"
 #include "mongo/db/storage/mmap_v1/dur_journal.h"
@@ -51,14 +53,21 @@
 #include "mongo/db/storage/mmap_v1/durop.h"
 #include "mongo/db/storage/mmap_v1/mmap_v1_options.h"
 #include "mongo/platform/strnlen.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/checksum.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/startup_test.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -87,6 +96,38 @@ namespace dur {
 // The singleton recovery job object
 RecoveryJob& RecoveryJob::_instance = *(new RecoveryJob());
 
+namespace {
+
+// Number of threads journal recovery uses to decompress sections ahead of applying them, and to
+// copy the writes of a section into different data files at once. 1 does all of the work on the
+// recovering thread.
+int journalRecoveryThreads = 4;
+
+class ExportedJournalRecoveryThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedJournalRecoveryThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), "journalRecoveryThreads", &journalRecoveryThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 64) {
+            return Status(ErrorCodes::BadValue, "journalRecoveryThreads must be between 1 and 64");
+        }
+
+        return Status::OK();
+    }
+} exportedJournalRecoveryThreadsParam;
+
+// The maximum number of sections that may be decompressed ahead of the one being applied.
+const size_t kMaxSectionsInFlightPerThread = 2;
+
+// Below this many bytes, a section's writes are copied on the recovering thread, since handing
+// them to the workers would cost more than the copying.
+const size_t kMinBytesForParallelApply = 1024 * 1024;
+
+}  // namespace
+
 
 void removeJournalFiles();
 boost::filesystem::path getJournalDir();
@@ -166,6 +207,13 @@ public:
         _entries = unique_ptr<BufReader>(new BufReader(p, _uncompressed.size()));
     }
 
+    // Takes a section that was already decompressed, while recovering.
+    JournalSectionIterator(const JSectHeader& h, std::string uncompressed)
+        : _h(h), _lastDbName(0), _doDurOps(true), _uncompressed(std::move(uncompressed)) {
+        _entries =
+            unique_ptr<BufReader>(new BufReader(_uncompressed.c_str(), _uncompressed.size()));
+    }
+
     // We work with the uncompressed buffer when doing a WRITETODATAFILES (for speed)
     JournalSectionIterator(const JSectHeader& h, const void* p, unsigned len)
         : _entries(new BufReader((const char*)p, len)), _h(h), _lastDbName(0), _doDurOps(false) {}
@@ -257,6 +305,204 @@ static string fileName(const char* dbName, int fileNo) {
 }
 
 
+/**
+ * A fixed set of threads running recovery tasks in the order they were scheduled. Tasks must not
+ * throw; they report failures through the state they were given.
+ */
+class RecoveryJob::WorkerPool {
+    MONGO_DISALLOW_COPYING(WorkerPool);
+
+public:
+    explicit WorkerPool(int numThreads) {
+        for (int i = 0; i < numThreads; ++i) {
+            _threads.emplace_back([this, i] {
+                setThreadName(str::stream() << "journalRecovery-" << i);
+                _run();
+            });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _shutdown = true;
+        }
+        _cv.notify_all();
+        for (auto&& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    size_t numThreads() const {
+        return _threads.size();
+    }
+
+    void schedule(stdx::function<void()> task) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _tasks.push_back(std::move(task));
+        }
+        _cv.notify_one();
+    }
+
+private:
+    void _run() {
+        while (true) {
+            stdx::function<void()> task;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _cv.wait(lk, [this] { return _shutdown || !_tasks.empty(); });
+                if (_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    std::deque<stdx::function<void()>> _tasks;
+    bool _shutdown = false;
+    std::vector<stdx::thread> _threads;
+};
+
+/**
+ * Checksums and decompresses the sections of a journal file ahead of applying them. Sections are
+ * pushed in journal order and applied in that same order by the recovering thread, once they are
+ * ready and at most a few sections behind the newest one pushed.
+ *
+ * A section that fails its checksum or cannot be decompressed ends the journal: the sections
+ * before it are applied, and the ones after it are discarded.
+ */
+class RecoveryJob::SectionPipeline {
+    MONGO_DISALLOW_COPYING(SectionPipeline);
+
+public:
+    explicit SectionPipeline(RecoveryJob& rj)
+        : _rj(rj),
+          _maxInFlight(rj._workers ? rj._workers->numThreads() * kMaxSectionsInFlightPerThread
+                                   : 1) {}
+
+    ~SectionPipeline() {
+        // Workers may still be writing to discarded sections.
+        _waitForAll();
+    }
+
+    /**
+     * Queues the section for decompression, then applies sections until few enough remain queued.
+     * Throws JournalSectionCorruptException if a section that had to be applied was corrupt.
+     */
+    void push(const JSectHeader* h, const char* data, unsigned len, const JSectFooter* f) {
+        // Check the layout now, as the original processSection did, since a failed verify() should
+        // happen on this thread.
+        verify(((const char*)h) + sizeof(JSectHeader) == data);
+        verify(len == h->sectionLen() - sizeof(JSectFooter) - sizeof(JSectHeader));
+
+        auto section = std::make_shared<Section>();
+        section->header = h;
+        section->data = data;
+        section->len = len;
+        section->footer = f;
+        // Sections the data files already contain only need their checksum verified.
+        section->needsData = _rj._lastDataSyncedFromLastRun <= h->seqNumber + ExtraKeepTimeMs;
+        _rj._stats.journalBytes += len;
+
+        _sections.push_back(section);
+        if (_rj._workers) {
+            _rj._workers->schedule([this, section] { _prepare(section.get()); });
+        } else {
+            _prepare(section.get());
+        }
+
+        while (_sections.size() > _maxInFlight) {
+            _applyOldest();
+        }
+    }
+
+    /**
+     * Applies every queued section. Throws JournalSectionCorruptException if one of them was
+     * corrupt.
+     */
+    void finish() {
+        while (!_sections.empty()) {
+            _applyOldest();
+        }
+    }
+
+private:
+    struct Section {
+        const JSectHeader* header;
+        const char* data;
+        unsigned len;
+        const JSectFooter* footer;
+        bool needsData;
+
+        // Set by _prepare().
+        bool ready = false;
+        const char* corruption = nullptr;
+        std::string uncompressed;
+    };
+
+    void _prepare(Section* section) {
+        Timer timer;
+        if (!section->footer->checkHash(section->header, section->len + sizeof(JSectHeader))) {
+            section->corruption = "journal section checksum doesn't match";
+        } else if (section->needsData &&
+                   !uncompress(section->data, section->len, &section->uncompressed)) {
+            // We check the checksum before we uncompress, but this may still fail as the
+            // checksum isn't foolproof.
+            section->corruption = "couldn't uncompress journal section";
+        }
+        _rj._stats.decompressMicros.fetchAndAdd(timer.micros());
+
+        // Notify while holding the mutex, as the pipeline may be destroyed as soon as the
+        // recovering thread sees that the section is ready.
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        section->ready = true;
+        _cv.notify_all();
+    }
+
+    void _applyOldest() {
+        std::shared_ptr<Section> section = _sections.front();
+        _sections.pop_front();
+
+        {
+            Timer timer;
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _cv.wait(lk, [&] { return section->ready; });
+            _rj._stats.waitMicros += timer.micros();
+        }
+
+        if (section->corruption) {
+            log() << section->corruption;
+            throw JournalSectionCorruptException();
+        }
+
+        Timer timer;
+        _rj._processDecompressedSection(*section->header, std::move(section->uncompressed));
+        _rj._stats.applyMicros += timer.micros();
+    }
+
+    void _waitForAll() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        for (auto&& section : _sections) {
+            _cv.wait(lk, [&] { return section->ready; });
+        }
+    }
+
+    RecoveryJob& _rj;
+    const size_t _maxInFlight;
+
+    std::deque<std::shared_ptr<Section>> _sections;  // Not yet applied, in journal order.
+
+    stdx::mutex _mutex;  // Protects 'ready' of the queued sections.
+    stdx::condition_variable _cv;
+};
+
+
 RecoveryJob::RecoveryJob()
     : _recovering(false),
       _lastDataSyncedFromLastRun(0),
@@ -315,22 +561,29 @@ DurableMappedFile* RecoveryJob::Last::newEntry(const dur::ParsedJournalEntry& en
     return mmf;
 }
 
-void RecoveryJob::write(Last& last, const ParsedJournalEntry& entry) {
+DurableMappedFile* RecoveryJob::_fileForWrite(Last& last, const ParsedJournalEntry& entry) {
     // TODO(mathias): look into making some of these dasserts
     verify(entry.e);
     verify(entry.dbName);
 
     DurableMappedFile* mmf = last.newEntry(entry, *this);
 
-    if ((entry.e->ofs + entry.e->len) <= mmf->length()) {
-        verify(mmf->view_write());
-        verify(entry.e->srcData());
+    if ((entry.e->ofs + entry.e->len) > mmf->length()) {
+        massert(13622, "Trying to write past end of file in WRITETODATAFILES", _recovering);
+        return nullptr;
+    }
+
+    verify(mmf->view_write());
+    verify(entry.e->srcData());
+    return mmf;
+}
 
+void RecoveryJob::write(Last& last, const ParsedJournalEntry& entry) {
+    DurableMappedFile* mmf = _fileForWrite(last, entry);
+    if (mmf) {
         void* dest = (char*)mmf->view_write() + entry.e->ofs;
         memcpy(dest, entry.e->srcData(), entry.e->len);
         stats.curr()->_writeToDataFilesBytes += entry.e->len;
-    } else {
-        massert(13622, "Trying to write past end of file in WRITETODATAFILES", _recovering);
     }
 }
 
@@ -373,9 +626,14 @@ void RecoveryJob::applyEntries(const vector<ParsedJournalEntry>& entries) {
         log() << "BEGIN section" << endl;
     }
 
-    Last last;
-    for (vector<ParsedJournalEntry>::const_iterator i = entries.begin(); i != entries.end(); ++i) {
-        applyEntry(last, *i, apply, dump);
+    if (apply && !dump && _workers) {
+        _applyEntriesInParallel(entries);
+    } else {
+        Last last;
+        for (vector<ParsedJournalEntry>::const_iterator i = entries.begin(); i != entries.end();
+             ++i) {
+            applyEntry(last, *i, apply, dump);
+        }
     }
 
     if (dump) {
@@ -383,6 +641,122 @@ void RecoveryJob::applyEntries(const vector<ParsedJournalEntry>& entries) {
     }
 }
 
+void RecoveryJob::_applyEntriesInParallel(const vector<ParsedJournalEntry>& entries) {
+    // The writes to one data file, in journal order.
+    struct FileWrites {
+        DurableMappedFile* mmf;
+        vector<const JEntry*> writes;
+    };
+
+    vector<FileWrites> files;
+    map<DurableMappedFile*, size_t> fileIndexes;
+    size_t totalBytes = 0;
+
+    // Writes to different data files are independent, so each file's writes are copied by one
+    // thread while other threads copy the writes to other files. The writes to a single file keep
+    // their order, since later writes may overwrite earlier ones.
+    auto copyWrites = [&] {
+        if (files.size() > 1 && totalBytes >= kMinBytesForParallelApply) {
+            stdx::mutex mutex;
+            stdx::condition_variable cv;
+            size_t remaining = files.size();
+            for (auto&& file : files) {
+                FileWrites* fw = &file;
+                _workers->schedule([fw, &mutex, &cv, &remaining] {
+                    char* base = (char*)fw->mmf->view_write();
+                    for (const JEntry* e : fw->writes) {
+                        memcpy(base + e->ofs, e->srcData(), e->len);
+                    }
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    if (--remaining == 0) {
+                        cv.notify_one();
+                    }
+                });
+            }
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cv.wait(lk, [&] { return remaining == 0; });
+            _stats.parallelCopies++;
+        } else {
+            for (auto&& file : files) {
+                char* base = (char*)file.mmf->view_write();
+                for (const JEntry* e : file.writes) {
+                    memcpy(base + e->ofs, e->srcData(), e->len);
+                }
+            }
+        }
+        stats.curr()->_writeToDataFilesBytes += totalBytes;
+        _stats.dataFileBytes += totalBytes;
+        files.clear();
+        fileIndexes.clear();
+        totalBytes = 0;
+    };
+
+    Last last;
+    for (auto&& entry : entries) {
+        if (entry.e) {
+            // Opening data files and checking bounds happens here, as RecoveryJob::write() does,
+            // so that only the copying is left to the workers.
+            DurableMappedFile* mmf = _fileForWrite(last, entry);
+            if (!mmf) {
+                continue;
+            }
+
+            auto it = fileIndexes.find(mmf);
+            if (it == fileIndexes.end()) {
+                it = fileIndexes.emplace(mmf, files.size()).first;
+                files.push_back(FileWrites{mmf, {}});
+            }
+            files[it->second].writes.push_back(entry.e);
+            totalBytes += entry.e->len;
+        } else if (entry.op) {
+            // Operations such as dropping a database may close or remove data files, so every
+            // earlier write must be in place before they run. They may also close the files that
+            // 'last' remembers.
+            copyWrites();
+            applyEntry(last, entry, true, false);
+            last = Last();
+        }
+    }
+    copyWrites();
+}
+
+bool RecoveryJob::_shouldApplySection(const JSectHeader& h) {
+    static uint64_t numJournalSegmentsSkipped = 0;
+    static const uint64_t kMaxSkippedSectionsToLog = 10;
+    if (_lastDataSyncedFromLastRun > h.seqNumber + ExtraKeepTimeMs) {
+        if (_appliedAnySections) {
+            severe() << "Journal section sequence number " << h.seqNumber
+                     << " is lower than the threshold for applying ("
+                     << h.seqNumber + ExtraKeepTimeMs
+                     << ") but we have already applied some journal sections. This implies a "
+                     << "corrupt journal file.";
+            fassertFailed(34369);
+        }
+
+        if (++numJournalSegmentsSkipped < kMaxSkippedSectionsToLog) {
+            log() << "recover skipping application of section seq:" << h.seqNumber
+                  << " < lsn:" << _lastDataSyncedFromLastRun << endl;
+        } else if (numJournalSegmentsSkipped == kMaxSkippedSectionsToLog) {
+            log() << "recover skipping application of section more..." << endl;
+        }
+        _lastSeqSkipped = h.seqNumber;
+        _stats.sectionsSkipped++;
+        return false;
+    }
+
+    if (!_appliedAnySections) {
+        _appliedAnySections = true;
+        if (numJournalSegmentsSkipped >= kMaxSkippedSectionsToLog) {
+            // Log the last skipped section's sequence number if it hasn't been logged before.
+            log() << "recover final skipped journal section had sequence number "
+                  << _lastSeqSkipped;
+        }
+        log() << "recover applying initial journal section with sequence number " << h.seqNumber;
+    }
+    _stats.sectionsApplied++;
+    return true;
+}
+
 void RecoveryJob::processSection(const JSectHeader* h,
                                  const void* p,
                                  unsigned len,
@@ -398,38 +772,9 @@ void RecoveryJob::processSection(const JSectHeader* h,
             throw JournalSectionCorruptException();
         }
 
-        static uint64_t numJournalSegmentsSkipped = 0;
-        static const uint64_t kMaxSkippedSectionsToLog = 10;
-        if (_lastDataSyncedFromLastRun > h->seqNumber + ExtraKeepTimeMs) {
-            if (_appliedAnySections) {
-                severe() << "Journal section sequence number " << h->seqNumber
-                         << " is lower than the threshold for applying ("
-                         << h->seqNumber + ExtraKeepTimeMs
-                         << ") but we have already applied some journal sections. This implies a "
-                         << "corrupt journal file.";
-                fassertFailed(34369);
-            }
-
-            if (++numJournalSegmentsSkipped < kMaxSkippedSectionsToLog) {
-                log() << "recover skipping application of section seq:" << h->seqNumber
-                      << " < lsn:" << _lastDataSyncedFromLastRun << endl;
-            } else if (numJournalSegmentsSkipped == kMaxSkippedSectionsToLog) {
-                log() << "recover skipping application of section more..." << endl;
-            }
-            _lastSeqSkipped = h->seqNumber;
+        if (!_shouldApplySection(*h)) {
             return;
         }
-
-        if (!_appliedAnySections) {
-            _appliedAnySections = true;
-            if (numJournalSegmentsSkipped >= kMaxSkippedSectionsToLog) {
-                // Log the last skipped section's sequence number if it hasn't been logged before.
-                log() << "recover final skipped journal section had sequence number "
-                      << _lastSeqSkipped;
-            }
-            log() << "recover applying initial journal section with sequence number "
-                  << h->seqNumber;
-        }
     }
 
     unique_ptr<JournalSectionIterator> i;
@@ -440,6 +785,23 @@ void RecoveryJob::processSection(const JSectHeader* h,
             new JournalSectionIterator(*h, /*after header*/ p, /*w/out header*/ len));
     }
 
+    _applySection(i.get());
+}
+
+void RecoveryJob::_processDecompressedSection(const JSectHeader& h, std::string uncompressed) {
+    LockMongoFilesShared lkFiles;  // for RecoveryJob::Last
+    stdx::lock_guard<stdx::mutex> lk(_mx);
+
+    invariant(_recovering);
+    if (!_shouldApplySection(h)) {
+        return;
+    }
+
+    JournalSectionIterator i(h, std::move(uncompressed));
+    _applySection(&i);
+}
+
+void RecoveryJob::_applySection(JournalSectionIterator* i) {
     // we use a static so that we don't have to reallocate every time through.  occasionally we
     // go back to a small allocation so that if there were a spiky growth it won't stick forever.
     static vector<ParsedJournalEntry> entries;
@@ -469,6 +831,8 @@ void RecoveryJob::processSection(const JSectHeader* h,
     @return true if this is detected to be the last file (ends abruptly)
 */
 bool RecoveryJob::processFileBuffer(const void* p, unsigned len) {
+    SectionPipeline pipeline(*this);
+    bool abruptEnd = false;
     try {
         unsigned long long fileId;
         BufReader br(p, len);
@@ -516,29 +880,39 @@ bool RecoveryJob::processFileBuffer(const void* p, unsigned len) {
                           << " got:" << h.fileId << endl;
                     log() << "  sect len:" << h.sectionLen() << " seqnum:" << h.seqNumber << endl;
                 }
-                return true;
+                abruptEnd = true;
+                break;
             }
             unsigned slen = h.sectionLen();
             unsigned dataLen = slen - sizeof(JSectHeader) - sizeof(JSectFooter);
             const char* hdr = (const char*)br.skip(h.sectionLenWithPadding());
             const char* data = hdr + sizeof(JSectHeader);
             const char* footer = data + dataLen;
-            processSection((const JSectHeader*)hdr, data, dataLen, (const JSectFooter*)footer);
+            pipeline.push((const JSectHeader*)hdr, data, dataLen, (const JSectFooter*)footer);
 
             // ctrl c check
             uassert(ErrorCodes::Interrupted, "interrupted during journal recovery", !inShutdown());
         }
     } catch (const BufReader::eof&) {
+        if (mmapv1GlobalOptions.journalOptions & MMAPV1Options::JournalDumpJournal)
+            log() << "ABRUPT END" << endl;
+        // The sections read before the end of the file are still applied.
+        abruptEnd = true;
+    } catch (const JournalSectionCorruptException&) {
         if (mmapv1GlobalOptions.journalOptions & MMAPV1Options::JournalDumpJournal)
             log() << "ABRUPT END" << endl;
         return true;  // abrupt end
+    }
+
+    try {
+        pipeline.finish();
     } catch (const JournalSectionCorruptException&) {
         if (mmapv1GlobalOptions.journalOptions & MMAPV1Options::JournalDumpJournal)
             log() << "ABRUPT END" << endl;
         return true;  // abrupt end
     }
 
-    return false;  // non-abrupt end
+    return abruptEnd;
 }
 
 /** apply a specific journal file */
@@ -572,6 +946,25 @@ void RecoveryJob::go(vector<boost::filesystem::path>& files) {
     _lastDataSyncedFromLastRun = journalReadLSN();
     log() << "recover lsn: " << _lastDataSyncedFromLastRun << endl;
 
+    Timer timer;
+    _stats.sectionsApplied = 0;
+    _stats.sectionsSkipped = 0;
+    _stats.journalBytes = 0;
+    _stats.dataFileBytes = 0;
+    _stats.parallelCopies = 0;
+    _stats.decompressMicros.store(0);
+    _stats.waitMicros = 0;
+    _stats.applyMicros = 0;
+    _stats.flushMicros = 0;
+
+    const int numThreads = journalRecoveryThreads;
+    if (numThreads > 1) {
+        log() << "recover using " << numThreads << " threads";
+        _workers = stdx::make_unique<WorkerPool>(numThreads);
+    }
+    // Stop the workers however recovery ends. Nothing is scheduled on them once go() returns.
+    ON_BLOCK_EXIT([this] { _workers.reset(); });
+
     for (unsigned i = 0; i != files.size(); ++i) {
         bool abruptEnd = processFile(files[i]);
         if (abruptEnd && i + 1 < files.size()) {
@@ -588,7 +981,12 @@ void RecoveryJob::go(vector<boost::filesystem::path>& files) {
               << "Last skipped sections had sequence number " << _lastSeqSkipped;
     }
 
-    close();
+    {
+        Timer flushTimer;
+        close();
+        _stats.flushMicros = flushTimer.micros();
+    }
+    _logRecoveryStats(timer.micros());
 
     if (mmapv1GlobalOptions.journalOptions & MMAPV1Options::JournalScanOnly) {
         uasserted(13545,
@@ -603,6 +1001,22 @@ void RecoveryJob::go(vector<boost::filesystem::path>& files) {
     _recovering = false;
 }
 
+void RecoveryJob::_logRecoveryStats(long long totalMicros) {
+    const double journalMB = _stats.journalBytes / (1024.0 * 1024.0);
+    const double dataFileMB = _stats.dataFileBytes / (1024.0 * 1024.0);
+    const double seconds = std::max(totalMicros, 1LL) / 1000000.0;
+
+    log() << "recover applied " << _stats.sectionsApplied << " and skipped "
+          << _stats.sectionsSkipped << " journal sections in " << totalMicros / 1000 << "ms: "
+          << journalMB << "MB of compressed journal at " << journalMB / seconds << "MB/s, "
+          << dataFileMB << "MB written to data files at " << dataFileMB / seconds << "MB/s, "
+          << _stats.parallelCopies << " batches of writes copied in parallel";
+    log() << "recover phase timings: decompressing " << _stats.decompressMicros.load() / 1000
+          << "ms (summed over threads), waiting for decompression " << _stats.waitMicros / 1000
+          << "ms, applying " << _stats.applyMicros / 1000 << "ms, flushing data files "
+          << _stats.flushMicros / 1000 << "ms";
+}
+
 void _recover() {
     verify(storageGlobalParams.dur);
 
@@ -33,8 +33,10 @@
 #include <boost/filesystem/operations.hpp>
 #include <list>
 #include <memory>
+#include <string>
 
 #include "mongo/db/storage/mmap_v1/dur_journalformat.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 
@@ -44,9 +46,15 @@ class DurableMappedFile;
 
 namespace dur {
 
+class JournalSectionIterator;
 struct ParsedJournalEntry;
 
 /** call go() to execute a recovery from existing journal files.
+ *
+ *  During recovery, journal sections are checksummed and decompressed on worker threads ahead of
+ *  being applied, and the writes of a section that target different data files are copied in
+ *  parallel. Sections are still applied one at a time, in order. The number of threads is set by
+ *  the journalRecoveryThreads server parameter.
  */
 class RecoveryJob {
     MONGO_DISALLOW_COPYING(RecoveryJob);
@@ -68,6 +76,9 @@ public:
     }
 
 private:
+    class SectionPipeline;
+    class WorkerPool;
+
     class Last {
     public:
         Last();
@@ -81,8 +92,19 @@ private:
 
 
     void write(Last& last, const ParsedJournalEntry& entry);  // actually writes to the file
+    // Opens the data file a basic write goes to and checks that the write fits in it. Returns
+    // null if it does not fit and we are recovering, in which case the write is skipped.
+    DurableMappedFile* _fileForWrite(Last& last, const ParsedJournalEntry& entry);
     void applyEntry(Last& last, const ParsedJournalEntry& entry, bool apply, bool dump);
     void applyEntries(const std::vector<ParsedJournalEntry>& entries);
+    void _applyEntriesInParallel(const std::vector<ParsedJournalEntry>& entries);
+    void _applySection(JournalSectionIterator* i);
+    // Applies a recovered section whose checksum was verified and which was decompressed by the
+    // SectionPipeline.
+    void _processDecompressedSection(const JSectHeader& h, std::string uncompressed);
+    // Returns false if the section was already synced to the data files before the crash.
+    bool _shouldApplySection(const JSectHeader& h);
+    void _logRecoveryStats(long long totalMicros);
     bool processFileBuffer(const void*, unsigned len);
     bool processFile(boost::filesystem::path journalfile);
     void _close();  // doesn't lock
@@ -99,6 +121,22 @@ private:
     unsigned long long _lastSeqSkipped;
     bool _appliedAnySections;
 
+    // Only set while recovering, and only if recovery may use more than one thread.
+    std::unique_ptr<WorkerPool> _workers;
+
+    // Work done by recovery, logged when it completes.
+    struct Stats {
+        unsigned long long sectionsApplied = 0;
+        unsigned long long sectionsSkipped = 0;
+        unsigned long long journalBytes = 0;      // Compressed size of all sections read.
+        unsigned long long dataFileBytes = 0;     // Bytes copied into the data files.
+        unsigned long long parallelCopies = 0;    // Batches of writes copied by the workers.
+        AtomicUInt64 decompressMicros;            // Summed over the threads that decompressed.
+        unsigned long long waitMicros = 0;        // Spent waiting for a section's decompression.
+        unsigned long long applyMicros = 0;       // Spent applying writes and operations.
+        unsigned long long flushMicros = 0;       // Spent flushing the data files at the end.
+    } _stats;
+
 
     static RecoveryJob& _instance;
 };
@@ -71,6 +71,15 @@ struct Stats {
         uint64_t _remapPrivateViewMicros;
         uint64_t _commitsMicros;
         uint64_t _commitsInWriteLockMicros;
+
+        // Power of two histograms of how many threads were waiting on each group commit and of
+        // how long each of them waited for its commit to start. Bucket 0 counts zeroes and bucket
+        // i > 0 counts values in [2^(i-1), 2^i). The last bucket also counts everything larger.
+        enum { NumHistogramBuckets = 24 };
+        uint64_t _commitBatchSizes[NumHistogramBuckets];
+        uint64_t _commitWaitMicros[NumHistogramBuckets];
+
+        static void _addToHistogram(uint64_t* histogram, uint64_t value);
     };
 
 
@@ -248,6 +248,25 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Looks up each of 'ids', which must be in ascending order, and appends one entry per id to
+     * 'out': the Record, with owned data, or boost::none if there is no record with that id.
+     *
+     * Engines where visiting records in id order is cheaper than independent lookups should
+     * override this. The default calls seekExact() for each id. The resulting position of the
+     * cursor is unspecified.
+     */
+    virtual void seekExactBatch(const std::vector<RecordId>& ids,
+                                std::vector<boost::optional<Record>>* out) {
+        for (const auto& id : ids) {
+            auto record = seekExact(id);
+            if (record) {
+                record->data.makeOwned();
+            }
+            out->push_back(std::move(record));
+        }
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -33,6 +33,7 @@
 #include "mongo/db/storage/record_store_test_harness.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/record_id.h"
@@ -442,4 +443,78 @@ TEST(RecordStoreTestHarness, SeekAfterEofAndContinue) {
     ASSERT(!cursor->next());
 }
 
+// Insert records, and look up a sorted subset of them with seekExactBatch(), including ids that
+// are close together and far apart. On engines with document-level locking, also look up removed
+// records.
+TEST(RecordStoreTestHarness, SeekExactBatch) {
+    unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    const int nToInsert = 200;
+    RecordId locs[nToInsert];
+    std::string datas[nToInsert];
+    for (int i = 0; i < nToInsert; i++) {
+        StringBuilder sb;
+        sb << "record " << i;
+        string data = sb.str();
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, false);
+        ASSERT_OK(res.getStatus());
+        locs[i] = res.getValue();
+        datas[i] = data;
+        uow.commit();
+    }
+
+    const bool lookUpRemoved = harnessHelper->supportsDocLocking();
+    if (lookUpRemoved) {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 5; i < nToInsert; i += 10) {
+            rs->deleteRecord(opCtx.get(), locs[i]);
+        }
+        uow.commit();
+    }
+
+    std::vector<int> indexes;
+    for (int i = 0; i < nToInsert; i++) {
+        // Look up runs of nearby records separated by larger gaps.
+        if (i % 50 < 12 && (lookUpRemoved || i % 10 != 5)) {
+            indexes.push_back(i);
+        }
+    }
+    std::sort(indexes.begin(), indexes.end(), [&](int lhs, int rhs) {
+        return locs[lhs] < locs[rhs];
+    });
+
+    std::vector<RecordId> ids;
+    for (int i : indexes) {
+        ids.push_back(locs[i]);
+    }
+
+    auto cursor = rs->getCursor(opCtx.get());
+    std::vector<boost::optional<Record>> records;
+    cursor->seekExactBatch(ids, &records);
+    ASSERT_EQUALS(ids.size(), records.size());
+
+    for (size_t j = 0; j < indexes.size(); j++) {
+        const int i = indexes[j];
+        if (i % 10 == 5) {
+            ASSERT(!records[j]);
+            continue;
+        }
+        ASSERT(records[j]);
+        ASSERT_EQUALS(locs[i], records[j]->id);
+        ASSERT(records[j]->data.isOwned());
+        ASSERT_EQUALS(datas[i], records[j]->data.data());
+    }
+
+    // The cursor can still be used for single lookups.
+    const auto record = cursor->seekExact(locs[0]);
+    ASSERT(record);
+    ASSERT_EQUALS(datas[0], record->data.data());
+}
+
 }  // namespace mongo
@@ -34,6 +34,8 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/db/storage/key_string_set.h"
+#include "mongo/util/assert_util.h"
 
 #pragma once
 
@@ -112,6 +114,36 @@ public:
                          const RecordId& loc,
                          bool dupsAllowed) = 0;
 
+    /**
+     * Return the KeyString version this index stores its keys in, if it can take keys already
+     * encoded by insertKeyString() and unindexKeyString(), and boost::none otherwise.
+     */
+    virtual boost::optional<KeyString::Version> getKeyStringVersion() const {
+        return boost::none;
+    }
+
+    /**
+     * Same as insert(), but with the key already encoded, without a RecordId, in the version
+     * returned by getKeyStringVersion(). Only called if that returned a version.
+     */
+    virtual Status insertKeyString(OperationContext* txn,
+                                   const KeyStringSet::Key& key,
+                                   const RecordId& loc,
+                                   bool dupsAllowed) {
+        MONGO_UNREACHABLE;
+    }
+
+    /**
+     * Same as unindex(), but with the key already encoded, without a RecordId, in the version
+     * returned by getKeyStringVersion(). Only called if that returned a version.
+     */
+    virtual void unindexKeyString(OperationContext* txn,
+                                  const KeyStringSet::Key& key,
+                                  const RecordId& loc,
+                                  bool dupsAllowed) {
+        MONGO_UNREACHABLE;
+    }
+
     /**
      * Return ErrorCodes::DuplicateKey if 'key' already exists in 'this'
      * index at a RecordId other than 'loc', and Status::OK() otherwise.
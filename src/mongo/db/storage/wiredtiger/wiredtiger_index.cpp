@@ -117,6 +117,14 @@ Status checkKeySize(const BSONObj& key) {
     return Status::OK();
 }
 
+Status checkKeySize(const KeyStringSet::Key& key) {
+    if (key.getBSONSize() >= TempKeyMaxSize) {
+        // Only decode the key for the error message.
+        return checkKeySize(key.toBson());
+    }
+    return Status::OK();
+}
+
 }  // namespace
 
 Status WiredTigerIndex::dupKeyError(const BSONObj& key) {
@@ -255,11 +263,30 @@ Status WiredTigerIndex::insert(OperationContext* txn,
     if (!s.isOK())
         return s;
 
+    const KeyString data(_keyStringVersion, key, _ordering);
+
     WiredTigerCursor curwrap(_uri, _tableId, false, txn);
     curwrap.assertInActiveTxn();
     WT_CURSOR* c = curwrap.get();
 
-    return _insert(c, key, id, dupsAllowed);
+    return _insert(c, data.getBuffer(), data.getSize(), data.getTypeBits(), id, dupsAllowed);
+}
+
+Status WiredTigerIndex::insertKeyString(OperationContext* txn,
+                                        const KeyStringSet::Key& key,
+                                        const RecordId& id,
+                                        bool dupsAllowed) {
+    invariant(id.isNormal());
+
+    Status s = checkKeySize(key);
+    if (!s.isOK())
+        return s;
+
+    WiredTigerCursor curwrap(_uri, _tableId, false, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    return _insert(c, key.getBuffer(), key.getSize(), key.getTypeBits(), id, dupsAllowed);
 }
 
 void WiredTigerIndex::unindex(OperationContext* txn,
@@ -269,12 +296,28 @@ void WiredTigerIndex::unindex(OperationContext* txn,
     invariant(id.isNormal());
     dassert(!hasFieldNames(key));
 
+    const KeyString data(_keyStringVersion, key, _ordering);
+
+    WiredTigerCursor curwrap(_uri, _tableId, false, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+
+    _unindex(c, data.getBuffer(), data.getSize(), data.getTypeBits(), id, dupsAllowed);
+}
+
+void WiredTigerIndex::unindexKeyString(OperationContext* txn,
+                                       const KeyStringSet::Key& key,
+                                       const RecordId& id,
+                                       bool dupsAllowed) {
+    invariant(id.isNormal());
+
     WiredTigerCursor curwrap(_uri, _tableId, false, txn);
     curwrap.assertInActiveTxn();
     WT_CURSOR* c = curwrap.get();
     invariant(c);
 
-    _unindex(c, key, id, dupsAllowed);
+    _unindex(c, key.getBuffer(), key.getSize(), key.getTypeBits(), id, dupsAllowed);
 }
 
 void WiredTigerIndex::fullValidate(OperationContext* txn,
@@ -1007,15 +1050,16 @@ SortedDataBuilderInterface* WiredTigerIndexUnique::getBulkBuilder(OperationConte
 }
 
 Status WiredTigerIndexUnique::_insert(WT_CURSOR* c,
-                                      const BSONObj& key,
+                                      const char* keyData,
+                                      size_t keySize,
+                                      const KeyString::TypeBits& typeBits,
                                       const RecordId& id,
                                       bool dupsAllowed) {
-    const KeyString data(keyStringVersion(), key, _ordering);
-    WiredTigerItem keyItem(data.getBuffer(), data.getSize());
+    WiredTigerItem keyItem(keyData, keySize);
 
     KeyString value(keyStringVersion(), id);
-    if (!data.getTypeBits().isAllZeros())
-        value.appendTypeBits(data.getTypeBits());
+    if (!typeBits.isAllZeros())
+        value.appendTypeBits(typeBits);
 
     WiredTigerItem valueItem(value.getBuffer(), value.getSize());
     c->set_key(c, keyItem.Get());
@@ -1047,7 +1091,7 @@ Status WiredTigerIndexUnique::_insert(WT_CURSOR* c,
 
         if (!insertedId && id < idInIndex) {
             value.appendRecordId(id);
-            value.appendTypeBits(data.getTypeBits());
+            value.appendTypeBits(typeBits);
             insertedId = true;
         }
 
@@ -1057,12 +1101,12 @@ Status WiredTigerIndexUnique::_insert(WT_CURSOR* c,
     }
 
     if (!dupsAllowed)
-        return dupKeyError(key);
+        return dupKeyError(_keyToBson(keyData, keySize, typeBits));
 
     if (!insertedId) {
         // This id is higher than all currently in the index for this key
         value.appendRecordId(id);
-        value.appendTypeBits(data.getTypeBits());
+        value.appendTypeBits(typeBits);
     }
 
     valueItem = WiredTigerItem(value.getBuffer(), value.getSize());
@@ -1071,11 +1115,12 @@ Status WiredTigerIndexUnique::_insert(WT_CURSOR* c,
 }
 
 void WiredTigerIndexUnique::_unindex(WT_CURSOR* c,
-                                     const BSONObj& key,
+                                     const char* keyData,
+                                     size_t keySize,
+                                     const KeyString::TypeBits& typeBits,
                                      const RecordId& id,
                                      bool dupsAllowed) {
-    KeyString data(keyStringVersion(), key, _ordering);
-    WiredTigerItem keyItem(data.getBuffer(), data.getSize());
+    WiredTigerItem keyItem(keyData, keySize);
     c->set_key(c, keyItem.Get());
 
     if (!dupsAllowed) {
@@ -1131,7 +1176,8 @@ void WiredTigerIndexUnique::_unindex(WT_CURSOR* c,
     }
 
     if (!foundId) {
-        warning().stream() << id << " not found in the index for key " << redact(key);
+        warning().stream() << id << " not found in the index for key "
+                           << redact(_keyToBson(keyData, keySize, typeBits));
         return;  // nothing to do
     }
 
@@ -1172,19 +1218,23 @@ SortedDataBuilderInterface* WiredTigerIndexStandard::getBulkBuilder(OperationCon
 }
 
 Status WiredTigerIndexStandard::_insert(WT_CURSOR* c,
-                                        const BSONObj& keyBson,
+                                        const char* keyData,
+                                        size_t keySize,
+                                        const KeyString::TypeBits& typeBits,
                                         const RecordId& id,
                                         bool dupsAllowed) {
     invariant(dupsAllowed);
 
-    TRACE_INDEX << " key: " << keyBson << " id: " << id;
+    TRACE_INDEX << " key: " << _keyToBson(keyData, keySize, typeBits) << " id: " << id;
 
-    KeyString key(keyStringVersion(), keyBson, _ordering, id);
+    KeyString key(keyStringVersion());
+    key.resetFromBuffer(keyData, keySize);
+    key.appendRecordId(id);
     WiredTigerItem keyItem(key.getBuffer(), key.getSize());
 
-    WiredTigerItem valueItem = key.getTypeBits().isAllZeros()
+    WiredTigerItem valueItem = typeBits.isAllZeros()
         ? emptyItem
-        : WiredTigerItem(key.getTypeBits().getBuffer(), key.getTypeBits().getSize());
+        : WiredTigerItem(typeBits.getBuffer(), typeBits.getSize());
 
     c->set_key(c, keyItem.Get());
     c->set_value(c, valueItem.Get());
@@ -1199,11 +1249,15 @@ Status WiredTigerIndexStandard::_insert(WT_CURSOR* c,
 }
 
 void WiredTigerIndexStandard::_unindex(WT_CURSOR* c,
-                                       const BSONObj& key,
+                                       const char* keyData,
+                                       size_t keySize,
+                                       const KeyString::TypeBits& typeBits,
                                        const RecordId& id,
                                        bool dupsAllowed) {
     invariant(dupsAllowed);
-    KeyString data(keyStringVersion(), key, _ordering, id);
+    KeyString data(keyStringVersion());
+    data.resetFromBuffer(keyData, keySize);
+    data.appendRecordId(id);
     WiredTigerItem item(data.getBuffer(), data.getSize());
     c->set_key(c, item.Get());
     int ret = WT_OP_CHECK(c->remove(c));
@@ -90,6 +90,20 @@ public:
                          const RecordId& id,
                          bool dupsAllowed);
 
+    boost::optional<KeyString::Version> getKeyStringVersion() const override {
+        return _keyStringVersion;
+    }
+
+    Status insertKeyString(OperationContext* txn,
+                           const KeyStringSet::Key& key,
+                           const RecordId& id,
+                           bool dupsAllowed) override;
+
+    void unindexKeyString(OperationContext* txn,
+                          const KeyStringSet::Key& key,
+                          const RecordId& id,
+                          bool dupsAllowed) override;
+
     virtual void fullValidate(OperationContext* txn,
                               long long* numKeysOut,
                               ValidateResults* fullResults) const;
@@ -130,16 +144,33 @@ public:
     Status dupKeyError(const BSONObj& key);
 
 protected:
+    /**
+     * 'keyData' and 'keySize' are the key's KeyString, without a RecordId, and 'typeBits' are its
+     * TypeBits.
+     */
     virtual Status _insert(WT_CURSOR* c,
-                           const BSONObj& key,
+                           const char* keyData,
+                           size_t keySize,
+                           const KeyString::TypeBits& typeBits,
                            const RecordId& id,
                            bool dupsAllowed) = 0;
 
     virtual void _unindex(WT_CURSOR* c,
-                          const BSONObj& key,
+                          const char* keyData,
+                          size_t keySize,
+                          const KeyString::TypeBits& typeBits,
                           const RecordId& id,
                           bool dupsAllowed) = 0;
 
+    /**
+     * Decodes a key passed to _insert() or _unindex(), for error messages and logging.
+     */
+    BSONObj _keyToBson(const char* keyData,
+                       size_t keySize,
+                       const KeyString::TypeBits& typeBits) const {
+        return KeyString::toBson(keyData, keySize, _ordering, typeBits);
+    }
+
     class BulkBuilder;
     class StandardBulkBuilder;
     class UniqueBulkBuilder;
@@ -169,9 +200,19 @@ public:
         return true;
     }
 
-    Status _insert(WT_CURSOR* c, const BSONObj& key, const RecordId& id, bool dupsAllowed) override;
-
-    void _unindex(WT_CURSOR* c, const BSONObj& key, const RecordId& id, bool dupsAllowed) override;
+    Status _insert(WT_CURSOR* c,
+                   const char* keyData,
+                   size_t keySize,
+                   const KeyString::TypeBits& typeBits,
+                   const RecordId& id,
+                   bool dupsAllowed) override;
+
+    void _unindex(WT_CURSOR* c,
+                  const char* keyData,
+                  size_t keySize,
+                  const KeyString::TypeBits& typeBits,
+                  const RecordId& id,
+                  bool dupsAllowed) override;
 };
 
 class WiredTigerIndexStandard : public WiredTigerIndex {
@@ -189,9 +230,19 @@ public:
         return false;
     }
 
-    Status _insert(WT_CURSOR* c, const BSONObj& key, const RecordId& id, bool dupsAllowed) override;
-
-    void _unindex(WT_CURSOR* c, const BSONObj& key, const RecordId& id, bool dupsAllowed) override;
+    Status _insert(WT_CURSOR* c,
+                   const char* keyData,
+                   size_t keySize,
+                   const KeyString::TypeBits& typeBits,
+                   const RecordId& id,
+                   bool dupsAllowed) override;
+
+    void _unindex(WT_CURSOR* c,
+                  const char* keyData,
+                  size_t keySize,
+                  const KeyString::TypeBits& typeBits,
+                  const RecordId& id,
+                  bool dupsAllowed) override;
 };
 
 }  // namespace
@@ -62,6 +62,8 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/exit.h"
@@ -122,6 +124,60 @@ private:
     std::atomic<bool> _shuttingDown{false};  // NOLINT
 };
 
+/**
+ * Periodically writes the changed collection sizes to the size storer table, so that neither
+ * reading the sizes of every collection nor the write to the table happen on a user operation.
+ */
+class WiredTigerKVEngine::WiredTigerSizeStorerFlusher : public BackgroundJob {
+public:
+    explicit WiredTigerSizeStorerFlusher(WiredTigerKVEngine* engine)
+        : BackgroundJob(false /* deleteSelf */), _engine(engine) {}
+
+    virtual string name() const {
+        return "WTSizeStorerFlusher";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!_shuttingDown) {
+            _shutdownRequested.wait_for(lk, kSyncPeriod.toSystemDuration());
+            if (_shuttingDown) {
+                break;
+            }
+
+            lk.unlock();
+            _engine->syncSizeInfo(false);
+            lk.lock();
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _shuttingDown = true;
+        }
+        _shutdownRequested.notify_one();
+        wait();
+    }
+
+private:
+    // Only the entries which changed are written, so a sync of mostly idle collections is cheap.
+    static const Seconds kSyncPeriod;
+
+    WiredTigerKVEngine* const _engine;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _shutdownRequested;
+    bool _shuttingDown = false;
+};
+
+const Seconds WiredTigerKVEngine::WiredTigerSizeStorerFlusher::kSyncPeriod(1);
+
 namespace {
 
 class TicketServerParameter : public ServerParameter {
@@ -183,7 +239,6 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     : _eventHandler(WiredTigerUtil::defaultEventHandlers()),
       _canonicalName(canonicalName),
       _path(path),
-      _sizeStorerSyncTracker(cs, 100000, Seconds(60)),
       _durable(durable),
       _ephemeral(ephemeral),
       _readOnly(readOnly) {
@@ -275,6 +330,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer.reset(new WiredTigerSizeStorer(_conn, _sizeStorerUri));
     _sizeStorer->fillCache();
 
+    if (!_readOnly) {
+        _sizeStorerFlusher = stdx::make_unique<WiredTigerSizeStorerFlusher>(this);
+        _sizeStorerFlusher->go();
+    }
+
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
 }
 
@@ -294,6 +354,10 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        {
+            BSONObjBuilder queueBuilder(bbb.subobjStart("queues"));
+            openWriteTransaction.appendPriorityStats(&queueBuilder);
+        }
         bbb.done();
     }
     {
@@ -301,6 +365,10 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        {
+            BSONObjBuilder queueBuilder(bbb.subobjStart("queues"));
+            openReadTransaction.appendPriorityStats(&queueBuilder);
+        }
         bbb.done();
     }
     bb.done();
@@ -308,6 +376,10 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
 
 void WiredTigerKVEngine::cleanShutdown() {
     log() << "WiredTigerKVEngine shutting down";
+    if (_sizeStorerFlusher) {
+        _sizeStorerFlusher->shutdown();
+        _sizeStorerFlusher.reset();
+    }
     if (!_readOnly)
         syncSizeInfo(true);
     if (_conn) {
@@ -430,6 +502,12 @@ void WiredTigerKVEngine::syncSizeInfo(bool sync) const {
     }
 }
 
+void WiredTigerKVEngine::appendSizeStorerStats(BSONObjBuilder* builder) const {
+    if (_sizeStorer) {
+        _sizeStorer->appendStats(builder);
+    }
+}
+
 RecoveryUnit* WiredTigerKVEngine::newRecoveryUnit() {
     return new WiredTigerRecoveryUnit(_sessionCache.get());
 }
@@ -575,11 +653,6 @@ bool WiredTigerKVEngine::haveDropsQueued() const {
     Date_t now = Date_t::now();
     Milliseconds delta = now - _previousCheckedDropsQueued;
 
-    if (!_readOnly && _sizeStorerSyncTracker.intervalHasElapsed()) {
-        _sizeStorerSyncTracker.resetLastTime();
-        syncSizeInfo(false);
-    }
-
     // We only want to check the queue max once per second or we'll thrash
     // This is done in haveDropsQueued, not dropSomeQueuedIdents so we skip the mutex
     if (delta < Milliseconds(1000))
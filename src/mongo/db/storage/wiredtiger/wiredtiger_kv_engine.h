@@ -40,7 +40,6 @@
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/util/elapsed_tracker.h"
 
 namespace mongo {
 
@@ -141,18 +140,33 @@ public:
 
     void syncSizeInfo(bool sync) const;
 
+    /**
+     * Appends statistics about writing the collection sizes to the size storer table.
+     */
+    void appendSizeStorerStats(BSONObjBuilder* builder) const;
+
     /**
      * Initializes a background job to remove excess documents in the oplog collections.
      * This applies to the capped collections in the local.oplog.* namespaces (specifically
-     * local.oplog.rs for replica sets and local.oplog.$main for master/slave replication).
-     * Returns true if a background job is running for the namespace.
+     * local.oplog.rs for replica sets and local.oplog.$main for master/slave replication), and to
+     * other capped collections when wiredTigerCappedBackgroundDeletion is enabled. The caller
+     * decides which namespaces need a job. Returns true if a background job is running for the
+     * namespace.
      */
     static bool initRsOplogBackgroundThread(StringData ns);
 
+    /**
+     * Called when a record store that initRsOplogBackgroundThread() returned true for is
+     * destroyed. Stops the background job of a capped collection other than the oplog once no
+     * record store for the namespace is left, so that recreating the collection starts a new job.
+     */
+    static void haltRsBackgroundThread(StringData ns);
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
 private:
     class WiredTigerJournalFlusher;
+    class WiredTigerSizeStorerFlusher;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -170,7 +184,7 @@ private:
 
     std::unique_ptr<WiredTigerSizeStorer> _sizeStorer;
     std::string _sizeStorerUri;
-    mutable ElapsedTracker _sizeStorerSyncTracker;
+    std::unique_ptr<WiredTigerSizeStorerFlusher> _sizeStorerFlusher;  // Depends on _sizeStorer
 
     bool _durable;
     bool _ephemeral;
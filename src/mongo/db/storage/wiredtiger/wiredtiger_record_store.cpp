@@ -44,6 +44,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -94,6 +95,10 @@ MONGO_FP_DECLARE(WTEmulateOutOfOrderNextRecordId);
 
 const std::string kWiredTigerEngineName = "wiredTiger";
 
+// Off by default because a collection using stones may exceed its maximum size by up to a stone's
+// worth of records until the background thread catches up.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerCappedBackgroundDeletion, bool, false);
+
 class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
 public:
     InsertChange(OplogStones* oplogStones,
@@ -152,7 +157,9 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* txn, WiredTige
     unsigned long long maxSize = rs->cappedMaxSize();
 
     const unsigned long long kMinStonesToKeep = 10ULL;
-    const unsigned long long kMaxStonesToKeep = 100ULL;
+    // Reclaiming a stone from a collection other than the oplog also unindexes every record in it
+    // within one transaction, so allow more, and thus smaller, stones for those collections.
+    const unsigned long long kMaxStonesToKeep = rs->isOplog() ? 100ULL : 1000ULL;
 
     unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
     _numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
@@ -289,7 +296,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* txn)
     long long numRecords = _rs->numRecords(txn);
     long long dataSize = _rs->dataSize(txn);
 
-    log() << "The size storer reports that the oplog contains " << numRecords
+    log() << "The size storer reports that " << _rs->ns() << " contains " << numRecords
           << " records totaling to " << dataSize << " bytes";
 
     // Only use sampling to estimate where to place the oplog stones if the number of samples drawn
@@ -315,7 +322,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* txn)
 }
 
 void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* txn) {
-    log() << "Scanning the oplog to determine where to place markers for truncation";
+    log() << "Scanning " << _rs->ns() << " to determine where to place markers for truncation";
 
     long long numRecords = 0;
     long long dataSize = 0;
@@ -325,8 +332,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationCon
         _currentRecords.addAndFetch(1);
         int64_t newCurrentBytes = _currentBytes.addAndFetch(record->data.size());
         if (newCurrentBytes >= _minBytesPerStone) {
-            LOG(1) << "Placing a marker at optime "
-                   << Timestamp(record->id.repr()).toStringPretty();
+            LOG(1) << "Placing a marker at " << _describe(record->id);
 
             OplogStones::Stone stone = {_currentRecords.swap(0), _currentBytes.swap(0), record->id};
             _stones.push_back(stone);
@@ -342,8 +348,8 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationCon
 void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationContext* txn,
                                                                     int64_t estRecordsPerStone,
                                                                     int64_t estBytesPerStone) {
-    Timestamp earliestOpTime;
-    Timestamp latestOpTime;
+    RecordId earliestRecord;
+    RecordId latestRecord;
 
     {
         const bool forward = true;
@@ -352,11 +358,12 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
         if (!record) {
             // This shouldn't really happen unless the size storer values are far off from reality.
             // The collection is probably empty, but fall back to scanning the oplog just in case.
-            log() << "Failed to determine the earliest optime, falling back to scanning the oplog";
+            log() << "Failed to determine the earliest record, falling back to scanning "
+                  << _rs->ns();
             _calculateStonesByScanning(txn);
             return;
         }
-        earliestOpTime = Timestamp(record->id.repr());
+        earliestRecord = record->id;
     }
 
     {
@@ -366,22 +373,23 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
         if (!record) {
             // This shouldn't really happen unless the size storer values are far off from reality.
             // The collection is probably empty, but fall back to scanning the oplog just in case.
-            log() << "Failed to determine the latest optime, falling back to scanning the oplog";
+            log() << "Failed to determine the latest record, falling back to scanning "
+                  << _rs->ns();
             _calculateStonesByScanning(txn);
             return;
         }
-        latestOpTime = Timestamp(record->id.repr());
+        latestRecord = record->id;
     }
 
-    log() << "Sampling from the oplog between " << earliestOpTime.toStringPretty() << " and "
-          << latestOpTime.toStringPretty() << " to determine where to place markers for truncation";
+    log() << "Sampling from " << _rs->ns() << " between " << _describe(earliestRecord) << " and "
+          << _describe(latestRecord) << " to determine where to place markers for truncation";
 
     int64_t wholeStones = _rs->numRecords(txn) / estRecordsPerStone;
     int64_t numSamples = kRandomSamplesPerStone * _rs->numRecords(txn) / estRecordsPerStone;
 
-    log() << "Taking " << numSamples << " samples and assuming that each section of oplog contains"
-          << " approximately " << estRecordsPerStone << " records totaling to " << estBytesPerStone
-          << " bytes";
+    log() << "Taking " << numSamples << " samples and assuming that each section of " << _rs->ns()
+          << " contains approximately " << estRecordsPerStone << " records totaling to "
+          << estBytesPerStone << " bytes";
 
     // Inform the random cursor of the number of samples we intend to take. This allows it to
     // account for skew in the tree shape.
@@ -398,7 +406,8 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
         if (!record) {
             // This shouldn't really happen unless the size storer values are far off from reality.
             // The collection is probably empty, but fall back to scanning the oplog just in case.
-            log() << "Failed to get enough random samples, falling back to scanning the oplog";
+            log() << "Failed to get enough random samples, falling back to scanning "
+                  << _rs->ns();
             _calculateStonesByScanning(txn);
             return;
         }
@@ -412,7 +421,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
         int sampleIndex = kRandomSamplesPerStone * i - 1;
         RecordId lastRecord = oplogEstimates[sampleIndex];
 
-        log() << "Placing a marker at optime " << Timestamp(lastRecord.repr()).toStringPretty();
+        log() << "Placing a marker at " << _describe(lastRecord);
         OplogStones::Stone stone = {estRecordsPerStone, estBytesPerStone, lastRecord};
         _stones.push_back(stone);
     }
@@ -422,6 +431,13 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
     _currentBytes.store(_rs->dataSize(txn) - estBytesPerStone * wholeStones);
 }
 
+std::string WiredTigerRecordStore::OplogStones::_describe(const RecordId& id) const {
+    if (_rs->isOplog()) {
+        return str::stream() << "optime " << Timestamp(id.repr()).toStringPretty();
+    }
+    return str::stream() << id;
+}
+
 void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
     if (hasExcessStones()) {
         _oplogReclaimCv.notify_one();
@@ -430,11 +446,22 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
 
 class WiredTigerRecordStore::Cursor final : public SeekableRecordCursor {
 public:
-    Cursor(OperationContext* txn, const WiredTigerRecordStore& rs, bool forward = true)
+    /**
+     * A forward cursor may be limited to the records in [rangeStart, rangeEnd). A null bound
+     * leaves that side of the range open.
+     */
+    Cursor(OperationContext* txn,
+           const WiredTigerRecordStore& rs,
+           bool forward = true,
+           RecordId rangeStart = RecordId(),
+           RecordId rangeEnd = RecordId())
         : _rs(rs),
           _txn(txn),
           _forward(forward),
-          _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()) {
+          _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()),
+          _rangeStart(rangeStart),
+          _rangeEnd(rangeEnd) {
+        invariant(_forward || (_rangeStart.isNull() && _rangeEnd.isNull()));
         _cursor.emplace(rs.getURI(), rs.tableId(), true, txn);
     }
 
@@ -468,6 +495,20 @@ public:
             }
         }
 
+        if (_lastReturnedId.isNull() && !_rangeStart.isNull()) {
+            c->set_key(c, _makeKey(_rangeStart));
+            int cmp;
+            int seekRet = WT_OP_CHECK(c->search_near(c, &cmp));
+            if (seekRet == WT_NOTFOUND) {
+                _eof = true;
+                return {};
+            }
+            invariantWTOK(seekRet);
+
+            // We may have landed on the record just before the start of the range.
+            mustAdvance = cmp < 0;
+        }
+
         if (mustAdvance) {
             // Nothing after the next line can throw WCEs.
             // Note that an unpositioned (or eof) WT_CURSOR returns the first/last entry in the
@@ -502,7 +543,7 @@ public:
             throw WriteConflictException();
         }
 
-        if (!isVisible(id)) {
+        if (!isVisible(id) || (!_rangeEnd.isNull() && id >= _rangeEnd)) {
             _eof = true;
             return {};
         }
@@ -534,6 +575,64 @@ public:
         return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
     }
 
+    void seekExactBatch(const std::vector<RecordId>& ids,
+                        std::vector<boost::optional<Record>>* out) final {
+        // When the next id is only a few ids past the current position, walking forward to it
+        // stays on the leaf page the cursor is already on rather than searching from the root.
+        // RecordIds are allocated sequentially, so the distance between two ids bounds the number
+        // of records between them.
+        const int64_t kMaxWalkDistance = 32;
+
+        _skipNextAdvance = false;
+        WT_CURSOR* c = _cursor->get();
+
+        // The id the cursor is positioned on, or null if it isn't positioned.
+        RecordId current;
+        for (const auto& id : ids) {
+            if (!current.isNull() && current <= id &&
+                id.repr() - current.repr() <= kMaxWalkDistance) {
+                while (current < id) {
+                    // Nothing after the next line can throw WCEs.
+                    int advanceRet = WT_OP_CHECK(c->next(c));
+                    if (advanceRet == WT_NOTFOUND) {
+                        current = RecordId();
+                        break;
+                    }
+                    invariantWTOK(advanceRet);
+
+                    int64_t key;
+                    invariantWTOK(c->get_key(c, &key));
+                    current = _fromKey(key);
+                }
+            } else {
+                c->set_key(c, _makeKey(id));
+                // Nothing after the next line can throw WCEs.
+                int seekRet = WT_OP_CHECK(c->search(c));
+                if (seekRet == WT_NOTFOUND) {
+                    current = RecordId();
+                } else {
+                    invariantWTOK(seekRet);
+                    current = id;
+                }
+            }
+
+            if (current != id) {
+                out->push_back(boost::none);
+                continue;
+            }
+
+            WT_ITEM value;
+            invariantWTOK(c->get_value(c, &value));
+
+            RecordData data(static_cast<const char*>(value.data), static_cast<int>(value.size));
+            out->push_back(Record{id, data.getOwned()});
+        }
+
+        // Like seekExact(), leave the cursor as though the last id had been looked up on its own.
+        _lastReturnedId = current;
+        _eof = current.isNull();
+    }
+
     void save() final {
         try {
             if (_cursor)
@@ -634,6 +733,10 @@ private:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
     const RecordId _readUntilForOplog;
+
+    // The range of records to return, if either bound is non-null.
+    const RecordId _rangeStart;
+    const RecordId _rangeEnd;
 };
 
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
@@ -810,7 +913,6 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
       _cappedDeleteCheckCount(0),
       _useOplogHack(shouldUseOplogHack(ctx, _uri)),
       _sizeStorer(sizeStorer),
-      _sizeStorerCounter(0),
       _shuttingDown(false) {
     Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
                                ctx, uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion)
@@ -852,8 +954,8 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
             _dataSize.store(0);
 
             do {
-                _numRecords.fetchAndAdd(1);
-                _dataSize.fetchAndAdd(record->data.size());
+                _numRecords.add(1);
+                _dataSize.add(record->data.size());
             } while ((record = cursor.next()));
         }
     } else {
@@ -865,7 +967,11 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
             _sizeStorer->onCreate(this, 0, 0);
     }
 
-    if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns)) {
+    // Capped collections with a maximum document count must stay exact, so they keep deleting on
+    // the insert path.
+    const bool useStones =
+        _isOplog || (_isCapped && _cappedMaxDocs == -1 && wiredTigerCappedBackgroundDeletion);
+    if (useStones && WiredTigerKVEngine::initRsOplogBackgroundThread(ns)) {
         _oplogStones = std::make_shared<OplogStones>(ctx, this);
     }
 }
@@ -883,6 +989,7 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
 
     if (_oplogStones) {
         _oplogStones->kill();
+        WiredTigerKVEngine::haltRsBackgroundThread(ns());
     }
 }
 
@@ -895,12 +1002,15 @@ bool WiredTigerRecordStore::inShutdown() const {
     return _shuttingDown;
 }
 
+// The counters are only approximate and may briefly drop below zero, for instance while a delete
+// and the rollback of an insert race. Rather than clamping them on every decrement, which would
+// need a consistent read of all the stripes, clamp what is reported.
 long long WiredTigerRecordStore::dataSize(OperationContext* txn) const {
-    return _dataSize.load();
+    return std::max(_dataSize.load(), int64_t(0));
 }
 
 long long WiredTigerRecordStore::numRecords(OperationContext* txn) const {
-    return _numRecords.load();
+    return std::max(_numRecords.load(), int64_t(0));
 }
 
 bool WiredTigerRecordStore::isCapped() const {
@@ -1222,7 +1332,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isNormal());
 
-        LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
+        LOG(1) << "Truncating " << ns() << " between " << _oplogStones->firstRecord << " and "
                << stone->lastRecord << " to remove approximately " << stone->records
                << " records totaling to " << stone->bytes << " bytes";
 
@@ -1232,6 +1342,26 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
         try {
             WriteUnitOfWork wuow(txn);
 
+            int64_t recordsRemoved = stone->records;
+            int64_t bytesRemoved = stone->bytes;
+            if (!_isOplog && _cappedCallback) {
+                // Let the collection unindex and invalidate the records before they are removed.
+                // Since every record is visited anyway, account for their exact number and size.
+                recordsRemoved = 0;
+                bytesRemoved = 0;
+
+                Cursor cursor(txn, *this, /*forward=*/true, _oplogStones->firstRecord);
+                while (auto record = cursor.next()) {
+                    if (record->id > stone->lastRecord) {
+                        break;
+                    }
+                    uassertStatusOK(
+                        _cappedCallback->aboutToDeleteCapped(txn, record->id, record->data));
+                    ++recordsRemoved;
+                    bytesRemoved += record->data.size();
+                }
+            }
+
             WiredTigerCursor startwrap(_uri, _tableId, true, txn);
             WT_CURSOR* start = startwrap.get();
             start->set_key(start, _makeKey(_oplogStones->firstRecord));
@@ -1241,8 +1371,8 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
             end->set_key(end, _makeKey(stone->lastRecord));
 
             invariantWTOK(session->truncate(session, nullptr, start, end, nullptr));
-            _changeNumRecords(txn, -stone->records);
-            _increaseDataSize(txn, -stone->bytes);
+            _changeNumRecords(txn, -recordsRemoved);
+            _increaseDataSize(txn, -bytesRemoved);
 
             wuow.commit();
 
@@ -1252,12 +1382,12 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
         } catch (const WriteConflictException& wce) {
-            LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
+            LOG(1) << "Caught WriteConflictException while truncating " << ns() << ", retrying";
         }
     }
 
-    LOG(1) << "Finished truncating the oplog, it now contains approximately " << _numRecords.load()
-           << " records totaling to " << _dataSize.load() << " bytes";
+    LOG(1) << "Finished truncating " << ns() << ", it now contains approximately "
+           << _numRecords.load() << " records totaling to " << _dataSize.load() << " bytes";
 }
 
 Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
@@ -1422,7 +1552,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* txn,
 
     int64_t old_length = old_value.size;
 
-    if (_oplogStones && len != old_length) {
+    if (_isOplog && _oplogStones && len != old_length) {
         return {ErrorCodes::IllegalOperation, "Cannot change the size of a document in the oplog"};
     }
 
@@ -1487,11 +1617,64 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursorWithOptions(
 
 std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors(
     OperationContext* txn) const {
-    std::vector<std::unique_ptr<RecordCursor>> cursors(1);
-    cursors[0] = stdx::make_unique<Cursor>(txn, *this, /*forward=*/true);
+    std::vector<std::unique_ptr<RecordCursor>> cursors;
+
+    // Split the table into ranges of roughly equal numbers of records. Callers such as
+    // parallelCollectionScan hand the ranges out round-robin, so more ranges than they have threads
+    // still balances well. Capped collections are left as a single range, since their visibility
+    // rules don't apply to a cursor starting in the middle.
+    const int64_t kMinRecordsPerRange = 1000;
+    const int64_t kMaxRanges = 64;
+    const int64_t numRanges =
+        _isCapped ? 1 : std::min<int64_t>(kMaxRanges, numRecords(txn) / kMinRecordsPerRange);
+
+    std::vector<RecordId> boundaries;
+    if (numRanges > 1) {
+        boundaries = _sampleRangeBoundaries(txn, numRanges);
+    }
+
+    RecordId rangeStart;
+    for (const auto& boundary : boundaries) {
+        cursors.push_back(stdx::make_unique<Cursor>(txn, *this, true, rangeStart, boundary));
+        rangeStart = boundary;
+    }
+    cursors.push_back(stdx::make_unique<Cursor>(txn, *this, true, rangeStart, RecordId()));
     return cursors;
 }
 
+std::vector<RecordId> WiredTigerRecordStore::_sampleRangeBoundaries(OperationContext* txn,
+                                                                    int64_t numRanges) const {
+    // Take a few random samples per range, and split at their quantiles. The ranges don't need to
+    // be exact, and this only costs a few random descents of the tree per range, not a scan.
+    const int64_t kSamplesPerRange = 10;
+
+    std::vector<RecordId> samples;
+    auto cursor = getRandomCursor(txn);
+    for (int64_t i = 0; i < numRanges * kSamplesPerRange; i++) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        samples.push_back(record->id);
+    }
+    std::sort(samples.begin(), samples.end());
+    samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+
+    // Each boundary is the first id of a range other than the first, so boundaries must be
+    // strictly increasing and can't be the smallest sample.
+    std::vector<RecordId> boundaries;
+    for (int64_t i = 1; i < numRanges; i++) {
+        const size_t index = samples.size() * i / numRanges;
+        if (index == 0 || index >= samples.size()) {
+            continue;
+        }
+        if (boundaries.empty() || boundaries.back() < samples[index]) {
+            boundaries.push_back(samples[index]);
+        }
+    }
+    return boundaries;
+}
+
 Status WiredTigerRecordStore::truncate(OperationContext* txn) {
     WiredTigerCursor startWrap(_uri, _tableId, true, txn);
     WT_CURSOR* start = startWrap.get();
@@ -1755,7 +1938,7 @@ public:
     NumRecordsChange(WiredTigerRecordStore* rs, int64_t diff) : _rs(rs), _diff(diff) {}
     virtual void commit() {}
     virtual void rollback() {
-        _rs->_numRecords.fetchAndAdd(-_diff);
+        _rs->_numRecords.add(-_diff);
     }
 
 private:
@@ -1765,8 +1948,7 @@ private:
 
 void WiredTigerRecordStore::_changeNumRecords(OperationContext* txn, int64_t diff) {
     txn->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
-    if (_numRecords.fetchAndAdd(diff) < 0)
-        _numRecords.store(std::max(diff, int64_t(0)));
+    _numRecords.add(diff);
 }
 
 class WiredTigerRecordStore::DataSizeChange : public RecoveryUnit::Change {
@@ -1786,12 +1968,10 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* txn, int64_t amo
     if (txn)
         txn->recoveryUnit()->registerChange(new DataSizeChange(this, amount));
 
-    if (_dataSize.fetchAndAdd(amount) < 0)
-        _dataSize.store(std::max(amount, int64_t(0)));
+    _dataSize.add(amount);
 
-    if (_sizeStorer && _sizeStorerCounter++ % 1000 == 0) {
-        _sizeStorer->storeToCache(_uri, _numRecords.load(), _dataSize.load());
-    }
+    // The size storer reads the current sizes of this record store when it flushes, so there is
+    // nothing to tell it here.
 }
 
 int64_t WiredTigerRecordStore::_makeKey(const RecordId& id) {
@@ -40,6 +40,7 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/striped_counter.h"
 #include "mongo/util/fail_point_service.h"
 
 /**
@@ -56,6 +57,11 @@ class WiredTigerRecoveryUnit;
 class WiredTigerSizeStorer;
 
 extern const std::string kWiredTigerEngineName;
+
+// When true, capped collections without a maximum document count keep oplog stones and have their
+// oldest records removed in bulk by a background thread instead of on the insert path.
+extern bool wiredTigerCappedBackgroundDeletion;
+
 typedef std::list<RecordId> SortedRecordIds;
 
 class WiredTigerRecordStore final : public RecordStore {
@@ -153,6 +159,10 @@ public:
     std::unique_ptr<RecordCursor> getRandomCursorWithOptions(OperationContext* txn,
                                                              StringData extraConfig) const;
 
+    /**
+     * Returns cursors over disjoint ranges of RecordIds, split at the quantiles of a random sample
+     * so that each range holds about as many records.
+     */
     std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* txn) const final;
 
     virtual Status truncate(OperationContext* txn);
@@ -221,6 +231,9 @@ public:
 
     bool inShutdown() const;
 
+    // Removes the records covered by any excess stones. Records of capped collections other than
+    // the oplog are passed to the capped callback before they are truncated, so that they are also
+    // removed from the collection's indexes.
     void reclaimOplog(OperationContext* txn);
 
     int64_t cappedDeleteAsNeeded(OperationContext* txn, const RecordId& justInserted);
@@ -231,7 +244,8 @@ public:
         return _cappedDeleterMutex;
     }
 
-    // Returns false if the oplog was dropped while waiting for a deletion request.
+    // Returns false if the oplog, or other capped collection using stones, was dropped while
+    // waiting for a deletion request.
     bool yieldAndAwaitOplogDeletionRequest(OperationContext* txn);
 
     class OplogStones;
@@ -259,6 +273,12 @@ private:
 
     Status _insertRecords(OperationContext* txn, Record* records, size_t nRecords);
 
+    /**
+     * Returns up to 'numRanges' - 1 increasing RecordIds that split the table into ranges of
+     * roughly equal numbers of records, based on a random sample of the table.
+     */
+    std::vector<RecordId> _sampleRangeBoundaries(OperationContext* txn, int64_t numRanges) const;
+
     RecordId _nextId();
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
@@ -298,15 +318,18 @@ private:
     mutable stdx::mutex _uncommittedRecordIdsMutex;
 
     AtomicInt64 _nextIdNum;
-    AtomicInt64 _dataSize;
-    AtomicInt64 _numRecords;
+
+    // Every insert and delete changes these, so they are striped to keep concurrent writers to
+    // the same collection off a shared cache line. The size storer reads them when it flushes.
+    StripedCounter _dataSize;
+    StripedCounter _numRecords;
 
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
-    int _sizeStorerCounter;
 
     bool _shuttingDown;
 
-    // Non-null if this record store is underlying the active oplog.
+    // Non-null if this record store is underlying the active oplog, or is a capped collection
+    // whose excess records are deleted in the background (see wiredTigerCappedBackgroundDeletion).
     std::shared_ptr<OplogStones> _oplogStones;
 };
 
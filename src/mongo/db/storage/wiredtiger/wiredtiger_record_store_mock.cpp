@@ -32,7 +32,6 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/init.h"
-#include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
@@ -42,9 +41,12 @@ namespace mongo {
 
 // static
 bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
-    return NamespaceString::oplog(ns);
+    return true;
 }
 
+// static
+void WiredTigerKVEngine::haltRsBackgroundThread(StringData ns) {}
+
 MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
     setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
     return Status::OK();
@@ -31,7 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
-#include <set>
+#include <map>
+#include <memory>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/db/catalog/collection.h"
@@ -44,6 +45,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -53,13 +55,23 @@ namespace mongo {
 
 namespace {
 
-std::set<NamespaceString> _backgroundThreadNamespaces;
+struct BackgroundThreadState {
+    // Tells the thread to stop.
+    std::shared_ptr<AtomicWord<bool>> stopped;
+
+    // Record stores for the namespace that rely on the thread. A database that is closed and
+    // reopened may build the new record store before destroying the old one.
+    int numRecordStores = 0;
+};
+
+std::map<NamespaceString, BackgroundThreadState> _backgroundThreadNamespaces;
 stdx::mutex _backgroundThreadMutex;
 
 class WiredTigerRecordStoreThread : public BackgroundJob {
 public:
-    WiredTigerRecordStoreThread(const NamespaceString& ns)
-        : BackgroundJob(true /* deleteSelf */), _ns(ns) {
+    WiredTigerRecordStoreThread(const NamespaceString& ns,
+                                std::shared_ptr<AtomicWord<bool>> stopped)
+        : BackgroundJob(true /* deleteSelf */), _ns(ns), _stopped(std::move(stopped)) {
         _name = std::string("WT RecordStoreThread: ") + _ns.toString();
     }
 
@@ -68,7 +80,7 @@ public:
     }
 
     /**
-     * Returns true iff there was an oplog to delete from.
+     * Returns true iff there was a collection to delete from.
      */
     bool _deleteExcessDocuments() {
         if (!getGlobalServiceContext()->getGlobalStorageEngine()) {
@@ -85,7 +97,7 @@ public:
             AutoGetDb autoDb(&txn, _ns.db(), MODE_IX);
             Database* db = autoDb.getDb();
             if (!db) {
-                LOG(2) << "no local database yet";
+                LOG(2) << "no database " << _ns.db();
                 return false;
             }
 
@@ -101,7 +113,7 @@ public:
                 checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
 
             if (!rs->yieldAndAwaitOplogDeletionRequest(&txn)) {
-                return false;  // Oplog went away.
+                return false;  // Collection went away.
             }
             rs->reclaimOplog(&txn);
         } catch (const std::exception& e) {
@@ -116,7 +128,7 @@ public:
     virtual void run() {
         Client::initThread(_name.c_str());
 
-        while (!inShutdown()) {
+        while (!inShutdown() && !_stopped->load()) {
             if (!_deleteExcessDocuments()) {
                 sleepmillis(1000);  // Back off in case there were problems deleting.
             }
@@ -126,16 +138,17 @@ public:
 private:
     NamespaceString _ns;
     std::string _name;
+
+    // Set by haltRsBackgroundThread() once no record store for the namespace is left. A
+    // missing database or collection alone is not a reason to stop, since both are briefly absent
+    // during startup and while a database is closed and reopened.
+    const std::shared_ptr<AtomicWord<bool>> _stopped;
 };
 
 }  // namespace
 
 // static
 bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
-    if (!NamespaceString::oplog(ns)) {
-        return false;
-    }
-
     if (storageGlobalParams.repair) {
         LOG(1) << "not starting WiredTigerRecordStoreThread for " << ns
                << " because we are in repair";
@@ -144,15 +157,36 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
 
     stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
     NamespaceString nss(ns);
-    if (_backgroundThreadNamespaces.count(nss)) {
+    BackgroundThreadState& state = _backgroundThreadNamespaces[nss];
+    if (state.stopped) {
         log() << "WiredTigerRecordStoreThread " << ns << " already started";
     } else {
         log() << "Starting WiredTigerRecordStoreThread " << ns;
-        BackgroundJob* backgroundThread = new WiredTigerRecordStoreThread(nss);
+        state.stopped = std::make_shared<AtomicWord<bool>>(false);
+        BackgroundJob* backgroundThread = new WiredTigerRecordStoreThread(nss, state.stopped);
         backgroundThread->go();
-        _backgroundThreadNamespaces.insert(nss);
     }
+    ++state.numRecordStores;
     return true;
 }
 
+// static
+void WiredTigerKVEngine::haltRsBackgroundThread(StringData ns) {
+    NamespaceString nss(ns);
+    if (nss.isOplog()) {
+        // The oplog's thread waits for a new oplog to appear.
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
+    auto it = _backgroundThreadNamespaces.find(nss);
+    if (it == _backgroundThreadNamespaces.end() || --it->second.numRecordStores > 0) {
+        return;
+    }
+
+    LOG(1) << "Stopping WiredTigerRecordStoreThread " << ns;
+    it->second.stopped->store(true);
+    _backgroundThreadNamespaces.erase(it);
+}
+
 }  // namespace mongo
@@ -41,8 +41,8 @@ namespace mongo {
 class OperationContext;
 class RecordId;
 
-// Keep "milestones" against the oplog to efficiently remove the old records when the collection
-// grows beyond its desired maximum size.
+// Keep "milestones" against the oplog, or another capped collection, to efficiently remove the old
+// records when the collection grows beyond its desired maximum size.
 class WiredTigerRecordStore::OplogStones {
 public:
     struct Stone {
@@ -116,6 +116,9 @@ private:
                                     int64_t estRecordsPerStone,
                                     int64_t estBytesPerStone);
 
+    // Formats 'id' for logging, as an optime if the record store is the oplog.
+    std::string _describe(const RecordId& id) const;
+
     void _pokeReclaimThreadIfNeeded();
 
     static const uint64_t kRandomSamplesPerStone = 10;
@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -48,6 +49,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -384,6 +386,68 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+TEST(WiredTigerRecordStoreTest, SizeStorerSyncsOnlyChangedSizes) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+    rs.reset(NULL);
+
+    WiredTigerSizeStorer ss(harnessHelper->conn(), "table:sizeStorer");
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs.reset(new WiredTigerRecordStore(
+            opCtx.get(), "a.b", uri, kWiredTigerEngineName, false, false, -1, -1, NULL, &ss));
+    }
+
+    auto entriesWritten = [&ss] {
+        BSONObjBuilder builder;
+        ss.appendStats(&builder);
+        return builder.obj()["entriesWritten"].numberLong();
+    };
+
+    auto insertRecords = [&](int n) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < n; i++) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), "abc", 4, false).getStatus());
+        }
+        uow.commit();
+    };
+
+    // Registering the record store makes its entry dirty.
+    ss.syncCache(false);
+    ASSERT_EQUALS(1, entriesWritten());
+
+    // Inserts are not reported to the size storer, but the sync reads the new sizes.
+    insertRecords(10);
+    ss.syncCache(false);
+    ASSERT_EQUALS(2, entriesWritten());
+
+    long long numRecords;
+    long long dataSize;
+    ss.loadFromCache(uri, &numRecords, &dataSize);
+    ASSERT_EQUALS(10, numRecords);
+    ASSERT_EQUALS(40, dataSize);
+
+    // Nothing changed, so nothing is written.
+    ss.syncCache(false);
+    ASSERT_EQUALS(2, entriesWritten());
+
+    insertRecords(1);
+    ss.syncCache(false);
+    ASSERT_EQUALS(3, entriesWritten());
+
+    {
+        WiredTigerSizeStorer ss2(harnessHelper->conn(), "table:sizeStorer");
+        ss2.fillCache();
+        ss2.loadFromCache(uri, &numRecords, &dataSize);
+        ASSERT_EQUALS(11, numRecords);
+        ASSERT_EQUALS(44, dataSize);
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
 namespace {
 
 class GoodValidateAdaptor : public ValidateAdaptor {
@@ -983,6 +1047,45 @@ TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     ASSERT(!cursor->next());
 }
 
+// Check that getManyCursors() splits a large table into several ranges which, between them,
+// return every record exactly once, in order, and keep their bounds across a yield.
+TEST(WiredTigerRecordStoreTest, GetManyCursorsSplitsIntoRanges) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore("a.b"));
+
+    const int nToInsert = 10000;
+    std::set<RecordId> remain;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < nToInsert; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, false);
+            ASSERT_OK(res.getStatus());
+            remain.insert(res.getValue());
+        }
+        uow.commit();
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursors = rs->getManyCursors(opCtx.get());
+    ASSERT_GT(cursors.size(), 1U);
+
+    for (auto&& cursor : cursors) {
+        RecordId last;
+        while (auto record = cursor->next()) {
+            ASSERT_LT(last, record->id);
+            ASSERT_EQ(remain.erase(record->id), size_t(1));
+            last = record->id;
+
+            cursor->save();
+            opCtx->recoveryUnit()->abandonSnapshot();
+            ASSERT_TRUE(cursor->restore());
+        }
+        ASSERT(!cursor->next());
+    }
+    ASSERT(remain.empty());
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
@@ -1470,4 +1573,89 @@ TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
     }
 }
 
+
+class RecordingCappedCallback : public CappedCallback {
+public:
+    Status aboutToDeleteCapped(OperationContext* txn, const RecordId& loc, RecordData data) final {
+        deleted.push_back(loc);
+        return Status::OK();
+    }
+
+    void notifyCappedWaitersIfNeeded() final {}
+
+    std::vector<RecordId> deleted;
+};
+
+// Capped collections other than the oplog only use stones when background deletion is enabled, and
+// then leave their excess records for the background thread instead of deleting them on insert.
+TEST(WiredTigerRecordStoreTest, CappedStones_ReclaimInBackground) {
+    wiredTigerCappedBackgroundDeletion = true;
+    ON_BLOCK_EXIT([] { wiredTigerCappedBackgroundDeletion = false; });
+
+    WiredTigerHarnessHelper harnessHelper;
+
+    const int64_t cappedMaxSize = 256;
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("a.b", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    ASSERT(oplogStones);
+
+    oplogStones->setMinBytesPerStone(100);
+    oplogStones->setNumStonesToKeep(2U);
+
+    RecordingCappedCallback callback;
+    wtrs->setCappedCallback(&callback);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        for (int i = 1; i <= 5; ++i) {
+            BSONObj obj = makeBSONObjWithSize(Timestamp(1, i), 100);
+            WriteUnitOfWork wuow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false);
+            ASSERT_OK(res.getStatus());
+            ASSERT_EQ(RecordId(i), res.getValue());
+            wuow.commit();
+        }
+
+        // Nothing is deleted on the insert path, even though the collection is over its size.
+        ASSERT_EQ(5, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(500, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(5U, oplogStones->numStones());
+        ASSERT(callback.deleted.empty());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(200, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+
+        std::vector<RecordId> expectedDeleted = {RecordId(1), RecordId(2), RecordId(3)};
+        ASSERT(expectedDeleted == callback.deleted);
+
+        auto cursor = rs->getCursor(opCtx.get());
+        ASSERT_EQ(RecordId(4), cursor->next()->id);
+        ASSERT_EQ(RecordId(5), cursor->next()->id);
+        ASSERT(!cursor->next());
+    }
+}
+
+// Capped collections with a maximum document count keep deleting on the insert path.
+TEST(WiredTigerRecordStoreTest, CappedStones_NotUsedWithMaxDocs) {
+    wiredTigerCappedBackgroundDeletion = true;
+    ON_BLOCK_EXIT([] { wiredTigerCappedBackgroundDeletion = false; });
+
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("a.b", 10000, 5));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    ASSERT(!wtrs->oplogStones());
+}
+
 }  // namespace mongo
@@ -75,6 +75,11 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* txn,
     }
 
     WiredTigerKVEngine::appendGlobalStats(bob);
+    {
+        BSONObjBuilder sizeStorerBuilder(bob.subobjStart("sizeStorer"));
+        _engine->appendSizeStorerStats(&sizeStorerBuilder);
+    }
+    WiredTigerRecoveryUnit::get(txn)->getSessionCache()->appendStats(&bob);
 
     return bob.obj();
 }
@@ -35,7 +35,15 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+#include <functional>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -78,16 +86,21 @@ WiredTigerSession::~WiredTigerSession() {
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool forRecordStore) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            _cursorsCached--;
-            return c;
-        }
+    auto indexIt = _cursorIndex.find(id);
+    if (indexIt != _cursorIndex.end() && indexIt->second != _cursors.end()) {
+        CursorCache::iterator i = indexIt->second;
+        indexIt->second = i->_olderForTable;
+        if (i->_olderForTable != _cursors.end())
+            i->_olderForTable->_newerForTable = _cursors.end();
+        WT_CURSOR* c = i->_cursor;
+        _cursors.erase(i);
+        _cursorsOut++;
+        _cursorsCached--;
+        _cursorCacheHits++;
+        return c;
     }
 
+    _cursorCacheMisses++;
     WT_CURSOR* c = NULL;
     int ret = _session->open_cursor(
         _session, uri.c_str(), NULL, forRecordStore ? "" : "overwrite=false", &c);
@@ -106,7 +119,16 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
     invariantWTOK(cursor->reset(cursor));
 
     // Cursors are pushed to the front of the list and removed from the back
-    _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor, _cursors.end()));
+    auto indexIt = _cursorIndex.find(id);
+    if (indexIt == _cursorIndex.end()) {
+        indexIt = _cursorIndex.emplace(id, _cursors.end()).first;
+    }
+    if (indexIt->second != _cursors.end()) {
+        indexIt->second->_newerForTable = _cursors.begin();
+        _cursors.front()._olderForTable = indexIt->second;
+    }
+    indexIt->second = _cursors.begin();
     _cursorsCached++;
 
     // "Old" is defined as not used in the last N**2 operations, if we have N cursors cached.
@@ -116,6 +138,16 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
     // in between use.
     while (_cursorGen - _cursors.back()._gen > 10000) {
         cursor = _cursors.back()._cursor;
+
+        // The oldest cursor overall is also the oldest one cached for its table.
+        const WiredTigerCachedCursor& oldest = _cursors.back();
+        invariant(oldest._olderForTable == _cursors.end());
+        if (oldest._newerForTable != _cursors.end()) {
+            oldest._newerForTable->_olderForTable = _cursors.end();
+        } else {
+            _cursorIndex.erase(oldest._id);
+        }
+
         _cursors.pop_back();
         _cursorsCached--;
         invariantWTOK(cursor->close(cursor));
@@ -131,11 +163,16 @@ void WiredTigerSession::closeAllCursors() {
         }
     }
     _cursors.clear();
+    _cursorIndex.clear();
     _cursorEpoch = _cache->getCursorEpoch();
 }
 
 namespace {
 AtomicUInt64 nextTableId(1);
+
+size_t numSessionCachePartitions() {
+    return std::max(1U, stdx::thread::hardware_concurrency());
+}
 }
 // static
 uint64_t WiredTigerSession::genTableId() {
@@ -145,10 +182,16 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _snapshotManager(_conn), _shuttingDown(0) {}
+    : WiredTigerSessionCache(engine->getConnection()) {
+    _engine = engine;
+}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(NULL), _conn(conn), _snapshotManager(_conn), _shuttingDown(0) {
+    for (size_t i = 0; i < numSessionCachePartitions(); ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>());
+    }
+}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -233,24 +276,29 @@ void WiredTigerSessionCache::closeAllCursors() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors();
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+        for (auto session : partition->sessions) {
+            session->closeAllCursors();
+        }
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
     // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
-
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    // Sessions released concurrently recheck the epoch under their partition's lock, so each one
+    // is either deleted by releaseSession or collected from its partition below.
+    _epoch.fetchAndAdd(1);
+
+    std::vector<WiredTigerSession*> swap;
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+        swap.insert(swap.end(), partition->sessions.begin(), partition->sessions.end());
+        partition->sessions.clear();
     }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+    for (auto session : swap) {
+        delete session;
     }
 }
 
@@ -263,18 +311,33 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    // Look in this CPU's partition first. Other partitions are only searched if their lock is free,
+    // as creating a new session is cheaper than queueing behind another CPU.
+    const size_t home = _homePartition();
+    for (size_t n = 0; n < _partitions.size(); ++n) {
+        Partition& partition = *_partitions[(home + n) % _partitions.size()];
+        stdx::unique_lock<stdx::mutex> lock(partition.mutex, stdx::defer_lock);
+        if (!lock.try_lock()) {
+            if (n != 0)
+                continue;
+            partition.lockContended++;
+            lock.lock();
+        }
+
+        if (!partition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = partition.sessions.back();
+            partition.sessions.pop_back();
+            partition.sessionsReused++;
+            if (n != 0)
+                partition.sessionsStolen++;
             return UniqueWiredTigerSession(cachedSession);
         }
     }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
+    _sessionsCreated.fetchAndAdd(1);
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
@@ -318,11 +381,20 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        Partition& partition = *_partitions[_homePartition()];
+        stdx::unique_lock<stdx::mutex> lock(partition.mutex, stdx::defer_lock);
+        if (!lock.try_lock()) {
+            partition.lockContended++;
+            lock.lock();
+        }
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
+        partition.cursorCacheHits += session->_cursorCacheHits;
+        partition.cursorCacheMisses += session->_cursorCacheMisses;
+        session->_cursorCacheHits = 0;
+        session->_cursorCacheMisses = 0;
     } else
         invariant(session->_getEpoch() < currentEpoch);
 
@@ -333,6 +405,42 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         _engine->dropSomeQueuedIdents();
 }
 
+size_t WiredTigerSessionCache::_homePartition() const {
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0)
+        return static_cast<size_t>(cpu) % _partitions.size();
+#endif
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % _partitions.size();
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) const {
+    long long cached = 0;
+    long long reused = 0;
+    long long stolen = 0;
+    long long contended = 0;
+    long long cursorHits = 0;
+    long long cursorMisses = 0;
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+        cached += partition->sessions.size();
+        reused += partition->sessionsReused;
+        stolen += partition->sessionsStolen;
+        contended += partition->lockContended;
+        cursorHits += partition->cursorCacheHits;
+        cursorMisses += partition->cursorCacheMisses;
+    }
+
+    BSONObjBuilder sessions(builder->subobjStart("sessionCache"));
+    sessions.append("partitions", static_cast<int>(_partitions.size()));
+    sessions.appendNumber("cachedSessions", cached);
+    sessions.appendNumber("sessionsCreated", static_cast<long long>(_sessionsCreated.load()));
+    sessions.appendNumber("sessionsReused", reused);
+    sessions.appendNumber("sessionsTakenFromOtherPartitions", stolen);
+    sessions.appendNumber("partitionLockContended", contended);
+    sessions.appendNumber("cursorCacheHits", cursorHits);
+    sessions.appendNumber("cursorCacheMisses", cursorMisses);
+}
 
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
@@ -32,7 +32,10 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
 #include <wiredtiger.h>
@@ -45,21 +48,30 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
 class WiredTigerCachedCursor {
 public:
-    WiredTigerCachedCursor(uint64_t id, uint64_t gen, WT_CURSOR* cursor)
-        : _id(id), _gen(gen), _cursor(cursor) {}
+    typedef std::list<WiredTigerCachedCursor>::iterator Link;
+
+    WiredTigerCachedCursor(uint64_t id, uint64_t gen, WT_CURSOR* cursor, Link end)
+        : _id(id), _gen(gen), _cursor(cursor), _olderForTable(end), _newerForTable(end) {}
 
     uint64_t _id;   // Source ID, assigned to each URI
     uint64_t _gen;  // Generation, used to age out old cursors
     WT_CURSOR* _cursor;
+
+    // The cached cursors of each table form a list through the cursor cache, so that they can be
+    // found without a separate allocation. These are the next older and newer cursors of the same
+    // table, or the end of the cursor cache if there are none.
+    Link _olderForTable;
+    Link _newerForTable;
 };
 
 /**
- * This is a structure that caches 1 cursor for each uri.
+ * This is a structure that caches cursors for each uri, looked up by table id.
  * The idea is that there is a pool of these somewhere.
  * NOT THREADSAFE
  */
@@ -113,9 +125,16 @@ public:
 private:
     friend class WiredTigerSessionCache;
 
-    // The cursor cache is a list of pairs that contain an ID and cursor
+    // The cursor cache is a list of pairs that contain an ID and cursor, most recently released
+    // first, so that idle cursors can be aged out from the back.
     typedef std::list<WiredTigerCachedCursor> CursorCache;
 
+    // Index into the cursor cache by table id. Each entry is the most recently released cursor of
+    // the table, from which its older ones are linked. An entry is kept while its last cursor is
+    // checked out, pointing to the end of the cache, since the cursor is normally released again
+    // soon; it is only erased when the table's last cursor is aged out.
+    typedef std::unordered_map<uint64_t, CursorCache::iterator> CursorIndex;
+
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
@@ -131,13 +150,24 @@ private:
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    CursorIndex _cursorIndex;
     uint64_t _cursorGen;
     int _cursorsCached, _cursorsOut;
+
+    // Cursor cache lookups since the session was last returned to the session cache, which
+    // folds them into its statistics.
+    uint64_t _cursorCacheHits = 0;
+    uint64_t _cursorCacheMisses = 0;
 };
 
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  Idle sessions are kept in one partition per CPU, each with its own mutex, so that getting and
+ *  releasing sessions does not serialize all threads on a single lock. A thread uses the
+ *  partition of the CPU it is running on and only falls back to taking a session from another
+ *  partition when its own is empty.
  */
 class WiredTigerSessionCache {
 public:
@@ -204,7 +234,29 @@ public:
         return _cursorEpoch.load();
     }
 
+    /**
+     * Appends session and cursor cache statistics for serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
 private:
+    struct Partition {
+        stdx::mutex mutex;
+        std::vector<WiredTigerSession*> sessions;
+
+        // Statistics, protected by 'mutex'.
+        uint64_t sessionsReused = 0;
+        uint64_t sessionsStolen = 0;
+        uint64_t lockContended = 0;
+        uint64_t cursorCacheHits = 0;
+        uint64_t cursorCacheMisses = 0;
+    };
+
+    /**
+     * Returns the index of the partition belonging to the CPU the caller is running on.
+     */
+    size_t _homePartition() const;
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
     WiredTigerSnapshotManager _snapshotManager;
@@ -215,9 +267,9 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-    typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    std::vector<std::unique_ptr<Partition>> _partitions;
+
+    AtomicUInt64 _sessionsCreated;
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerSessionCacheTest : public unittest::Test {
+public:
+    WiredTigerSessionCacheTest() : _dbpath("wt_session_cache_test") {
+        ASSERT_OK(wtRCToStatus(wiredtiger_open(_dbpath.path().c_str(), NULL, "create", &_conn)));
+        _sessionCache.reset(new WiredTigerSessionCache(_conn));
+    }
+
+    ~WiredTigerSessionCacheTest() {
+        _sessionCache.reset();
+        _conn->close(_conn, NULL);
+    }
+
+protected:
+    void createTable(WiredTigerSession* session, const std::string& uri) {
+        WT_SESSION* s = session->getSession();
+        ASSERT_OK(wtRCToStatus(s->create(s, uri.c_str(), "key_format=q,value_format=u")));
+    }
+
+    BSONObj stats() {
+        BSONObjBuilder builder;
+        _sessionCache->appendStats(&builder);
+        return builder.obj().getObjectField("sessionCache").getOwned();
+    }
+
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn = nullptr;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+};
+
+TEST_F(WiredTigerSessionCacheTest, CachedCursorReturnedForSameTable) {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    createTable(session.get(), "table:a");
+    createTable(session.get(), "table:b");
+    const uint64_t idA = WiredTigerSession::genTableId();
+    const uint64_t idB = WiredTigerSession::genTableId();
+
+    WT_CURSOR* a = session->getCursor("table:a", idA, true);
+    ASSERT(a);
+    session->releaseCursor(idA, a);
+
+    WT_CURSOR* b = session->getCursor("table:b", idB, true);
+    ASSERT(b);
+    ASSERT_NOT_EQUALS(a, b);
+
+    ASSERT_EQUALS(a, session->getCursor("table:a", idA, true));
+    session->releaseCursor(idA, a);
+    session->releaseCursor(idB, b);
+    ASSERT_EQUALS(0, session->cursorsOut());
+}
+
+TEST_F(WiredTigerSessionCacheTest, SeveralCursorsCachedForOneTable) {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    createTable(session.get(), "table:a");
+    const uint64_t id = WiredTigerSession::genTableId();
+
+    WT_CURSOR* first = session->getCursor("table:a", id, true);
+    WT_CURSOR* second = session->getCursor("table:a", id, true);
+    ASSERT_NOT_EQUALS(first, second);
+    session->releaseCursor(id, first);
+    session->releaseCursor(id, second);
+
+    // The most recently released cursor is handed out first.
+    ASSERT_EQUALS(second, session->getCursor("table:a", id, true));
+    ASSERT_EQUALS(first, session->getCursor("table:a", id, true));
+    session->releaseCursor(id, first);
+    session->releaseCursor(id, second);
+}
+
+TEST_F(WiredTigerSessionCacheTest, IdleCursorsAgeOutOldestFirst) {
+    {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        createTable(session.get(), "table:a");
+        createTable(session.get(), "table:b");
+        const uint64_t idA = WiredTigerSession::genTableId();
+        const uint64_t idB = WiredTigerSession::genTableId();
+
+        WT_CURSOR* older = session->getCursor("table:a", idA, true);
+        WT_CURSOR* newer = session->getCursor("table:a", idA, true);
+        session->releaseCursor(idA, older);
+
+        // Use another table until only the older cursor of table a is old enough to be closed.
+        for (int i = 0; i < 5000; i++) {
+            session->releaseCursor(idB, session->getCursor("table:b", idB, true));
+        }
+        session->releaseCursor(idA, newer);
+        for (int i = 0; i < 6000; i++) {
+            session->releaseCursor(idB, session->getCursor("table:b", idB, true));
+        }
+
+        // The newer cursor is still cached, and the older one had to be opened again.
+        ASSERT_EQUALS(newer, session->getCursor("table:a", idA, true));
+        WT_CURSOR* reopened = session->getCursor("table:a", idA, true);
+        session->releaseCursor(idA, reopened);
+        session->releaseCursor(idA, newer);
+    }
+
+    BSONObj after = stats();
+    ASSERT_EQUALS(11000, after["cursorCacheHits"].numberLong());
+    ASSERT_EQUALS(4, after["cursorCacheMisses"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, CloseAllCursorsEmptiesCursorCache) {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    createTable(session.get(), "table:a");
+    const uint64_t id = WiredTigerSession::genTableId();
+
+    session->releaseCursor(id, session->getCursor("table:a", id, true));
+    session->closeAllCursors();
+
+    WT_CURSOR* cursor = session->getCursor("table:a", id, true);
+    ASSERT(cursor);
+    session->releaseCursor(id, cursor);
+}
+
+TEST_F(WiredTigerSessionCacheTest, ReleasedSessionIsReusedAndCounted) {
+    WiredTigerSession* first;
+    {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        first = session.get();
+        createTable(first, "table:a");
+        const uint64_t id = WiredTigerSession::genTableId();
+        session->releaseCursor(id, session->getCursor("table:a", id, true));
+        session->releaseCursor(id, session->getCursor("table:a", id, true));
+    }
+
+    BSONObj afterFirst = stats();
+    ASSERT_EQUALS(1, afterFirst["sessionsCreated"].numberLong());
+    ASSERT_EQUALS(1, afterFirst["cachedSessions"].numberLong());
+    ASSERT_EQUALS(1, afterFirst["cursorCacheHits"].numberLong());
+    ASSERT_EQUALS(1, afterFirst["cursorCacheMisses"].numberLong());
+
+    {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        ASSERT_EQUALS(first, session.get());
+    }
+
+    BSONObj afterSecond = stats();
+    ASSERT_EQUALS(1, afterSecond["sessionsCreated"].numberLong());
+    ASSERT_EQUALS(1, afterSecond["sessionsReused"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, CloseAllDiscardsCachedSessions) {
+    _sessionCache->getSession();
+    _sessionCache->getSession();
+    ASSERT_EQUALS(1, stats()["cachedSessions"].numberLong());
+
+    _sessionCache->closeAll();
+    ASSERT_EQUALS(0, stats()["cachedSessions"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -172,6 +173,8 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     _checkMagic();
 
+    Timer timer;
+
     Map myMap;
     {
         stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
@@ -229,10 +232,37 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     invariantWTOK(session->commit_transaction(session, NULL));
 
     {
+        // Entries changed while they were being written stay dirty for the next sync.
         stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            it->second.dirty = false;
+        for (Map::const_iterator it = myMap.begin(); it != myMap.end(); ++it) {
+            Map::iterator current = _entries.find(it->first);
+            if (current != _entries.end() &&
+                current->second.numRecords == it->second.numRecords &&
+                current->second.dataSize == it->second.dataSize) {
+                current->second.dirty = false;
+            }
         }
     }
+
+    const long long micros = timer.micros();
+    _numSyncs.fetchAndAdd(1);
+    _entriesWritten.fetchAndAdd(myMap.size());
+    _totalSyncMicros.fetchAndAdd(micros);
+    _lastSyncMicros.store(micros);
+    if (micros > _maxSyncMicros.load()) {
+        // Only syncs update this, and they are serialized by _cursorMutex.
+        _maxSyncMicros.store(micros);
+    }
+
+    LOG(2) << "WiredTigerSizeStorer::syncCache wrote " << myMap.size() << " entries in "
+           << micros / 1000 << "ms";
+}
+
+void WiredTigerSizeStorer::appendStats(BSONObjBuilder* builder) const {
+    builder->append("syncs", _numSyncs.load());
+    builder->append("entriesWritten", _entriesWritten.load());
+    builder->append("totalSyncMicros", _totalSyncMicros.load());
+    builder->append("lastSyncMicros", _lastSyncMicros.load());
+    builder->append("maxSyncMicros", _maxSyncMicros.load());
 }
 }
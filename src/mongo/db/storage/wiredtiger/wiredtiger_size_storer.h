@@ -37,13 +37,24 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerRecordStore;
 class WiredTigerSession;
 
+/**
+ * Caches the number of records and data size of every collection, and persists them to a table so
+ * that they survive restarts without scanning the collections.
+ *
+ * Record stores registered with onCreate are not told about every change to their sizes. Instead
+ * syncCache reads their current sizes, and only writes the entries which changed since the last
+ * sync. The storage engine calls syncCache periodically from a background thread, off the write
+ * path.
+ */
 class WiredTigerSizeStorer {
 public:
     WiredTigerSizeStorer(WT_CONNECTION* conn, const std::string& storageUri);
@@ -62,10 +73,15 @@ public:
     void fillCache();
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table, in a single transaction.
      */
     void syncCache(bool syncToDisk);
 
+    /**
+     * Appends statistics about the syncs done so far.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
 private:
     void _checkMagic() const;
 
@@ -87,5 +103,12 @@ private:
     typedef std::map<std::string, Entry> Map;
     Map _entries;
     mutable stdx::mutex _entriesMutex;
+
+    // Statistics about syncCache calls which wrote something
+    AtomicInt64 _numSyncs;
+    AtomicInt64 _entriesWritten;
+    AtomicInt64 _totalSyncMicros;
+    AtomicInt64 _lastSyncMicros;
+    AtomicInt64 _maxSyncMicros;
 };
 }
@@ -42,6 +42,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
@@ -53,6 +54,10 @@ namespace mongo {
 
 using std::string;
 
+namespace {
+AtomicUInt64 cacheFullErrors;
+}  // namespace
+
 Status wtRCToStatus_slow(int retCode, const char* prefix) {
     if (retCode == 0)
         return Status::OK();
@@ -72,7 +77,10 @@ Status wtRCToStatus_slow(int retCode, const char* prefix) {
         return Status(ErrorCodes::BadValue, s);
     }
 
-    uassert(ErrorCodes::ExceededMemoryLimit, s, retCode != WT_CACHE_FULL);
+    if (retCode == WT_CACHE_FULL) {
+        cacheFullErrors.fetchAndAdd(1);
+        uasserted(ErrorCodes::ExceededMemoryLimit, s);
+    }
 
     // TODO convert specific codes rather than just using UNKNOWN_ERROR for everything.
     return Status(ErrorCodes::UnknownError, s);
@@ -346,6 +354,10 @@ size_t WiredTigerUtil::getCacheSizeMB(double requestedCacheSizeGB) {
     return static_cast<size_t>(cacheSizeMB);
 }
 
+uint64_t WiredTigerUtil::getCacheFullErrorCount() {
+    return cacheFullErrors.load();
+}
+
 namespace {
 int mdb_handle_error(WT_EVENT_HANDLER* handler,
                      WT_SESSION* session,
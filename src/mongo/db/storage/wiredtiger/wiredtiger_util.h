@@ -182,6 +182,12 @@ public:
      */
     static size_t getCacheSizeMB(double requestedCacheSizeGB);
 
+    /**
+     * Returns the number of operations that failed because the cache was full. Only an in-memory
+     * WiredTiger connection reports a full cache, rather than evicting to disk.
+     */
+    static uint64_t getCacheFullErrorCount();
+
     /**
      * Returns a WT_EVENT_HANDER with MongoDB's default handlers.
      * The default handlers just log so it is recommended that you consider calling them even if
@@ -116,6 +116,9 @@ private:
         const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
         OperationContext& txn = *txnPtr;
 
+        // Expiring documents can wait behind both client and replication work.
+        txn.lockState()->setAdmissionPriority(TicketPriority::kLow);
+
         // If part of replSet but not in a readable state (e.g. during initial sync), skip.
         if (repl::getGlobalReplicationCoordinator()->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
@@ -0,0 +1,262 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/warm_up.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/log.h"
+#include "mongo/util/progress_meter.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+namespace {
+
+// A chunk ends after whichever of these limits it reaches first. Both keep the time spent holding
+// the collection lock, and the time spent asleep when throttled, short.
+const long long kMaxChunkItems = 1000;
+const long long kMaxChunkBytes = 4 * 1024 * 1024;
+const long long kMinChunkBytes = 64 * 1024;
+
+using ExecutorFactory = stdx::function<std::unique_ptr<PlanExecutor>(Collection*)>;
+
+/**
+ * Paces the reads of one warmUpCollection() call to a maximum number of bytes per second.
+ */
+class Throttle {
+public:
+    explicit Throttle(long long maxBytesPerSec) : _maxBytesPerSec(maxBytesPerSec) {}
+
+    long long chunkBytes() const {
+        if (_maxBytesPerSec <= 0)
+            return kMaxChunkBytes;
+        // Aim for roughly ten chunks per second.
+        return std::max(kMinChunkBytes, std::min(kMaxChunkBytes, _maxBytesPerSec / 10));
+    }
+
+    void noteRead(long long bytes) {
+        if (_maxBytesPerSec <= 0)
+            return;
+        _bytes += bytes;
+        const long long targetMicros = static_cast<long long>(
+            static_cast<double>(_bytes) * 1000 * 1000 / _maxBytesPerSec);
+        const long long aheadMicros = targetMicros - _timer.micros();
+        if (aheadMicros > 0)
+            sleepmicros(aheadMicros);
+    }
+
+private:
+    const long long _maxBytesPerSec;
+    long long _bytes = 0;
+    Timer _timer;
+};
+
+bool budgetExhausted(const WarmUpOptions& options, const WarmUpStats& stats) {
+    return options.maxBytes > 0 && stats.bytes >= options.maxBytes;
+}
+
+/**
+ * Drains the executor built by 'makeExecutor' one chunk at a time, re-acquiring the collection's
+ * intent lock for each chunk. The executor is registered with the collection's CursorManager, so
+ * dropping the collection or index while no chunk runs kills it and the next restoreState() fails.
+ * For the same reason it is only ever destroyed while the lock is held, including when a chunk
+ * throws because the operation was interrupted.
+ */
+void scanInChunks(OperationContext* txn,
+                  const NamespaceString& nss,
+                  const ExecutorFactory& makeExecutor,
+                  const WarmUpOptions& options,
+                  Throttle* throttle,
+                  ProgressMeterHolder* progress,
+                  WarmUpStats* stats,
+                  long long* itemCounter) {
+    std::unique_ptr<PlanExecutor> exec;
+    while (true) {
+        long long chunkBytes = 0;
+        bool done = false;
+        {
+            AutoGetCollection autoColl(txn, nss, MODE_IS);
+            // Declared after 'autoColl', so that it runs before the lock is released.
+            auto destroyOnThrow = MakeGuard([&] { exec.reset(); });
+
+            txn->checkForInterrupt();
+
+            Collection* collection = autoColl.getCollection();
+            if (!exec) {
+                if (!collection)
+                    return;
+                exec = makeExecutor(collection);
+                if (!exec)
+                    return;
+            } else if (!exec->restoreState()) {
+                // Killed by a drop; destroy it while the lock is still held.
+                exec.reset();
+                return;
+            }
+
+            BSONObj obj;
+            long long chunkItems = 0;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+            while (chunkItems < kMaxChunkItems && chunkBytes < throttle->chunkBytes() &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+                chunkBytes += obj.objsize();
+                ++chunkItems;
+            }
+
+            *itemCounter += chunkItems;
+            stats->bytes += chunkBytes;
+            progress->hit(chunkItems);
+
+            done = state != PlanExecutor::ADVANCED || budgetExhausted(options, *stats);
+            if (done) {
+                exec.reset();
+            } else {
+                exec->saveState();
+            }
+            destroyOnThrow.Dismiss();
+        }
+
+        if (done) {
+            // A scan that died because the operation was killed must not look like it finished.
+            txn->checkForInterrupt();
+            return;
+        }
+
+        throttle->noteRead(chunkBytes);
+    }
+}
+
+}  // namespace
+
+Status warmUpCollection(OperationContext* txn,
+                        const NamespaceString& nss,
+                        const WarmUpOptions& options,
+                        WarmUpStats* stats) {
+    invariant(options.data || options.indexes);
+
+    std::vector<std::string> indexNames;
+    long long numRecords;
+    {
+        AutoGetCollection autoColl(txn, nss, MODE_IS);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return {ErrorCodes::NamespaceNotFound,
+                    str::stream() << "collection " << nss.ns() << " not found"};
+        }
+
+        numRecords = collection->numRecords(txn);
+        if (options.indexes) {
+            IndexCatalog::IndexIterator ii =
+                collection->getIndexCatalog()->getIndexIterator(txn, false);
+            while (ii.more()) {
+                const std::string& name = ii.next()->indexName();
+                if (options.indexNames.empty() ||
+                    std::find(options.indexNames.begin(), options.indexNames.end(), name) !=
+                        options.indexNames.end()) {
+                    indexNames.push_back(name);
+                }
+            }
+        }
+    }
+
+    const long long expectedItems =
+        numRecords * ((options.data ? 1 : 0) + static_cast<long long>(indexNames.size()));
+    const std::string message = "warm up " + nss.ns();
+    stdx::unique_lock<Client> lk(*txn->getClient());
+    ProgressMeterHolder progress(
+        *txn->setMessage_inlock(message.c_str(), "Warm Up Progress", expectedItems));
+    lk.unlock();
+
+    Throttle throttle(options.maxBytesPerSec);
+
+    if (options.data && !budgetExhausted(options, *stats)) {
+        scanInChunks(txn,
+                     nss,
+                     [&](Collection* collection) {
+                         return InternalPlanner::collectionScan(
+                             txn, nss.ns(), collection, PlanExecutor::YIELD_AUTO);
+                     },
+                     options,
+                     &throttle,
+                     &progress,
+                     stats,
+                     &stats->records);
+    }
+
+    for (const std::string& indexName : indexNames) {
+        if (budgetExhausted(options, *stats))
+            break;
+
+        scanInChunks(txn,
+                     nss,
+                     [&](Collection* collection) -> std::unique_ptr<PlanExecutor> {
+                         const IndexDescriptor* desc =
+                             collection->getIndexCatalog()->findIndexByName(txn, indexName);
+                         if (!desc)
+                             return nullptr;
+
+                         KeyPattern keyPattern(desc->keyPattern());
+                         return InternalPlanner::indexScan(
+                             txn,
+                             collection,
+                             desc,
+                             Helpers::toKeyFormat(keyPattern.globalMin()),
+                             Helpers::toKeyFormat(keyPattern.globalMax()),
+                             true,  // endKeyInclusive
+                             PlanExecutor::YIELD_AUTO);
+                     },
+                     options,
+                     &throttle,
+                     &progress,
+                     stats,
+                     &stats->indexKeys);
+    }
+
+    progress.finished();
+    return Status::OK();
+}
+
+}  // namespace mongo
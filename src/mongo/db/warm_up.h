@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+class NamespaceString;
+class OperationContext;
+
+/**
+ * What warmUpCollection() should read.
+ */
+struct WarmUpOptions {
+    // Read every record of the collection.
+    bool data = false;
+
+    // Read every key of the collection's indexes, or only of the indexes named in 'indexNames'
+    // when it is not empty. Names of indexes that do not exist are ignored.
+    bool indexes = false;
+    std::vector<std::string> indexNames;
+
+    // Caps the read rate. Zero reads as fast as the storage engine allows.
+    long long maxBytesPerSec = 0;
+
+    // Stops reading once WarmUpStats::bytes reaches this value. Zero means no limit.
+    long long maxBytes = 0;
+};
+
+/**
+ * What warmUpCollection() read. Counters accumulate across calls so that one budget can be shared
+ * by the warm up of several collections.
+ */
+struct WarmUpStats {
+    long long records = 0;
+    long long indexKeys = 0;
+    long long bytes = 0;
+};
+
+/**
+ * Pulls the records and/or index keys of the collection 'nss' into the storage engine's cache by
+ * scanning them with internal cursors. Unlike Collection::touch(), this works on every storage
+ * engine.
+ *
+ * The scans run in short chunks and hold the collection's intent lock only while a chunk runs,
+ * sleeping between chunks as needed to honor 'options.maxBytesPerSec'. Progress is reported
+ * through the CurOp message of 'txn'.
+ *
+ * Returns NamespaceNotFound if the collection does not exist. A collection or index dropped part
+ * way through simply ends its scan early. Throws if 'txn' is interrupted.
+ */
+Status warmUpCollection(OperationContext* txn,
+                        const NamespaceString& nss,
+                        const WarmUpOptions& options,
+                        WarmUpStats* stats);
+
+}  // namespace mongo
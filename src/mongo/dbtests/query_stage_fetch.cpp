@@ -44,6 +44,8 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 
@@ -219,6 +221,95 @@ public:
     }
 };
 
+//
+// Test that fetching in batches returns the documents in the order the child produced them, and
+// drops those whose record is gone.
+//
+class FetchStageBatched : public QueryStageFetchBase {
+public:
+    FetchStageBatched() : _oldBatchSize(internalQueryExecFetchBatchSize.load()) {
+        internalQueryExecFetchBatchSize.store(4);
+    }
+
+    ~FetchStageBatched() {
+        internalQueryExecFetchBatchSize.store(_oldBatchSize);
+    }
+
+    void run() {
+        // Only storage engines with document-level locking fetch in batches. The others rely on
+        // invalidations, so the stage couldn't be handed the RecordId of a removed document.
+        if (!supportsDocLocking()) {
+            return;
+        }
+
+        OldClientWriteContext ctx(&_txn, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_txn);
+            coll = db->createCollection(&_txn, ns());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        const int numDocs = 10;
+        for (int i = 0; i < numDocs; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(numDocs), recordIds.size());
+
+        // Queue the documents in descending RecordId order, so that each batch has to be reordered.
+        auto mockStage = make_unique<QueuedDataStage>(&_txn, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+
+            if (it == recordIds.rbegin()) {
+                // Follow the first document with one that already has an object.
+                WorkingSetID ownedId = ws.allocate();
+                WorkingSetMember* ownedMember = ws.get(ownedId);
+                ownedMember->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("foo" << -1));
+                ownedMember->transitionToOwnedObj();
+                mockStage->pushBack(ownedId);
+            }
+        }
+
+        // Remove one of the documents, so that its record is missing.
+        remove(BSON("foo" << 3));
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_txn, &ws, mockStage.release(), NULL, coll));
+
+        std::vector<int> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = fetchStage->work(&id)) != PlanStage::IS_EOF) {
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_TRUE(member->hasObj());
+                results.push_back(member->obj.value()["foo"].numberInt());
+            } else {
+                ASSERT_EQUALS(PlanStage::NEED_TIME, state);
+            }
+        }
+
+        const std::vector<int> expected{9, -1, 8, 7, 6, 5, 4, 2, 1, 0};
+        ASSERT_EQUALS(expected.size(), results.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUALS(expected[i], results[i]);
+        }
+    }
+
+private:
+    const int _oldBatchSize;
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -226,6 +317,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatched>();
     }
 };
 
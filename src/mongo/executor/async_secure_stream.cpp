@@ -88,25 +88,39 @@ void AsyncSecureStream::read(asio::mutable_buffer buffer, StreamHandler&& stream
 }
 
 void AsyncSecureStream::_handleConnect(asio::ip::tcp::resolver::iterator iter) {
+    // Offer the session from our last connection to this member so that the handshake can skip
+    // the asymmetric crypto.
+    getSSLManager()->restoreClientSession(_stream.native_handle(), _peerKey(iter));
+
     _stream.async_handshake(decltype(_stream)::client,
                             _strand->wrap([this, iter](std::error_code ec) {
                                 if (ec) {
                                     return _userHandler(ec);
                                 }
-                                return _handleHandshake(ec, iter->host_name());
+                                return _handleHandshake(ec, iter);
                             }));
 }
 
-void AsyncSecureStream::_handleHandshake(std::error_code ec, const std::string& hostName) {
+void AsyncSecureStream::_handleHandshake(std::error_code ec,
+                                         asio::ip::tcp::resolver::iterator iter) {
+    auto sslManager = getSSLManager();
     auto certStatus =
-        getSSLManager()->parseAndValidatePeerCertificate(_stream.native_handle(), hostName);
+        sslManager->parseAndValidatePeerCertificate(_stream.native_handle(), iter->host_name());
     if (!certStatus.isOK()) {
         warning() << "Failed to validate peer certificate during SSL handshake: "
                   << certStatus.getStatus();
+    } else {
+        sslManager->recordHandshake(_stream.native_handle(),
+                                    SSLManagerInterface::ConnectionDirection::kOutgoing);
+        sslManager->saveClientSession(_stream.native_handle(), _peerKey(iter));
     }
     _userHandler(make_error_code(certStatus.getStatus().code()));
 }
 
+std::string AsyncSecureStream::_peerKey(asio::ip::tcp::resolver::iterator iter) {
+    return iter->host_name() + ":" + iter->service_name();
+}
+
 void AsyncSecureStream::cancel() {
     cancelStream(&_stream.lowest_layer(), _connected);
 }
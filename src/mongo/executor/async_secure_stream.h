@@ -60,7 +60,10 @@ public:
 private:
     void _handleConnect(asio::ip::tcp::resolver::iterator iter);
 
-    void _handleHandshake(std::error_code ec, const std::string& hostName);
+    void _handleHandshake(std::error_code ec, asio::ip::tcp::resolver::iterator iter);
+
+    // Identifies the remote member for client-side session resumption.
+    static std::string _peerKey(asio::ip::tcp::resolver::iterator iter);
 
     asio::io_service::strand* const _strand;
     asio::ssl::stream<asio::ip::tcp::socket> _stream;
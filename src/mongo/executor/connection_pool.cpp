@@ -99,6 +99,16 @@ public:
      */
     size_t createdConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the number of connections currently being set up or refreshed.
+     */
+    size_t refreshingConnections(const stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Returns the number of ready connections the pool is currently trying to keep around.
+     */
+    size_t idleTarget(const stdx::unique_lock<stdx::mutex>& lk);
+
 private:
     using OwnedConnection = std::unique_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
@@ -115,6 +125,8 @@ private:
 
     void spawnConnections(stdx::unique_lock<stdx::mutex>& lk, const HostAndPort& hostAndPort);
 
+    void replenishIdle(stdx::unique_lock<stdx::mutex>& lk);
+
     void shutdown();
 
     OwnedConnection takeFromPool(OwnershipPool& pool, ConnectionInterface* connection);
@@ -222,7 +234,9 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
         auto& pool = kv.second;
         ConnectionStatsPerHost hostStats{pool->inUseConnections(lk),
                                          pool->availableConnections(lk),
-                                         pool->createdConnections(lk)};
+                                         pool->createdConnections(lk),
+                                         pool->refreshingConnections(lk),
+                                         pool->idleTarget(lk)};
         stats->updateStatsForHost(host, hostStats);
     }
 }
@@ -263,6 +277,18 @@ size_t ConnectionPool::SpecificPool::createdConnections(const stdx::unique_lock<
     return _created;
 }
 
+size_t ConnectionPool::SpecificPool::refreshingConnections(
+    const stdx::unique_lock<stdx::mutex>& lk) {
+    return _processingPool.size();
+}
+
+size_t ConnectionPool::SpecificPool::idleTarget(const stdx::unique_lock<stdx::mutex>& lk) {
+    const auto maxConnections = _parent->_options.maxConnections;
+    const auto inUse = _checkedOutPool.size();
+    return std::min(_parent->_options.minIdleConnections,
+                    maxConnections > inUse ? maxConnections - inUse : 0);
+}
+
 void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
                                                  Milliseconds timeout,
                                                  stdx::unique_lock<stdx::mutex> lk,
@@ -301,6 +327,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
 
     if (!conn->getStatus().isOK()) {
         // TODO: alert via some callback if the host is bad
+        replenishIdle(lk);
         return;
     }
 
@@ -309,8 +336,10 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
         // If we need to refresh this connection
 
         if (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() >=
-            _parent->_options.minConnections) {
-            // If we already have minConnections, just let the connection lapse
+                _parent->_options.minConnections &&
+            _readyPool.size() + _processingPool.size() >= idleTarget(lk)) {
+            // If we already have minConnections and enough idle ones, just let the connection
+            // lapse
             return;
         }
 
@@ -437,6 +466,7 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
     _inFulfillRequests = true;
     auto guard = MakeGuard([&] { _inFulfillRequests = false; });
 
+    bool checkedOutAny = false;
     while (_requests.size()) {
         auto iter = _readyPool.begin();
 
@@ -471,6 +501,7 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
 
         // check out the connection
         _checkedOutPool[connPtr] = std::move(conn);
+        checkedOutAny = true;
 
         updateStateInLock();
 
@@ -480,17 +511,28 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         cb(ConnectionHandle(connPtr, ConnectionHandleDeleter(_parent)));
         lk.lock();
     }
+
+    guard.Dismiss();
+    _inFulfillRequests = false;
+
+    // Start replacing the connections we just handed out, so that the next burst of requests
+    // doesn't have to wait for connection setup.
+    if (checkedOutAny) {
+        replenishIdle(lk);
+    }
 }
 
 // spawn enough connections to satisfy open requests and minpool, while
 // honoring maxpool
 void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mutex>& lk,
                                                     const HostAndPort& hostAndPort) {
-    // We want minConnections <= outstanding requests <= maxConnections
+    // We want minConnections <= outstanding requests <= maxConnections, and in addition want
+    // to keep minIdleConnections ready beyond the ones checked out
     auto target = [&] {
-        return std::max(
-            _parent->_options.minConnections,
-            std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
+        return std::max(_parent->_options.minConnections,
+                        std::min(std::max(_requests.size(), _parent->_options.minIdleConnections) +
+                                     _checkedOutPool.size(),
+                                 _parent->_options.maxConnections));
     };
 
     // While all of our inflight connections are less than our target
@@ -529,6 +571,15 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     }
 }
 
+// Tops the pool back up to minIdleConnections after connections were handed out or dropped
+void ConnectionPool::SpecificPool::replenishIdle(stdx::unique_lock<stdx::mutex>& lk) {
+    if (_parent->_options.minIdleConnections == 0 || _state == State::kInShutdown) {
+        return;
+    }
+
+    spawnConnections(lk, _hostAndPort);
+}
+
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
     stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
@@ -90,6 +90,13 @@ public:
          */
         size_t maxConnections = std::numeric_limits<size_t>::max();
 
+        /**
+         * The number of ready connections to keep for a host on top of the ones checked out.
+         * The pool establishes them in the background once it exists and refills them as they
+         * are checked out or dropped, always honoring maxConnections.
+         */
+        size_t minIdleConnections = 0;
+
         /**
          * Amount of time to wait before timing out a refresh attempt
          */
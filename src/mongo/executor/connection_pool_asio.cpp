@@ -161,6 +161,7 @@ size_t ASIOConnection::getGeneration() const {
 std::unique_ptr<NetworkInterfaceASIO::AsyncOp> ASIOConnection::makeAsyncOp(ASIOConnection* conn) {
     return stdx::make_unique<NetworkInterfaceASIO::AsyncOp>(
         conn->_global->_impl,
+        conn->_global->_reactor->ioService,
         TaskExecutor::CallbackHandle(),
         RemoteCommandRequest{conn->getHostAndPort(),
                              std::string("admin"),
@@ -290,14 +291,15 @@ void ASIOConnection::bindAsyncOp(std::unique_ptr<NetworkInterfaceASIO::AsyncOp>
     _impl = std::move(op);
 }
 
-ASIOImpl::ASIOImpl(NetworkInterfaceASIO* impl) : _impl(impl) {}
+ASIOImpl::ASIOImpl(NetworkInterfaceASIO* impl, NetworkInterfaceASIO::Reactor* reactor)
+    : _impl(impl), _reactor(reactor) {}
 
 Date_t ASIOImpl::now() {
     return _impl->now();
 }
 
 std::unique_ptr<ConnectionPool::TimerInterface> ASIOImpl::makeTimer() {
-    return stdx::make_unique<ASIOTimer>(&_impl->_strand);
+    return stdx::make_unique<ASIOTimer>(&_reactor->strand);
 }
 
 std::unique_ptr<ConnectionPool::ConnectionInterface> ASIOImpl::makeConnection(
@@ -121,7 +121,7 @@ class ASIOImpl final : public ConnectionPool::DependentTypeFactoryInterface {
     friend class ASIOConnection;
 
 public:
-    ASIOImpl(NetworkInterfaceASIO* impl);
+    ASIOImpl(NetworkInterfaceASIO* impl, NetworkInterfaceASIO::Reactor* reactor);
 
     std::unique_ptr<ConnectionPool::ConnectionInterface> makeConnection(
         const HostAndPort& hostAndPort, size_t generation) override;
@@ -131,6 +131,7 @@ public:
 
 private:
     NetworkInterfaceASIO* const _impl;
+    NetworkInterfaceASIO::Reactor* const _reactor;
 };
 
 }  // namespace connection_pool_asio
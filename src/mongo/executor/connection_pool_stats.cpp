@@ -39,12 +39,25 @@ namespace executor {
 ConnectionStatsPerHost::ConnectionStatsPerHost(size_t nInUse, size_t nAvailable, size_t nCreated)
     : inUse(nInUse), available(nAvailable), created(nCreated) {}
 
+ConnectionStatsPerHost::ConnectionStatsPerHost(size_t nInUse,
+                                               size_t nAvailable,
+                                               size_t nCreated,
+                                               size_t nRefreshing,
+                                               size_t nIdleTarget)
+    : inUse(nInUse),
+      available(nAvailable),
+      created(nCreated),
+      refreshing(nRefreshing),
+      idleTarget(nIdleTarget) {}
+
 ConnectionStatsPerHost::ConnectionStatsPerHost() = default;
 
 ConnectionStatsPerHost& ConnectionStatsPerHost::operator+=(const ConnectionStatsPerHost& other) {
     inUse += other.inUse;
     available += other.available;
     created += other.created;
+    refreshing += other.refreshing;
+    idleTarget += other.idleTarget;
 
     return *this;
 }
@@ -53,18 +66,20 @@ void ConnectionPoolStats::updateStatsForHost(HostAndPort host, ConnectionStatsPe
     // Update stats for this host.
     auto hostStats = mapFindWithDefault(statsByHost, host);
     hostStats += newStats;
-    statsByHost.insert(std::make_pair(host, hostStats));
+    statsByHost[host] = hostStats;
 
     // Update total connection stats.
     totalInUse += newStats.inUse;
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
+    totalRefreshing += newStats.refreshing;
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalInUse", totalInUse);
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
+    result.appendNumber("totalRefreshing", totalRefreshing);
 
     BSONObjBuilder hostBuilder(result.subobjStart("hosts"));
     for (auto&& host : statsByHost) {
@@ -74,6 +89,11 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
         hostInfo.appendNumber("inUse", hostStats.inUse);
         hostInfo.appendNumber("available", hostStats.available);
         hostInfo.appendNumber("created", hostStats.created);
+        hostInfo.appendNumber("refreshing", hostStats.refreshing);
+        if (hostStats.idleTarget > 0) {
+            hostInfo.appendNumber("idleTarget", hostStats.idleTarget);
+        }
+        hostInfo.appendBool("warm", hostStats.available >= hostStats.idleTarget);
     }
 }
 
@@ -41,6 +41,12 @@ namespace executor {
 struct ConnectionStatsPerHost {
     ConnectionStatsPerHost(size_t nInUse, size_t nAvailable, size_t nCreated);
 
+    ConnectionStatsPerHost(size_t nInUse,
+                           size_t nAvailable,
+                           size_t nCreated,
+                           size_t nRefreshing,
+                           size_t nIdleTarget);
+
     ConnectionStatsPerHost();
 
     ConnectionStatsPerHost& operator+=(const ConnectionStatsPerHost& other);
@@ -48,6 +54,11 @@ struct ConnectionStatsPerHost {
     size_t inUse = 0u;
     size_t available = 0u;
     size_t created = 0u;
+    size_t refreshing = 0u;
+
+    // Number of ready connections the pool tries to keep for this host. The host counts as warm
+    // once at least this many connections are available.
+    size_t idleTarget = 0u;
 };
 
 /**
@@ -63,6 +74,7 @@ struct ConnectionPoolStats {
     size_t totalInUse = 0u;
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
+    size_t totalRefreshing = 0u;
 
     stdx::unordered_map<HostAndPort, ConnectionStatsPerHost> statsByHost;
 };
@@ -30,6 +30,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -830,6 +831,84 @@ TEST_F(ConnectionPoolTest, dropConnections) {
     ASSERT(reachedB);
 }
 
+/**
+ * Verify that the pool keeps minIdleConnections ready beyond the checked out connections, and
+ * reports whether it has reached that target.
+ */
+TEST_F(ConnectionPoolTest, minIdleConnectionsMaintained) {
+    ConnectionPool::Options options;
+    options.minIdleConnections = 2;
+    options.maxConnections = 4;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), options);
+
+    auto hostStats = [&] {
+        ConnectionPoolStats stats;
+        pool.appendConnectionStats(&stats);
+        return stats.statsByHost[HostAndPort()];
+    };
+
+    // The first request spawns enough connections for itself and the idle target
+    ConnectionPool::ConnectionHandle conn1;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn1 = std::move(swConn.getValue());
+             });
+    ASSERT_EQ(2u, hostStats().refreshing);
+
+    // Handing out the first ready connection starts a replacement for it
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1);
+    ASSERT_EQ(1u, hostStats().inUse);
+    ASSERT_EQ(0u, hostStats().available);
+    ASSERT_EQ(2u, hostStats().refreshing);
+    ASSERT_EQ(2u, hostStats().idleTarget);
+    ASSERT_EQ(3u, hostStats().created);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(2u, hostStats().available);
+    ASSERT_EQ(0u, hostStats().refreshing);
+
+    // Returning the connection leaves us above the target, so taking one again doesn't spawn
+    doneWith(conn1);
+    conn1.reset();
+    ASSERT_EQ(3u, hostStats().available);
+
+    ConnectionPool::ConnectionHandle conn2;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn2 = std::move(swConn.getValue());
+             });
+    ASSERT(conn2);
+    ASSERT_EQ(2u, hostStats().available);
+    ASSERT_EQ(0u, hostStats().refreshing);
+    ASSERT_EQ(3u, hostStats().created);
+
+    // Dipping below the idle target starts a replacement in the background
+    ConnectionPool::ConnectionHandle conn3;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn3 = std::move(swConn.getValue());
+             });
+    ASSERT(conn3);
+    ASSERT_EQ(1u, hostStats().available);
+    ASSERT_EQ(1u, hostStats().refreshing);
+    ASSERT_FALSE(hostStats().available >= hostStats().idleTarget);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(2u, hostStats().available);
+    ASSERT_EQ(4u, hostStats().created);
+
+    doneWith(conn2);
+    doneWith(conn3);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -116,12 +116,20 @@ void ConnectionImpl::pushSetup(PushSetupCallback status) {
     _pushSetupQueue.push_back(status);
 
     if (_setupQueue.size()) {
-        _setupQueue.front()->_setupCallback(_setupQueue.front(), _pushSetupQueue.front()());
-        _setupQueue.pop_front();
-        _pushSetupQueue.pop_front();
+        fireSetup();
     }
 }
 
+void ConnectionImpl::fireSetup() {
+    // Dequeue before running the callback, which may set up further connections.
+    auto conn = _setupQueue.front();
+    auto status = _pushSetupQueue.front();
+    _setupQueue.pop_front();
+    _pushSetupQueue.pop_front();
+
+    conn->_setupCallback(conn, status());
+}
+
 void ConnectionImpl::pushSetup(Status status) {
     pushSetup([status]() { return status; });
 }
@@ -130,12 +138,20 @@ void ConnectionImpl::pushRefresh(PushRefreshCallback status) {
     _pushRefreshQueue.push_back(status);
 
     if (_refreshQueue.size()) {
-        _refreshQueue.front()->_refreshCallback(_refreshQueue.front(), _pushRefreshQueue.front()());
-        _refreshQueue.pop_front();
-        _pushRefreshQueue.pop_front();
+        fireRefresh();
     }
 }
 
+void ConnectionImpl::fireRefresh() {
+    // Dequeue before running the callback, which may refresh further connections.
+    auto conn = _refreshQueue.front();
+    auto status = _pushRefreshQueue.front();
+    _refreshQueue.pop_front();
+    _pushRefreshQueue.pop_front();
+
+    conn->_refreshCallback(conn, status());
+}
+
 void ConnectionImpl::pushRefresh(Status status) {
     pushRefresh([status]() { return status; });
 }
@@ -166,9 +182,7 @@ void ConnectionImpl::setup(Milliseconds timeout, SetupCallback cb) {
     _setupQueue.push_back(this);
 
     if (_pushSetupQueue.size()) {
-        _setupQueue.front()->_setupCallback(_setupQueue.front(), _pushSetupQueue.front()());
-        _setupQueue.pop_front();
-        _pushSetupQueue.pop_front();
+        fireSetup();
     }
 }
 
@@ -182,9 +196,7 @@ void ConnectionImpl::refresh(Milliseconds timeout, RefreshCallback cb) {
     _refreshQueue.push_back(this);
 
     if (_pushRefreshQueue.size()) {
-        _refreshQueue.front()->_refreshCallback(_refreshQueue.front(), _pushRefreshQueue.front()());
-        _refreshQueue.pop_front();
-        _pushRefreshQueue.pop_front();
+        fireRefresh();
     }
 }
 
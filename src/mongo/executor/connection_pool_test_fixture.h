@@ -117,6 +117,10 @@ private:
 
     size_t getGeneration() const override;
 
+    // Runs the oldest pending setup or refresh with the oldest pushed answer
+    static void fireSetup();
+    static void fireRefresh();
+
     HostAndPort _hostAndPort;
     Date_t _lastUsed;
     Status _status = Status::OK();
@@ -56,24 +56,40 @@
 namespace mongo {
 namespace executor {
 
-namespace {
-const std::size_t kIOServiceWorkers = 1;
-}  // namespace
-
 NetworkInterfaceASIO::Options::Options() = default;
 
+NetworkInterfaceASIO::Reactor::Reactor(NetworkInterfaceASIO* net,
+                                       ConnectionPool::Options poolOptions)
+    : ioService(),
+      connectionPool(stdx::make_unique<connection_pool_asio::ASIOImpl>(net, this),
+                     std::move(poolOptions)),
+      strand(ioService) {}
+
 NetworkInterfaceASIO::NetworkInterfaceASIO(Options options)
     : _options(std::move(options)),
-      _io_service(),
       _metadataHook(std::move(_options.metadataHook)),
       _hook(std::move(_options.networkConnectionHook)),
       _state(State::kReady),
       _timerFactory(std::move(_options.timerFactory)),
       _streamFactory(std::move(_options.streamFactory)),
-      _connectionPool(stdx::make_unique<connection_pool_asio::ASIOImpl>(this),
-                      _options.connectionPoolOptions),
-      _isExecutorRunnable(false),
-      _strand(_io_service) {}
+      _isExecutorRunnable(false) {
+    invariant(_options.numReactors > 0);
+
+    // Split the per-host connection limits between the partitions so that the total number of
+    // connections to a host stays close to the configured values.
+    const auto splitLimit = [this](size_t limit) {
+        return (limit + _options.numReactors - 1) / _options.numReactors;
+    };
+    auto poolOptions = _options.connectionPoolOptions;
+    if (poolOptions.maxConnections != std::numeric_limits<size_t>::max()) {
+        poolOptions.maxConnections = splitLimit(poolOptions.maxConnections);
+    }
+    poolOptions.minIdleConnections = splitLimit(poolOptions.minIdleConnections);
+
+    for (size_t i = 0; i < _options.numReactors; ++i) {
+        _reactors.push_back(stdx::make_unique<Reactor>(this, poolOptions));
+    }
+}
 
 std::string NetworkInterfaceASIO::getDiagnosticString() {
     stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
@@ -137,7 +153,9 @@ uint64_t NetworkInterfaceASIO::getNumTimedOutOps() {
 }
 
 void NetworkInterfaceASIO::appendConnectionStats(ConnectionPoolStats* stats) const {
-    _connectionPool.appendConnectionStats(stats);
+    for (auto&& reactor : _reactors) {
+        reactor->connectionPool.appendConnectionStats(stats);
+    }
 }
 
 std::string NetworkInterfaceASIO::getHostName() {
@@ -145,14 +163,14 @@ std::string NetworkInterfaceASIO::getHostName() {
 }
 
 void NetworkInterfaceASIO::startup() {
-    _serviceRunners.resize(kIOServiceWorkers);
-    for (std::size_t i = 0; i < kIOServiceWorkers; ++i) {
-        _serviceRunners[i] = stdx::thread([this, i]() {
+    for (std::size_t i = 0; i < _reactors.size(); ++i) {
+        auto reactor = _reactors[i].get();
+        reactor->runner = stdx::thread([this, i, reactor]() {
             setThreadName(_options.instanceName + "-" + std::to_string(i));
             try {
                 LOG(2) << "The NetworkInterfaceASIO worker thread is spinning up";
-                asio::io_service::work work(_io_service);
-                _io_service.run();
+                asio::io_service::work work(reactor->ioService);
+                reactor->ioService.run();
             } catch (...) {
                 severe() << "Uncaught exception in NetworkInterfaceASIO IO "
                             "worker thread of type: "
@@ -166,9 +184,13 @@ void NetworkInterfaceASIO::startup() {
 
 void NetworkInterfaceASIO::shutdown() {
     _state.store(State::kShutdown);
-    _io_service.stop();
-    for (auto&& worker : _serviceRunners) {
-        worker.join();
+    for (auto&& reactor : _reactors) {
+        reactor->ioService.stop();
+    }
+    for (auto&& reactor : _reactors) {
+        if (reactor->runner.joinable()) {
+            reactor->runner.join();
+        }
     }
     LOG(2) << "NetworkInterfaceASIO shutdown successfully";
 }
@@ -401,7 +423,7 @@ Status NetworkInterfaceASIO::startCommand(const TaskExecutor::CallbackHandle& cb
         });
     };
 
-    _connectionPool.get(request.target, request.timeout, nextStep);
+    _nextReactor().connectionPool.get(request.target, request.timeout, nextStep);
     return Status::OK();
 }
 
@@ -448,7 +470,8 @@ Status NetworkInterfaceASIO::setAlarm(Date_t when, const stdx::function<void()>&
     }
 
     // "alarm" must stay alive until it expires, hence the shared_ptr.
-    auto alarm = std::make_shared<asio::system_timer>(_io_service, when.toSystemTimePoint());
+    auto alarm = std::make_shared<asio::system_timer>(_nextReactor().ioService,
+                                                      when.toSystemTimePoint());
     alarm->async_wait([alarm, this, action](std::error_code ec) {
         if (!ec) {
             return action();
@@ -468,9 +491,18 @@ bool NetworkInterfaceASIO::inShutdown() const {
 
 bool NetworkInterfaceASIO::onNetworkThread() {
     auto id = stdx::this_thread::get_id();
-    return std::any_of(_serviceRunners.begin(),
-                       _serviceRunners.end(),
-                       [id](const stdx::thread& thread) { return id == thread.get_id(); });
+    return std::any_of(_reactors.begin(),
+                       _reactors.end(),
+                       [id](const std::unique_ptr<Reactor>& reactor) {
+                           return id == reactor->runner.get_id();
+                       });
+}
+
+NetworkInterfaceASIO::Reactor& NetworkInterfaceASIO::_nextReactor() {
+    if (_reactors.size() == 1) {
+        return *_reactors.front();
+    }
+    return *_reactors[_reactorCounter.fetchAndAdd(1) % _reactors.size()];
 }
 
 void NetworkInterfaceASIO::_failWithInfo(const char* file,
@@ -104,6 +104,14 @@ public:
 
         std::string instanceName = "NetworkInterfaceASIO";
         ConnectionPool::Options connectionPoolOptions;
+
+        /**
+         * Number of io_service threads ("reactors") to spread outbound operations over. Each
+         * reactor owns its own partition of the connection pool; maxConnections and
+         * minIdleConnections are divided evenly between the partitions, while minConnections
+         * applies to each of them.
+         */
+        size_t numReactors = 1;
         std::unique_ptr<AsyncTimerFactoryInterface> timerFactory;
         std::unique_ptr<NetworkConnectionHook> networkConnectionHook;
         std::unique_ptr<AsyncStreamFactoryInterface> streamFactory;
@@ -147,6 +155,26 @@ private:
 
     friend class AsyncOp;
 
+    /**
+     * A reactor is an io_service run by a single thread, together with the connection pool
+     * partition whose connections and timers live on it. Every operation runs entirely on the
+     * reactor that owns its connection.
+     */
+    struct Reactor {
+        Reactor(NetworkInterfaceASIO* net, ConnectionPool::Options poolOptions);
+
+        asio::io_service ioService;
+        stdx::thread runner;
+        ConnectionPool connectionPool;
+
+        /**
+         * The explicit strand that the pool's timers run on. This must be the last member of
+         * Reactor because any pending operations for the strand are run when its dtor is
+         * called.
+         */
+        asio::io_service::strand strand;
+    };
+
     /**
      * AsyncConnection encapsulates the per-connection state we maintain.
      */
@@ -269,6 +297,7 @@ private:
         };
 
         AsyncOp(NetworkInterfaceASIO* net,
+                asio::io_service& ioService,
                 const TaskExecutor::CallbackHandle& cbHandle,
                 const RemoteCommandRequest& request,
                 const RemoteCommandCompletionFn& onFinish,
@@ -434,6 +463,9 @@ private:
 
     void _startCommand(AsyncOp* op);
 
+    // Picks the reactor for the next operation or alarm, round-robin.
+    Reactor& _nextReactor();
+
     /**
      * Wraps a completion handler in pre-condition checks.
      * When we resume after an asynchronous call, we may find the following:
@@ -488,9 +520,6 @@ private:
 
     Options _options;
 
-    asio::io_service _io_service;
-    std::vector<stdx::thread> _serviceRunners;
-
     const std::unique_ptr<rpc::EgressMetadataHook> _metadataHook;
 
     const std::unique_ptr<NetworkConnectionHook> _hook;
@@ -501,8 +530,6 @@ private:
 
     std::unique_ptr<AsyncStreamFactoryInterface> _streamFactory;
 
-    ConnectionPool _connectionPool;
-
     // If it is necessary to hold this lock while accessing a particular operation with
     // an AccessControl object, take this lock first, always.
     stdx::mutex _inProgressMutex;
@@ -520,13 +547,12 @@ private:
     stdx::condition_variable _isExecutorRunnableCondition;
 
     /**
-     * The explicit strand that all non-op operations run on. This must be the
-     * last member of NetworkInterfaceASIO because any pending operation for
-     * the strand are run when it's dtor is called. Any members that fall after
-     * it will have already been destroyed, which will make those fields
-     * illegal to touch from callbacks.
+     * The reactors must be the last members of NetworkInterfaceASIO. Destroying one runs or
+     * destroys its pending handlers and shuts down its connection pool, which reach back into
+     * the hooks, factories and bookkeeping above, so those must still be alive.
      */
-    asio::io_service::strand _strand;
+    std::vector<std::unique_ptr<Reactor>> _reactors;
+    AtomicUInt64 _reactorCounter;
 };
 
 template <typename T, typename R, typename... MethodArgs, typename... DeducedArgs>
@@ -37,6 +37,7 @@
 #include "mongo/executor/async_stream_factory.h"
 #include "mongo/executor/async_stream_interface.h"
 #include "mongo/executor/async_timer_asio.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_interface_asio.h"
 #include "mongo/executor/network_interface_asio_test_utils.h"
 #include "mongo/executor/task_executor.h"
@@ -157,6 +158,21 @@ TEST_F(NetworkInterfaceASIOIntegrationTest, Ping) {
     assertCommandOK("admin", BSON("ping" << 1));
 }
 
+TEST_F(NetworkInterfaceASIOIntegrationTest, PingWithMultipleReactors) {
+    NetworkInterfaceASIO::Options options;
+    options.numReactors = 4;
+    startNet(std::move(options));
+
+    // Enough commands to go through every reactor's connection pool at least once.
+    for (int i = 0; i < 8; ++i) {
+        assertCommandOK("admin", BSON("ping" << 1));
+    }
+
+    ConnectionPoolStats stats;
+    net().appendConnectionStats(&stats);
+    ASSERT_GTE(stats.totalCreated, 4u);
+}
+
 TEST_F(NetworkInterfaceASIOIntegrationTest, Timeouts) {
     startNet();
     // This sleep command will take 10 seconds, so we should time out client side first given
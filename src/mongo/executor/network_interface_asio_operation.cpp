@@ -83,6 +83,7 @@ const NetworkInterfaceASIO::TableRow NetworkInterfaceASIO::AsyncOp::kFieldLabels
     "", "id", "states", "start_time", "request"};
 
 NetworkInterfaceASIO::AsyncOp::AsyncOp(NetworkInterfaceASIO* const owner,
+                                       asio::io_service& ioService,
                                        const TaskExecutor::CallbackHandle& cbHandle,
                                        const RemoteCommandRequest& request,
                                        const RemoteCommandCompletionFn& onFinish,
@@ -92,12 +93,12 @@ NetworkInterfaceASIO::AsyncOp::AsyncOp(NetworkInterfaceASIO* const owner,
       _request(request),
       _onFinish(onFinish),
       _start(now),
-      _resolver(owner->_io_service),
+      _resolver(ioService),
       _id(kAsyncOpIdCounter.addAndFetch(1)),
       _access(std::make_shared<AsyncOp::AccessControl>()),
       _inSetup(true),
       _inRefresh(false),
-      _strand(owner->_io_service) {
+      _strand(ioService) {
     // No need to take lock when we aren't yet constructed.
     _transitionToState_inlock(State::kUninitialized);
 }
@@ -45,6 +45,52 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+
+// Number of io_service threads each egress NetworkInterfaceASIO spreads its operations over.
+int networkInterfaceReactorThreads = 1;
+
+class ExportedNetworkInterfaceReactorThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedNetworkInterfaceReactorThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "networkInterfaceReactorThreads",
+              &networkInterfaceReactorThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "networkInterfaceReactorThreads must be at least 1");
+        }
+        return Status::OK();
+    }
+} exportedNetworkInterfaceReactorThreadsParam;
+
+// Number of ready connections each egress connection pool keeps per host beyond the ones in use.
+int connectionPoolMinIdleConnections = 0;
+
+class ExportedConnectionPoolMinIdleConnectionsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedConnectionPoolMinIdleConnectionsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "connectionPoolMinIdleConnections",
+              &connectionPoolMinIdleConnections) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "connectionPoolMinIdleConnections must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedConnectionPoolMinIdleConnectionsParam;
+
+}  // namespace
+
 std::unique_ptr<NetworkInterface> makeNetworkInterface(std::string instanceName) {
     return makeNetworkInterface(std::move(instanceName), nullptr, nullptr);
 }
@@ -58,6 +104,9 @@ std::unique_ptr<NetworkInterface> makeNetworkInterface(
     options.networkConnectionHook = std::move(hook);
     options.metadataHook = std::move(metadataHook);
     options.timerFactory = stdx::make_unique<AsyncTimerFactoryASIO>();
+    options.numReactors = static_cast<size_t>(networkInterfaceReactorThreads);
+    options.connectionPoolOptions.minIdleConnections =
+        static_cast<size_t>(connectionPoolMinIdleConnections);
 
 #ifdef MONGO_CONFIG_SSL
     if (SSLManagerInterface* manager = getSSLManager()) {
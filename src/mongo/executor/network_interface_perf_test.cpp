@@ -56,8 +56,16 @@ namespace {
 
 const std::size_t numOperations = 16384;
 
+// Number of independent request chains kept in flight by the concurrent benchmark.
+const std::size_t numConcurrentChains = 64;
 
-int timeNetworkTestMillis(std::size_t operations, NetworkInterface* net) {
+/**
+ * Runs 'operations' pings against the fixture, split over 'concurrency' chains that each issue
+ * their next request from the completion callback of the previous one.
+ */
+int timeNetworkTestMillis(std::size_t operations,
+                          NetworkInterface* net,
+                          std::size_t concurrency = 1) {
     net->startup();
     auto guard = MakeGuard([&] { net->shutdown(); });
 
@@ -84,13 +92,20 @@ int timeNetworkTestMillis(std::size_t operations, NetworkInterface* net) {
         cv.notify_one();
     };
 
+    // Each chain stops issuing requests once the shared budget of operations is exhausted.
+    std::atomic<int> unstartedOps(operations);  // NOLINT
     func = [&]() {
+        if (unstartedOps.fetch_sub(1) <= 0) {
+            return;
+        }
         RemoteCommandRequest request{
             server, "admin", bsonObjPing, bsonObjPing, nullptr, Milliseconds(-1)};
         net->startCommand(makeCallbackHandle(), request, callback);
     };
 
-    func();
+    for (std::size_t i = 0; i < concurrency; ++i) {
+        func();
+    }
 
     stdx::unique_lock<stdx::mutex> lk(mtx);
     cv.wait(lk, [&] { return remainingOps.load() == 0; });
@@ -109,6 +124,21 @@ TEST(NetworkInterfaceASIO, SerialPerf) {
     log() << "THROUGHPUT asio ping ops/s: " << result;
 }
 
+TEST(NetworkInterfaceASIO, ConcurrentPerfByReactorCount) {
+    for (std::size_t reactors : {1, 2, 4, 8}) {
+        NetworkInterfaceASIO::Options options{};
+        options.streamFactory = stdx::make_unique<AsyncStreamFactory>();
+        options.timerFactory = stdx::make_unique<AsyncTimerFactoryASIO>();
+        options.numReactors = reactors;
+        NetworkInterfaceASIO netAsio{std::move(options)};
+
+        int duration = timeNetworkTestMillis(numOperations, &netAsio, numConcurrentChains);
+        int result = numOperations * 1000 / std::max(duration, 1);
+        log() << "THROUGHPUT asio ping ops/s with " << reactors << " reactor(s) and "
+              << numConcurrentChains << " concurrent requests: " << result;
+    }
+}
+
 }  // namespace
 }  // namespace executor
 }  // namespace mongo
@@ -80,7 +80,7 @@ public:
 
 private:
     // Default values are all empty.
-    BufBuilder _builder{};
+    BufBuilder _builder{PooledBufferTag{}};
     Message _message;
     State _state{State::kCommandReply};
 };
@@ -82,7 +82,7 @@ public:
     Message done() final;
 
 private:
-    BufBuilder _builder{};
+    BufBuilder _builder{PooledBufferTag{}};
     Message _message;
 
     State _state{State::kDatabase};
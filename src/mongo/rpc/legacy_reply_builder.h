@@ -69,7 +69,7 @@ public:
     Protocol getProtocol() const final;
 
 private:
-    BufBuilder _builder{};
+    BufBuilder _builder{PooledBufferTag{}};
     Message _message;
     State _state{State::kCommandReply};
     // For stale config errors we need to set the correct ResultFlag.
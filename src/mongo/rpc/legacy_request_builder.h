@@ -62,7 +62,7 @@ public:
 
 private:
     Message _message;
-    BufBuilder _builder{};
+    BufBuilder _builder{PooledBufferTag{}};
 
     // we need to stash this as we need metadata to
     // upconvert.
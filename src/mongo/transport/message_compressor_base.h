@@ -39,6 +39,7 @@ namespace mongo {
 enum class MessageCompressor : uint8_t {
     kNoop = 0,
     kSnappy = 1,
+    kZlib = 2,
     kExtended = 255,
 };
 
@@ -113,6 +114,34 @@ public:
         return _decompressBytesOut.loadRelaxed();
     }
 
+    /*
+     * This returns the total time in microseconds spent in compressData
+     */
+    int64_t getCompressedMicros() const {
+        return _compressMicros.loadRelaxed();
+    }
+
+    /*
+     * This returns the total time in microseconds spent in decompressData
+     */
+    int64_t getDecompressedMicros() const {
+        return _decompressMicros.loadRelaxed();
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for time spent in compressData. The
+     * compressors run synchronously on the calling thread, so this is effectively CPU time.
+     */
+    void counterHitCompressMicros(int64_t micros) {
+        _compressMicros.addAndFetch(micros);
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for time spent in decompressData.
+     */
+    void counterHitDecompressMicros(int64_t micros) {
+        _decompressMicros.addAndFetch(micros);
+    }
 
 protected:
     /*
@@ -147,5 +176,8 @@ private:
 
     AtomicInt64 _decompressBytesIn;
     AtomicInt64 _decompressBytesOut;
+
+    AtomicInt64 _compressMicros;
+    AtomicInt64 _decompressMicros;
 };
 }  // namespace mongo
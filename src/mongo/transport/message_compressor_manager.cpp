@@ -39,6 +39,7 @@
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -83,6 +84,13 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
     }
     auto compressor = _negotiated[0];
 
+    if (!msg.isContiguous()) {
+        // The compressor needs the whole message in one buffer.
+        Message contiguous(msg);
+        contiguous.makeContiguous();
+        return compressMessage(contiguous);
+    }
+
     LOG(3) << "Compressing message with " << compressor->getName();
 
     auto inputHeader = msg.header();
@@ -98,7 +106,7 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
         return {msg};
     }
 
-    auto outputMessageBuffer = SharedBuffer::allocate(bufferSize);
+    auto outputMessageBuffer = SharedBuffer::allocatePooled(bufferSize);
 
     MsgData::View outMessage(outputMessageBuffer.get());
     outMessage.setId(inputHeader.getId());
@@ -110,7 +118,9 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
+    Timer timer;
     auto sws = compressor->compressData(input, output);
+    compressor->counterHitCompressMicros(timer.micros());
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -133,7 +143,7 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
     }
 
     auto bufferSize = compressionHeader.uncompressedSize + MsgData::MsgDataHeaderSize;
-    auto outputMessageBuffer = SharedBuffer::allocate(bufferSize);
+    auto outputMessageBuffer = SharedBuffer::allocatePooled(bufferSize);
     MsgData::View outMessage(outputMessageBuffer.get());
     outMessage.setId(inputHeader.getId());
     outMessage.setResponseToMsgId(inputHeader.getResponseToMsgId());
@@ -142,7 +152,9 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
 
     DataRangeCursor output(outMessage.data(), outMessage.data() + outMessage.dataLen());
 
+    Timer timer;
     auto sws = compressor->decompressData(input, output);
+    compressor->counterHitDecompressMicros(timer.micros());
 
     if (!sws.isOK())
         return sws.getStatus();
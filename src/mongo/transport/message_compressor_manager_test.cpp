@@ -33,6 +33,7 @@
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/message.h"
 
@@ -182,5 +183,52 @@ TEST(SnappyMessageCompressor, Fidelity) {
     checkFidelity(testMessage, stdx::make_unique<NoopMessageCompressor>());
 }
 
+TEST(ZlibMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>());
+}
+
+TEST(ZlibMessageCompressor, FidelityBestCompression) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>(9));
+}
+
+TEST(ZlibMessageCompressor, CountersAndTiming) {
+    ZlibMessageCompressor compressor;
+    const std::string input(4096, 'a');
+    std::vector<char> compressed(compressor.getMaxCompressedSize(input.size()));
+
+    auto swCompressed = compressor.compressData(ConstDataRange(input.data(), input.size()),
+                                                DataRange(compressed.data(), compressed.size()));
+    ASSERT_OK(swCompressed.getStatus());
+    ASSERT_LT(swCompressed.getValue(), input.size());
+    ASSERT_EQ(compressor.getCompressedBytesIn(), static_cast<int64_t>(input.size()));
+    ASSERT_EQ(compressor.getCompressedBytesOut(), static_cast<int64_t>(swCompressed.getValue()));
+
+    std::vector<char> decompressed(input.size());
+    auto swDecompressed =
+        compressor.decompressData(ConstDataRange(compressed.data(), swCompressed.getValue()),
+                                  DataRange(decompressed.data(), decompressed.size()));
+    ASSERT_OK(swDecompressed.getStatus());
+    ASSERT_EQ(swDecompressed.getValue(), input.size());
+    ASSERT_EQ(compressor.getDecompressedBytesOut(), static_cast<int64_t>(input.size()));
+    ASSERT_EQ(memcmp(decompressed.data(), input.data(), input.size()), 0);
+
+    compressor.counterHitCompressMicros(5);
+    compressor.counterHitDecompressMicros(7);
+    ASSERT_EQ(compressor.getCompressedMicros(), 5);
+    ASSERT_EQ(compressor.getDecompressedMicros(), 7);
+}
+
+TEST(ZlibMessageCompressor, CorruptInput) {
+    ZlibMessageCompressor compressor;
+    const std::string garbage(64, 'x');
+    std::vector<char> output(1024);
+    auto sw = compressor.decompressData(ConstDataRange(garbage.data(), garbage.size()),
+                                        DataRange(output.data(), output.size()));
+    ASSERT_NOT_OK(sw.getStatus());
+    ASSERT_EQ(compressor.getDecompressedBytesIn(), 0);
+}
+
 }  // namespace mongo
 }  // namespace
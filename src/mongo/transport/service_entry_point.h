@@ -54,6 +54,13 @@ public:
      */
     virtual void startSession(transport::Session&& session) = 0;
 
+    /**
+     * Stops running requests for Sessions and waits for any that are running to finish. Called
+     * by a TransportLayer when it shuts down, once it no longer starts operations for Sessions.
+     * Entry points that run each Session on its own detached thread have nothing to do here.
+     */
+    virtual void shutdown() {}
+
 protected:
     ServiceEntryPoint() = default;
 };
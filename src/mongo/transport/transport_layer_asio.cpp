@@ -0,0 +1,516 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_asio.h"
+
+#include "mongo/base/checked_cast.h"
+#include "mongo/config.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/notification.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/listen.h"
+#include "mongo/util/net/sock.h"
+#include "mongo/util/net/ssl_options.h"
+#include "mongo/util/net/ssl_types.h"
+#include "mongo/util/stringutils.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+const size_t kHeaderSize = sizeof(MSGHEADER::Value);
+
+Status errorCodeToStatus(const asio::error_code& ec) {
+    return {ErrorCodes::HostUnreachable, ec.message()};
+}
+
+HostAndPort endpointToHostAndPort(const asio::ip::tcp::endpoint& endpoint) {
+    return HostAndPort(endpoint.address().to_string(), endpoint.port());
+}
+
+}  // namespace
+
+/**
+ * The state associated with one accepted socket. Every asynchronous operation on the socket is
+ * dispatched through the strand so that handlers for the same connection never run concurrently,
+ * even though the io_service is run by several reactor threads.
+ */
+class TransportLayerASIO::Connection : public std::enable_shared_from_this<Connection> {
+    MONGO_DISALLOW_COPYING(Connection);
+
+public:
+    Connection(asio::ip::tcp::socket socket, long long connectionId, Session::TagMask tags)
+        : socket(std::move(socket)),
+          strand(this->socket.get_io_service()),
+          connectionId(connectionId),
+          tags(tags) {}
+
+    /**
+     * Reads one complete Message from the socket into 'message' and runs 'cb' on the strand.
+     */
+    void asyncSourceMessage(Message* message, TicketCallback cb) {
+        auto self = shared_from_this();
+        strand.dispatch([self, message, cb] {
+            self->_readBuffer = SharedBuffer::allocatePooled(kHeaderSize);
+            asio::async_read(
+                self->socket,
+                asio::buffer(self->_readBuffer.get(), kHeaderSize),
+                self->strand.wrap([self, message, cb](const asio::error_code& ec, std::size_t) {
+                    if (ec) {
+                        return cb(errorCodeToStatus(ec));
+                    }
+                    self->_sourceMessageBody(message, std::move(cb));
+                }));
+        });
+    }
+
+    /**
+     * Writes 'message' to the socket in full and runs 'cb' on the strand. The Message buffers,
+     * including any borrowed segments, are kept alive by the pending operation.
+     */
+    void asyncSinkMessage(Message message, TicketCallback cb) {
+        auto self = shared_from_this();
+        std::vector<asio::const_buffer> buffers;
+        message.forEachRange([&buffers](const char* data, std::size_t size) {
+            buffers.emplace_back(data, size);
+        });
+        strand.dispatch([self, message, buffers, cb] {
+            asio::async_write(self->socket,
+                              buffers,
+                              self->strand.wrap([self, message, cb](const asio::error_code& ec,
+                                                                    std::size_t) {
+                                  cb(ec ? errorCodeToStatus(ec) : Status::OK());
+                              }));
+        });
+    }
+
+    /**
+     * Closes the socket, which fails any pending operations with operation_aborted.
+     */
+    void close() {
+        auto self = shared_from_this();
+        strand.dispatch([self] {
+            asio::error_code ec;
+            self->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+            self->socket.close(ec);
+        });
+    }
+
+    asio::ip::tcp::socket socket;
+    asio::io_service::strand strand;
+
+    const long long connectionId;
+    Session::TagMask tags;
+
+private:
+    void _sourceMessageBody(Message* message, TicketCallback cb) {
+        MsgData::View md(_readBuffer.get());
+        const auto msgLen = static_cast<size_t>(md.getLen());
+
+        if (!_sawFirstMessage) {
+            _sawFirstMessage = true;
+            // A non-zero responseTo in the first packet means the client is attempting an SSL
+            // handshake, which this TransportLayer does not speak.
+            if (md.getResponseToMsgId() != 0 && md.getResponseToMsgId() != -1) {
+                return cb({ErrorCodes::ProtocolError,
+                           "SSL handshake received but the asio transport layer does not "
+                           "support SSL"});
+            }
+        }
+
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            return cb({ErrorCodes::ProtocolError,
+                       str::stream() << "recv(): message len " << msgLen << " is invalid. "
+                                     << "Min: " << kHeaderSize << ", Max: "
+                                     << MaxMessageSizeBytes});
+        }
+
+        if (msgLen == kHeaderSize) {
+            message->setData(std::move(_readBuffer));
+            return cb(Status::OK());
+        }
+
+        _readBuffer.realloc(msgLen);
+        auto self = shared_from_this();
+        asio::async_read(
+            socket,
+            asio::buffer(_readBuffer.get() + kHeaderSize, msgLen - kHeaderSize),
+            strand.wrap([self, message, cb](const asio::error_code& ec, std::size_t) {
+                if (ec) {
+                    return cb(errorCodeToStatus(ec));
+                }
+                message->setData(std::move(self->_readBuffer));
+                cb(Status::OK());
+            }));
+    }
+
+    SharedBuffer _readBuffer;
+    bool _sawFirstMessage = false;
+};
+
+TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
+                                       ServiceEntryPoint* sep)
+    : _sep(sep), _options(opts), _running(false) {}
+
+TransportLayerASIO::~TransportLayerASIO() = default;
+
+TransportLayerASIO::ASIOTicket::ASIOTicket(const Session& session,
+                                           Date_t expiration,
+                                           AsyncWork work)
+    : _sessionId(session.id()), _expiration(expiration), _fill(std::move(work)) {}
+
+Session::Id TransportLayerASIO::ASIOTicket::sessionId() const {
+    return _sessionId;
+}
+
+Date_t TransportLayerASIO::ASIOTicket::expiration() const {
+    return _expiration;
+}
+
+Status TransportLayerASIO::setup() {
+#ifdef MONGO_CONFIG_SSL
+    if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+        return {ErrorCodes::BadValue, "The asio transport layer does not support SSL"};
+    }
+#endif
+
+    Listener::checkTicketNumbers();
+
+    std::vector<std::string> ips;
+    if (_options.ipList.empty()) {
+        ips.push_back("0.0.0.0");
+        if (IPv6Enabled()) {
+            ips.push_back("::");
+        }
+    } else {
+        splitStringDelim(_options.ipList, &ips, ',');
+    }
+
+    for (const auto& ip : ips) {
+        asio::error_code ec;
+        auto address = asio::ip::address::from_string(ip, ec);
+        if (ec) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Failed to parse bind address " << ip << ": "
+                                  << ec.message()};
+        }
+
+        asio::ip::tcp::endpoint endpoint(address, _options.port);
+        auto acceptor = stdx::make_unique<Acceptor>(_ioService);
+
+        acceptor->acceptor.open(endpoint.protocol(), ec);
+        if (!ec && address.is_v6()) {
+            // IPv6 can also accept IPv4 connections as mapped addresses (::ffff:127.0.0.1)
+            // That causes a conflict if we don't do set it to IPV6_ONLY
+            acceptor->acceptor.set_option(asio::ip::v6_only(true), ec);
+        }
+        if (!ec) {
+            acceptor->acceptor.set_option(asio::socket_base::reuse_address(true), ec);
+        }
+        if (!ec) {
+            acceptor->acceptor.bind(endpoint, ec);
+        }
+        if (ec) {
+            error() << "listen(): bind() failed " << ec.message() << " for socket: " << ip << ":"
+                    << _options.port;
+            return {ErrorCodes::SocketException, ec.message()};
+        }
+
+        _acceptors.push_back(std::move(acceptor));
+    }
+
+    return Status::OK();
+}
+
+Status TransportLayerASIO::start() {
+    if (_running.swap(true)) {
+        return {ErrorCodes::InternalError, "TransportLayer is already running"};
+    }
+
+    for (auto&& acceptor : _acceptors) {
+        asio::error_code ec;
+        acceptor->acceptor.listen(asio::socket_base::max_connections, ec);
+        if (ec) {
+            error() << "listen(): listen() failed " << ec.message();
+            return {ErrorCodes::SocketException, ec.message()};
+        }
+
+        _acceptConnection(acceptor.get());
+    }
+    log() << "waiting for connections on port " << _options.port;
+
+    auto reactorThreads = _options.reactorThreads;
+    if (reactorThreads == 0) {
+        reactorThreads = std::max(1u, stdx::thread::hardware_concurrency());
+    }
+
+    _ioServiceWork = stdx::make_unique<asio::io_service::work>(_ioService);
+    for (size_t i = 0; i < reactorThreads; ++i) {
+        _reactorThreads.emplace_back([this, i] {
+            setThreadName(str::stream() << "transport-reactor-" << i);
+            _ioService.run();
+        });
+    }
+
+    return Status::OK();
+}
+
+Ticket TransportLayerASIO::sourceMessage(Session& session, Message* message, Date_t expiration) {
+    auto& compressorMgr = session.getCompressorManager();
+    auto sourceCb = [message, &compressorMgr](const ConnectionHandle& conn, TicketCallback cb) {
+        conn->asyncSourceMessage(message, [message, &compressorMgr, cb](Status status) {
+            if (!status.isOK()) {
+                return cb(status);
+            }
+
+            networkCounter.hitPhysical(message->size(), 0);
+            if (message->operation() == dbCompressed) {
+                auto swm = compressorMgr.decompressMessage(*message);
+                if (!swm.isOK()) {
+                    return cb(swm.getStatus());
+                }
+                *message = swm.getValue();
+            }
+            networkCounter.hitLogical(message->size(), 0);
+            cb(Status::OK());
+        });
+    };
+
+    return Ticket(this, stdx::make_unique<ASIOTicket>(session, expiration, std::move(sourceCb)));
+}
+
+Ticket TransportLayerASIO::sinkMessage(Session& session,
+                                       const Message& message,
+                                       Date_t expiration) {
+    auto& compressorMgr = session.getCompressorManager();
+    auto sinkCb = [&message, &compressorMgr](const ConnectionHandle& conn, TicketCallback cb) {
+        networkCounter.hitLogical(0, message.size());
+        auto swm = compressorMgr.compressMessage(message);
+        if (!swm.isOK()) {
+            return cb(swm.getStatus());
+        }
+
+        const auto& compressedMessage = swm.getValue();
+        const auto physicalSize = compressedMessage.size();
+        conn->asyncSinkMessage(compressedMessage, [physicalSize, cb](Status status) {
+            if (status.isOK()) {
+                networkCounter.hitPhysical(0, physicalSize);
+            }
+            cb(status);
+        });
+    };
+
+    return Ticket(this, stdx::make_unique<ASIOTicket>(session, expiration, std::move(sinkCb)));
+}
+
+Status TransportLayerASIO::wait(Ticket&& ticket) {
+    Notification<Status> result;
+    asyncWait(std::move(ticket), [&result](Status status) { result.set(std::move(status)); });
+    return result.get();
+}
+
+void TransportLayerASIO::asyncWait(Ticket&& ticket, TicketCallback callback) {
+    if (!_running.load()) {
+        return callback(TransportLayer::ShutdownStatus);
+    }
+
+    if (ticket.expiration() < Date_t::now()) {
+        return callback(Ticket::ExpiredStatus);
+    }
+
+    ConnectionHandle conn;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+        auto it = _connections.find(ticket.sessionId());
+        if (it == _connections.end()) {
+            return callback(TransportLayer::TicketSessionUnknownStatus);
+        }
+        conn = it->second;
+    }
+
+    auto asioTicket = checked_cast<ASIOTicket*>(getTicketImpl(ticket));
+    asioTicket->_fill(conn, std::move(callback));
+}
+
+void TransportLayerASIO::registerTags(const Session& session) {
+    stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+    auto conn = _connections.find(session.id());
+    if (conn != _connections.end()) {
+        conn->second->tags = session.getTags();
+    }
+}
+
+SSLPeerInfo TransportLayerASIO::getX509PeerInfo(const Session& session) const {
+    // SSL is rejected in setup(), so there is never any peer certificate information.
+    return SSLPeerInfo();
+}
+
+TransportLayer::Stats TransportLayerASIO::sessionStats() {
+    Stats stats;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+        stats.numOpenSessions = _connections.size();
+    }
+
+    stats.numAvailableSessions = Listener::globalTicketHolder.available();
+    stats.numCreatedSessions = Listener::globalConnectionNumber.load();
+
+    return stats;
+}
+
+void TransportLayerASIO::end(Session& session) {
+    stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+    auto conn = _connections.find(session.id());
+    if (conn != _connections.end()) {
+        _endSession_inlock(conn);
+    }
+}
+
+void TransportLayerASIO::_endSession_inlock(ConnectionMap::iterator conn) {
+    // Outstanding operations hold their own reference to the Connection, so it is safe to drop
+    // ours here; they will complete with an error once the socket is closed.
+    conn->second->close();
+    Listener::globalTicketHolder.release();
+    _connections.erase(conn);
+}
+
+void TransportLayerASIO::endAllSessions(Session::TagMask tags) {
+    log() << "asio transport layer ending all sessions";
+    {
+        stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+        auto conn = _connections.begin();
+        while (conn != _connections.end()) {
+            // If we erase this connection below, we invalidate our iterator, use a placeholder.
+            auto placeholder = conn;
+            placeholder++;
+
+            if (conn->second->tags & tags) {
+                log() << "Skip closing connection for connection # " << conn->second->connectionId;
+            } else {
+                _endSession_inlock(conn);
+            }
+
+            conn = placeholder;
+        }
+    }
+}
+
+void TransportLayerASIO::shutdown() {
+    if (!_running.swap(false)) {
+        return;
+    }
+    endAllSessions(Session::kEmptyTagMask);
+
+    _ioServiceWork.reset();
+    _ioService.stop();
+    for (auto&& thread : _reactorThreads) {
+        thread.join();
+    }
+    _reactorThreads.clear();
+
+    // No reactor threads are left to race with, so the acceptors can be closed directly.
+    for (auto&& acceptor : _acceptors) {
+        asio::error_code ec;
+        acceptor->acceptor.close(ec);
+    }
+
+    // Requests already handed to the ServiceEntryPoint may still be running on its own threads.
+    invariant(_sep);
+    _sep->shutdown();
+}
+
+void TransportLayerASIO::_acceptConnection(Acceptor* acceptor) {
+    acceptor->acceptor.async_accept(acceptor->peer, [this, acceptor](const asio::error_code& ec) {
+        if (ec == asio::error::operation_aborted || !_running.load()) {
+            return;
+        }
+
+        if (ec) {
+            log() << "Error accepting new connection: " << ec.message();
+        } else {
+            _handleNewConnection(std::move(acceptor->peer));
+        }
+
+        acceptor->peer = asio::ip::tcp::socket(_ioService);
+        _acceptConnection(acceptor);
+    });
+}
+
+void TransportLayerASIO::_handleNewConnection(asio::ip::tcp::socket peer) {
+    if (!Listener::globalTicketHolder.tryAcquire()) {
+        log() << "connection refused because too many open connections: "
+              << Listener::globalTicketHolder.used();
+        asio::error_code ec;
+        peer.close(ec);
+        return;
+    }
+
+    asio::error_code ec;
+    const auto remote = peer.remote_endpoint(ec);
+    const auto local = ec ? asio::ip::tcp::endpoint() : peer.local_endpoint(ec);
+    if (ec) {
+        LOG(1) << "Connection closed before it could be registered: " << ec.message();
+        Listener::globalTicketHolder.release();
+        return;
+    }
+
+    peer.set_option(asio::ip::tcp::no_delay(true), ec);
+    peer.set_option(asio::socket_base::keep_alive(true), ec);
+
+    const long long connectionId = Listener::globalConnectionNumber.addAndFetch(1);
+    if (!serverGlobalParams.quiet) {
+        int conns = Listener::globalTicketHolder.used();
+        const char* word = (conns == 1 ? " connection" : " connections");
+        log() << "connection accepted from " << endpointToHostAndPort(remote) << " #"
+              << connectionId << " (" << conns << word << " now open)";
+    }
+
+    Session session(endpointToHostAndPort(remote), endpointToHostAndPort(local), this);
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+        _connections.emplace(
+            session.id(),
+            std::make_shared<Connection>(std::move(peer), connectionId, session.getTags()));
+    }
+
+    invariant(_sep);
+    _sep->startSession(std::move(session));
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <asio.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/transport/ticket_impl.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+class ServiceEntryPoint;
+
+namespace transport {
+
+/**
+ * A TransportLayer implementation driven by a small, fixed set of asio reactor threads.
+ *
+ * Unlike TransportLayerLegacy, no thread is bound to a connection: sockets are accepted, read
+ * from and written to with asynchronous operations that run on the reactor threads, so the
+ * per-connection cost is a socket plus a small amount of bookkeeping. Messages are only handed
+ * to the caller once they have been received in full.
+ *
+ * Both wait() and asyncWait() are supported. wait() blocks the calling thread until the
+ * asynchronous operation completes on a reactor thread; asyncWait() returns immediately and
+ * runs its callback on a reactor thread, which must therefore not block.
+ *
+ * Operations on a single Session are serialized through a per-connection strand; callers must
+ * not have more than one source and one sink Ticket outstanding for a Session at a time.
+ *
+ * As with TransportLayerLegacy, a Ticket's expiration is only checked when wait() or asyncWait()
+ * is called. An operation that has already started is not cancelled when its Ticket expires.
+ */
+class TransportLayerASIO final : public TransportLayer {
+    MONGO_DISALLOW_COPYING(TransportLayerASIO);
+
+public:
+    struct Options {
+        int port = 0;               // port to bind to
+        std::string ipList;         // addresses to bind to
+        size_t reactorThreads = 0;  // number of reactor threads, 0 means one per core
+    };
+
+    TransportLayerASIO(const Options& opts, ServiceEntryPoint* sep);
+
+    ~TransportLayerASIO();
+
+    Status setup();
+    Status start() override;
+
+    Ticket sourceMessage(Session& session,
+                         Message* message,
+                         Date_t expiration = Ticket::kNoExpirationDate) override;
+
+    Ticket sinkMessage(Session& session,
+                       const Message& message,
+                       Date_t expiration = Ticket::kNoExpirationDate) override;
+
+    Status wait(Ticket&& ticket) override;
+    void asyncWait(Ticket&& ticket, TicketCallback callback) override;
+
+    void registerTags(const Session& session) override;
+    SSLPeerInfo getX509PeerInfo(const Session& session) const override;
+
+    Stats sessionStats() override;
+
+    void end(Session& session) override;
+    void endAllSessions(transport::Session::TagMask tags) override;
+
+    void shutdown() override;
+
+private:
+    class Connection;
+    using ConnectionHandle = std::shared_ptr<Connection>;
+    using ConnectionMap = stdx::unordered_map<Session::Id, ConnectionHandle>;
+
+    /**
+     * Starts the asynchronous operation represented by a Ticket on the given connection. The
+     * callback must be invoked exactly once, on a reactor thread.
+     */
+    using AsyncWork = stdx::function<void(const ConnectionHandle&, TicketCallback)>;
+
+    /**
+     * A TicketImpl implementation for this TransportLayer. AsyncWork is a callable that starts
+     * the operation that fills this ticket.
+     */
+    class ASIOTicket : public TicketImpl {
+        MONGO_DISALLOW_COPYING(ASIOTicket);
+
+    public:
+        ASIOTicket(const Session& session, Date_t expiration, AsyncWork work);
+
+        SessionId sessionId() const override;
+        Date_t expiration() const override;
+
+        SessionId _sessionId;
+        Date_t _expiration;
+
+        AsyncWork _fill;
+    };
+
+    /**
+     * An acceptor together with the socket its next connection will be accepted into.
+     */
+    struct Acceptor {
+        explicit Acceptor(asio::io_service& ioService) : acceptor(ioService), peer(ioService) {}
+
+        asio::ip::tcp::acceptor acceptor;
+        asio::ip::tcp::socket peer;
+    };
+
+    void _acceptConnection(Acceptor* acceptor);
+    void _handleNewConnection(asio::ip::tcp::socket peer);
+
+    void _endSession_inlock(ConnectionMap::iterator conn);
+
+    ServiceEntryPoint* _sep;
+    Options _options;
+
+    asio::io_service _ioService;
+    std::unique_ptr<asio::io_service::work> _ioServiceWork;
+    std::vector<std::unique_ptr<Acceptor>> _acceptors;
+    std::vector<stdx::thread> _reactorThreads;
+
+    mutable stdx::mutex _connectionsMutex;
+    ConnectionMap _connections;
+
+    AtomicWord<bool> _running;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_asio.h"
+
+#include <asio.hpp>
+#include <vector>
+
+#include "mongo/config.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/session.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/ssl_options.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+/**
+ * Keeps the Sessions it is handed, without running them, and records whether it was shut down.
+ */
+class ServiceEntryPointRecorder final : public ServiceEntryPoint {
+public:
+    void startSession(Session&& session) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sessions.push_back(std::move(session));
+        _sessionStarted.notify_all();
+    }
+
+    void shutdown() override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        ++_numShutdowns;
+    }
+
+    bool waitForSessions(size_t count) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        return _sessionStarted.wait_for(
+            lk, Seconds(10).toSystemDuration(), [&] { return _sessions.size() >= count; });
+    }
+
+    int numShutdowns() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _numShutdowns;
+    }
+
+    // Sessions end themselves on their TransportLayer when destroyed, so this must be called
+    // before the TransportLayer goes away.
+    void clearSessions() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sessions.clear();
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _sessionStarted;
+    std::vector<Session> _sessions;
+    int _numShutdowns = 0;
+};
+
+// Returns a loopback port that was free a moment ago.
+int findFreePort() {
+    asio::io_service ioService;
+    asio::ip::tcp::acceptor acceptor(
+        ioService, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    return acceptor.local_endpoint().port();
+}
+
+TransportLayerASIO::Options makeOptions(int port) {
+    TransportLayerASIO::Options opts;
+    opts.port = port;
+    opts.ipList = "127.0.0.1";
+    opts.reactorThreads = 2;
+    return opts;
+}
+
+TEST(TransportLayerASIOTest, StartAndShutdownWithoutConnections) {
+    ServiceEntryPointRecorder sep;
+    TransportLayerASIO tl(makeOptions(findFreePort()), &sep);
+
+    ASSERT_OK(tl.setup());
+    ASSERT_OK(tl.start());
+    ASSERT_EQUALS(ErrorCodes::InternalError, tl.start());
+
+    tl.shutdown();
+    ASSERT_EQUALS(1, sep.numShutdowns());
+
+    // Shutting down again does nothing.
+    tl.shutdown();
+    ASSERT_EQUALS(1, sep.numShutdowns());
+}
+
+TEST(TransportLayerASIOTest, AcceptsConnectionsAndEndsThemOnShutdown) {
+    ServiceEntryPointRecorder sep;
+    const int port = findFreePort();
+    TransportLayerASIO tl(makeOptions(port), &sep);
+    ASSERT_OK(tl.setup());
+    ASSERT_OK(tl.start());
+
+    asio::io_service ioService;
+    std::vector<asio::ip::tcp::socket> clients;
+    for (int i = 0; i < 3; ++i) {
+        clients.emplace_back(ioService);
+        clients.back().connect(
+            asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port));
+    }
+
+    ASSERT_TRUE(sep.waitForSessions(clients.size()));
+    ASSERT_EQUALS(clients.size(), tl.sessionStats().numOpenSessions);
+
+    tl.shutdown();
+    ASSERT_EQUALS(1, sep.numShutdowns());
+    ASSERT_EQUALS(0U, tl.sessionStats().numOpenSessions);
+
+    // The server closed every connection.
+    for (auto&& client : clients) {
+        char byte;
+        asio::error_code ec;
+        client.read_some(asio::buffer(&byte, 1), ec);
+        ASSERT_TRUE(ec);
+    }
+
+    sep.clearSessions();
+}
+
+TEST(TransportLayerASIOTest, WaitFailsForUnknownSessionsAndAfterShutdown) {
+    ServiceEntryPointRecorder sep;
+    TransportLayerASIO tl(makeOptions(findFreePort()), &sep);
+    ASSERT_OK(tl.setup());
+    ASSERT_OK(tl.start());
+
+    // A Session the TransportLayer did not accept.
+    Session session(HostAndPort("127.0.0.1", 1), HostAndPort("127.0.0.1", 2), &tl);
+    Message message;
+    ASSERT_EQUALS(TransportLayer::TicketSessionUnknownStatus,
+                  tl.wait(tl.sourceMessage(session, &message)));
+
+    // An already expired Ticket.
+    ASSERT_EQUALS(Ticket::ExpiredStatus,
+                  tl.wait(tl.sourceMessage(session, &message, Date_t::now() - Seconds(1))));
+
+    tl.shutdown();
+    ASSERT_EQUALS(TransportLayer::ShutdownStatus, tl.wait(tl.sourceMessage(session, &message)));
+}
+
+#ifdef MONGO_CONFIG_SSL
+TEST(TransportLayerASIOTest, SetupRejectsSSL) {
+    const auto oldMode = sslGlobalParams.sslMode.load();
+    sslGlobalParams.sslMode.store(SSLParams::SSLMode_requireSSL);
+    ON_BLOCK_EXIT([&] { sslGlobalParams.sslMode.store(oldMode); });
+
+    ServiceEntryPointRecorder sep;
+    TransportLayerASIO tl(makeOptions(findFreePort()), &sep);
+    ASSERT_EQUALS(ErrorCodes::BadValue, tl.setup());
+}
+#endif
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
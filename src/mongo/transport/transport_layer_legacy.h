@@ -130,6 +130,10 @@ private:
             return true;
         }
 
+        bool supportsConcurrentAccept() const override {
+            return true;
+        }
+
     private:
         NewConnectionCb _accepted;
     };
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_startup_param.h"
+
+#include <string>
+
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+namespace transport {
+
+namespace {
+
+const char kTransportLayerASIO[] = "asio";
+const char kTransportLayerLegacy[] = "legacy";
+
+std::string transportLayer = kTransportLayerLegacy;
+
+class ExportedTransportLayerParameter
+    : public ExportedServerParameter<std::string, ServerParameterType::kStartupOnly> {
+public:
+    ExportedTransportLayerParameter()
+        : ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), "transportLayer", &transportLayer) {}
+
+    virtual Status validate(const std::string& potentialNewValue) {
+        if (potentialNewValue != kTransportLayerASIO &&
+            potentialNewValue != kTransportLayerLegacy) {
+            return Status(ErrorCodes::BadValue,
+                          "unsupported transport layer option: " + potentialNewValue);
+        }
+        return Status::OK();
+    }
+} exportedTransportLayerParam;
+
+int transportLayerASIOReactorThreads = 0;
+
+class ExportedTransportLayerASIOReactorThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedTransportLayerASIOReactorThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "transportLayerASIOReactorThreads",
+              &transportLayerASIOReactorThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "transportLayerASIOReactorThreads must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} exportedTransportLayerASIOReactorThreadsParam;
+
+}  // namespace
+
+bool isTransportLayerASIO() {
+    return transportLayer == kTransportLayerASIO;
+}
+
+std::size_t getTransportLayerASIOReactorThreads() {
+    return static_cast<std::size_t>(transportLayerASIOReactorThreads);
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,451 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_thread_pool.h"
+
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicInt32 nextUnnamedAdaptiveThreadPoolId{1};
+
+/**
+ * Sets defaults and checks bounds limits on "options", and returns it.
+ */
+AdaptiveThreadPool::Options cleanUpOptions(AdaptiveThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "AdaptiveThreadPool"
+                                         << nextUnnamedAdaptiveThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.minThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with a minimum of "
+                 << options.minThreads << " but the minimum must be at least 1";
+        fassertFailed(40312);
+    }
+    if (options.minThreads > options.maxThreads) {
+        severe() << "Tried to create pool " << options.poolName << " with a minimum of "
+                 << options.minThreads << " which is more than the configured maximum of "
+                 << options.maxThreads;
+        fassertFailed(40313);
+    }
+    return options;
+}
+
+/**
+ * Returns the user plus system CPU time consumed by this process so far, in microseconds, or 0 if
+ * it cannot be determined.
+ */
+uint64_t processCpuTimeMicros() {
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    auto toMicros = [](const FILETIME& ft) {
+        ULARGE_INTEGER li;
+        li.LowPart = ft.dwLowDateTime;
+        li.HighPart = ft.dwHighDateTime;
+        return li.QuadPart / 10;  // FILETIME is in 100ns units
+    };
+    return toMicros(kernelTime) + toMicros(userTime);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    auto toMicros = [](const struct timeval& tv) {
+        return static_cast<uint64_t>(tv.tv_sec) * 1000 * 1000 + tv.tv_usec;
+    };
+    return toMicros(usage.ru_utime) + toMicros(usage.ru_stime);
+#endif
+}
+
+}  // namespace
+
+AdaptiveThreadPool::AdaptiveThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))) {}
+
+AdaptiveThreadPool::~AdaptiveThreadPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+    if (shutdownComplete != _state) {
+        _join_inlock(&lk);
+    }
+
+    if (shutdownComplete != _state) {
+        severe() << "Failed to shutdown pool during destruction";
+        fassertFailed(40314);
+    }
+    invariant(_threads.empty());
+    invariant(_pendingTasks.empty());
+}
+
+void AdaptiveThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(40315);
+    }
+    _setState_inlock(running);
+    invariant(_threads.empty());
+    for (size_t i = 0; i < _options.minThreads; ++i) {
+        _startWorkerThread_inlock();
+    }
+    _controller = stdx::thread([this] { _controllerThreadBody(); });
+}
+
+void AdaptiveThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void AdaptiveThreadPool::_shutdown_inlock() {
+    switch (_state) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            _workAvailable.notify_all();
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void AdaptiveThreadPool::join() {
+    try {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _join_inlock(&lk);
+    } catch (...) {
+        severe() << "Exception escaped join in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void AdaptiveThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
+    _stateChange.wait(*lk, [this] {
+        switch (_state) {
+            case preStart:
+                return false;
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(40316);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    ++_numIdleThreads;
+    while (!_pendingTasks.empty()) {
+        _doOneTask(lk);
+    }
+    --_numIdleThreads;
+    ThreadList threadsToJoin;
+    swap(threadsToJoin, _threads);
+    stdx::thread controller;
+    swap(controller, _controller);
+    lk->unlock();
+    for (auto& t : threadsToJoin) {
+        t.join();
+    }
+    if (controller.joinable()) {
+        controller.join();
+    }
+    lk->lock();
+    invariant(_state == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+Status AdaptiveThreadPool::schedule(Task task) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    switch (_state) {
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return Status(ErrorCodes::ShutdownInProgress,
+                          str::stream() << "Shutdown of thread pool " << _options.poolName
+                                        << " in progress");
+        case preStart:
+        case running:
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+    _pendingTasks.push_back({std::move(task), curTimeMicros64()});
+    if (_state == preStart) {
+        return Status::OK();
+    }
+    _workAvailable.notify_one();
+    return Status::OK();
+}
+
+AdaptiveThreadPool::Stats AdaptiveThreadPool::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Stats result;
+    result.numThreads = _threads.size();
+    result.numIdleThreads = _numIdleThreads;
+    result.numPendingTasks = _pendingTasks.size();
+    if (!_pendingTasks.empty()) {
+        const auto now = curTimeMicros64();
+        const auto enqueued = _pendingTasks.front().enqueueTimeMicros;
+        result.oldestPendingTaskAge =
+            Microseconds(static_cast<long long>(now > enqueued ? now - enqueued : 0));
+    }
+    result.totalTasksExecuted = _totalTasksExecuted;
+    result.totalQueueWaitTime = Microseconds(static_cast<long long>(_totalQueueWaitMicros));
+    result.totalExecutionTime = Microseconds(static_cast<long long>(_totalExecutionMicros));
+    result.totalThreadsStarted = _totalThreadsStarted;
+    result.totalThreadsRetired = _totalThreadsRetired;
+    result.totalCpuSaturatedIntervals = _totalCpuSaturatedIntervals;
+    result.cpuUtilization = _cpuUtilization;
+    return result;
+}
+
+void AdaptiveThreadPool::_workerThreadBody(AdaptiveThreadPool* pool,
+                                           const std::string& threadName) {
+    setThreadName(threadName);
+    pool->_options.onCreateThread(threadName);
+    const auto poolName = pool->_options.poolName;
+    LOG(1) << "starting thread in pool " << poolName;
+    try {
+        pool->_consumeTasks();
+    } catch (...) {
+        severe() << "Exception reached top of stack in thread pool " << poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+
+    // At this point, another thread may have destroyed "pool", if this thread chose to detach
+    // itself and remove itself from pool->_threads before releasing pool->_mutex.  Do not access
+    // member variables of "pool" from here, on.
+    LOG(1) << "shutting down thread in pool " << poolName;
+}
+
+void AdaptiveThreadPool::_consumeTasks() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_state == running) {
+        if (!_pendingTasks.empty()) {
+            _doOneTask(&lk);
+            continue;
+        }
+
+        if (_threads.size() <= _options.minThreads) {
+            _workAvailable.wait(lk);
+            continue;
+        }
+
+        // Since there are more than minThreads threads, this thread retires if it stays idle for
+        // maxIdleThreadAge.
+        const auto retirementDate = Date_t::now() + _options.maxIdleThreadAge;
+        const bool woken = _workAvailable.wait_until(
+            lk, retirementDate.toSystemTimePoint(), [this] {
+                return !_pendingTasks.empty() || _state != running;
+            });
+        if (!woken && _threads.size() > _options.minThreads) {
+            break;
+        }
+    }
+
+    // We still hold the lock, but this thread is retiring. If the whole pool is shutting down, this
+    // thread lends a hand in draining the work pool and returns so it can be joined. Otherwise, it
+    // falls through to the detach code, below.
+
+    if (_state == joinRequired || _state == joining) {
+        // Drain the leftover pending tasks.
+        while (!_pendingTasks.empty()) {
+            _doOneTask(&lk);
+        }
+        --_numIdleThreads;
+        return;
+    }
+    --_numIdleThreads;
+
+    if (_state != running) {
+        severe() << "State of pool " << _options.poolName << " is " << static_cast<int32_t>(_state)
+                 << ", but expected " << static_cast<int32_t>(running);
+        fassertFailedNoTrace(40317);
+    }
+
+    // This thread is ending because it was idle for too long.  Find self in _threads, remove self
+    // from _threads, detach self.
+    ++_totalThreadsRetired;
+    LOG(1) << "Retiring idle thread in pool " << _options.poolName << "; "
+           << _threads.size() - 1 << " thread(s) remain";
+    for (size_t i = 0; i < _threads.size(); ++i) {
+        auto& t = _threads[i];
+        if (t.get_id() != stdx::this_thread::get_id()) {
+            continue;
+        }
+        t.detach();
+        t.swap(_threads.back());
+        _threads.pop_back();
+        return;
+    }
+    severe().stream() << "Could not find this thread, with id " << stdx::this_thread::get_id()
+                      << " in pool " << _options.poolName;
+    fassertFailedNoTrace(40318);
+}
+
+void AdaptiveThreadPool::_doOneTask(stdx::unique_lock<stdx::mutex>* lk) {
+    invariant(!_pendingTasks.empty());
+    try {
+        Task task = std::move(_pendingTasks.front().task);
+        const auto enqueueTimeMicros = _pendingTasks.front().enqueueTimeMicros;
+        _pendingTasks.pop_front();
+        --_numIdleThreads;
+        lk->unlock();
+        const auto startTimeMicros = curTimeMicros64();
+        task();
+        const auto endTimeMicros = curTimeMicros64();
+        lk->lock();
+        ++_numIdleThreads;
+        ++_totalTasksExecuted;
+        if (startTimeMicros > enqueueTimeMicros) {
+            _totalQueueWaitMicros += startTimeMicros - enqueueTimeMicros;
+        }
+        if (endTimeMicros > startTimeMicros) {
+            _totalExecutionMicros += endTimeMicros - startTimeMicros;
+        }
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void AdaptiveThreadPool::_controllerThreadBody() {
+    setThreadName(str::stream() << _options.poolName << "-controller");
+    const auto numCores = std::max(1u, stdx::thread::hardware_concurrency());
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lastSampleMicros = curTimeMicros64();
+    auto lastCpuTimeMicros = processCpuTimeMicros();
+    while (_state == running) {
+        const auto nextSampleDate = Date_t::now() + _options.controllerInterval;
+        _stateChange.wait_until(lk, nextSampleDate.toSystemTimePoint(), [this] {
+            return _state != running;
+        });
+        if (_state != running) {
+            break;
+        }
+
+        const auto nowMicros = curTimeMicros64();
+        const auto cpuTimeMicros = processCpuTimeMicros();
+        if (nowMicros > lastSampleMicros && cpuTimeMicros >= lastCpuTimeMicros) {
+            _cpuUtilization = static_cast<double>(cpuTimeMicros - lastCpuTimeMicros) /
+                (static_cast<double>(nowMicros - lastSampleMicros) * numCores);
+        }
+        lastSampleMicros = nowMicros;
+        lastCpuTimeMicros = cpuTimeMicros;
+
+        if (_pendingTasks.empty() || _numIdleThreads > 0 ||
+            _threads.size() >= _options.maxThreads) {
+            continue;
+        }
+
+        const auto enqueueTimeMicros = _pendingTasks.front().enqueueTimeMicros;
+        const auto queueLatency = Microseconds(static_cast<long long>(
+            nowMicros > enqueueTimeMicros ? nowMicros - enqueueTimeMicros : 0));
+        if (queueLatency < _options.targetQueueLatency) {
+            continue;
+        }
+
+        // More threads only help if the running ones are blocked rather than busy on the CPUs.
+        if (_threads.size() >= numCores && _cpuUtilization >= _options.cpuSaturationThreshold) {
+            ++_totalCpuSaturatedIntervals;
+            continue;
+        }
+
+        LOG(2) << "Adding a thread to pool " << _options.poolName << "; oldest task has waited "
+               << queueLatency << " and CPU utilization is " << _cpuUtilization;
+        _startWorkerThread_inlock();
+    }
+}
+
+void AdaptiveThreadPool::_startWorkerThread_inlock() {
+    if (_state != running) {
+        LOG(1) << "Not starting new thread in pool " << _options.poolName
+               << " because it is not running";
+        return;
+    }
+    if (_threads.size() == _options.maxThreads) {
+        LOG(2) << "Not starting new thread in pool " << _options.poolName
+               << " because it already has " << _options.maxThreads << ", its maximum";
+        return;
+    }
+    invariant(_threads.size() < _options.maxThreads);
+    const std::string threadName = str::stream() << _options.threadNamePrefix << _nextThreadId++;
+    try {
+        _threads.emplace_back(stdx::bind(&AdaptiveThreadPool::_workerThreadBody, this, threadName));
+        ++_numIdleThreads;
+        ++_totalThreadsStarted;
+    } catch (const std::exception& ex) {
+        error() << "Failed to start " << threadName << "; " << _threads.size()
+                << " other thread(s) still running in pool " << _options.poolName
+                << "; caught exception: " << redact(ex.what());
+    }
+}
+
+void AdaptiveThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,240 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A thread pool whose size follows the load placed on it, rather than the number of tasks
+ * submitted to it.
+ *
+ * Unlike ThreadPool, scheduling a task never starts a thread by itself. Instead, a controller
+ * thread periodically samples how long the oldest queued task has been waiting and how busy the
+ * CPUs of the process are. A thread is added when tasks have been queued for longer than
+ * targetQueueLatency and the CPUs are not already saturated, so that tasks which block (on I/O or
+ * locks) get more threads while CPU-bound work does not oversubscribe the cores. Threads above
+ * minThreads retire once they have been idle for maxIdleThreadAge.
+ *
+ * See the Options struct for information about how to configure an instance.
+ */
+class AdaptiveThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(AdaptiveThreadPool);
+
+public:
+    /**
+     * Structure used to configure an instance of AdaptiveThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a
+        // name unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. If empty, the prefix will be the pool
+        // name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of threads started at startup, below which the pool never shrinks.
+        size_t minThreads = 1;
+
+        // The pool will never grow to contain more than this many threads.
+        size_t maxThreads = 64;
+
+        // The controller adds a thread when the oldest queued task has waited at least this long
+        // and no thread is idle.
+        Microseconds targetQueueLatency = Milliseconds{1};
+
+        // How often the controller re-evaluates the size of the pool.
+        Milliseconds controllerInterval{10};
+
+        // A thread above minThreads retires once it has been idle for this long.
+        Milliseconds maxIdleThreadAge = Seconds{5};
+
+        // Once the pool has at least one thread per core, the controller does not add threads
+        // while the CPU utilization of the process, as a fraction of all cores, is at or above
+        // this threshold.
+        double cpuSaturationThreshold = 0.9;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The number of threads currently in the pool, idle or active.
+        size_t numThreads = 0;
+
+        // The number of idle threads currently in the pool.
+        size_t numIdleThreads = 0;
+
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks = 0;
+
+        // How long the oldest pending task has been waiting.
+        Microseconds oldestPendingTaskAge{0};
+
+        // Totals over the lifetime of the pool.
+        uint64_t totalTasksExecuted = 0;
+        Microseconds totalQueueWaitTime{0};
+        Microseconds totalExecutionTime{0};
+        uint64_t totalThreadsStarted = 0;
+        uint64_t totalThreadsRetired = 0;
+
+        // Number of controller intervals in which a thread was needed but not started because
+        // the CPUs were saturated.
+        uint64_t totalCpuSaturatedIntervals = 0;
+
+        // CPU utilization of the process, as a fraction of all cores, over the last controller
+        // interval.
+        double cpuUtilization = 0;
+    };
+
+    /**
+     * Constructs a thread pool, configured with the given "options".
+     */
+    explicit AdaptiveThreadPool(Options options);
+
+    ~AdaptiveThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+    /**
+     * Returns statistics about the thread pool's utilization.
+     */
+    Stats getStats() const;
+
+private:
+    struct PendingTask {
+        Task task;
+        uint64_t enqueueTimeMicros;
+    };
+
+    using TaskList = std::deque<PendingTask>;
+    using ThreadList = std::vector<stdx::thread>;
+
+    /**
+     * Representation of the stage of life of a thread pool; see ThreadPool::LifecycleState.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * This is the thread body for worker threads. It is a static member function because a
+     * retiring thread detaches itself, after which the pool may be destroyed while the thread is
+     * still finishing up.
+     */
+    static void _workerThreadBody(AdaptiveThreadPool* pool, const std::string& threadName);
+
+    /**
+     * This is the run loop of a worker thread, invoked by _workerThreadBody.
+     */
+    void _consumeTasks();
+
+    /**
+     * This is the thread body of the controller, which resizes the pool while it is running.
+     */
+    void _controllerThreadBody();
+
+    /**
+     * Starts a worker thread, unless maxThreads threads are already running or _state is not
+     * running.
+     */
+    void _startWorkerThread_inlock();
+
+    void _shutdown_inlock();
+    void _join_inlock(stdx::unique_lock<stdx::mutex>* lk);
+
+    /**
+     * Executes one task from _pendingTasks. "lk" must own _mutex, and _pendingTasks must have at
+     * least one entry.
+     */
+    void _doOneTask(stdx::unique_lock<stdx::mutex>* lk);
+
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // Mutex guarding all non-const member variables.
+    mutable stdx::mutex _mutex;
+
+    LifecycleState _state = preStart;
+
+    // Condition signaled to indicate that there is work in the _pendingTasks queue, or
+    // that the system is shutting down.
+    stdx::condition_variable _workAvailable;
+
+    // Condition variable signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+
+    // Queue of yet-to-be-executed tasks.
+    TaskList _pendingTasks;
+
+    // List of threads serving as the worker pool.
+    ThreadList _threads;
+
+    // The controller thread, started by startup().
+    stdx::thread _controller;
+
+    // Count of idle threads.
+    size_t _numIdleThreads = 0;
+
+    // Id counter for assigning thread names
+    size_t _nextThreadId = 0;
+
+    // Lifetime counters reported by getStats().
+    uint64_t _totalTasksExecuted = 0;
+    uint64_t _totalQueueWaitMicros = 0;
+    uint64_t _totalExecutionMicros = 0;
+    uint64_t _totalThreadsStarted = 0;
+    uint64_t _totalThreadsRetired = 0;
+    uint64_t _totalCpuSaturatedIntervals = 0;
+    double _cpuUtilization = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,201 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/init.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/adaptive_thread_pool.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(AdaptiveThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("AdaptiveThreadPoolCommon", []() {
+        return stdx::make_unique<AdaptiveThreadPool>(AdaptiveThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+class AdaptiveThreadPoolTest : public unittest::Test {
+protected:
+    AdaptiveThreadPool& makePool(AdaptiveThreadPool::Options options) {
+        ASSERT(!_pool);
+        _pool.emplace(std::move(options));
+        return *_pool;
+    }
+
+    void blockingWork() {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        ++count1;
+        cv1.notify_all();
+        while (!flag2) {
+            cv2.wait(lk);
+        }
+    }
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv1;
+    stdx::condition_variable cv2;
+    size_t count1 = 0U;
+    bool flag2 = false;
+
+private:
+    void tearDown() override {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        flag2 = true;
+        cv2.notify_all();
+        lk.unlock();
+    }
+
+    boost::optional<AdaptiveThreadPool> _pool;
+};
+
+TEST_F(AdaptiveThreadPoolTest, GrowsWhenTasksBlockAndShrinksWhenIdle) {
+    AdaptiveThreadPool::Options options;
+    options.minThreads = 2;
+    options.maxThreads = 8;
+    options.targetQueueLatency = Milliseconds(1);
+    options.controllerInterval = Milliseconds(5);
+    options.maxIdleThreadAge = Milliseconds(100);
+    // Blocked tasks do not use any CPU, so saturation must never stop the pool from growing.
+    options.cpuSaturationThreshold = 2.0;
+    auto& pool = makePool(options);
+    pool.startup();
+    ASSERT_EQ(2U, pool.getStats().numThreads);
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    for (size_t i = 0U; i < 12U; ++i) {
+        ASSERT_OK(pool.schedule([this] { blockingWork(); })) << i;
+    }
+
+    // The controller adds threads one interval at a time until it reaches maxThreads.
+    while (count1 < 8U) {
+        cv1.wait(lk);
+    }
+    auto stats = pool.getStats();
+    ASSERT_EQ(8U, stats.numThreads);
+    ASSERT_EQ(0U, stats.numIdleThreads);
+    ASSERT_EQ(4U, stats.numPendingTasks);
+    ASSERT_EQ(8U, stats.totalThreadsStarted);
+
+    flag2 = true;
+    cv2.notify_all();
+    while (count1 < 12U) {
+        cv1.wait(lk);
+    }
+    lk.unlock();
+
+    Timer reapTimer;
+    for (size_t i = 0; i < 100 && (stats = pool.getStats()).numThreads > options.minThreads; ++i) {
+        sleepmillis(50);
+    }
+    const Microseconds reapTime(reapTimer.micros());
+    ASSERT_EQ(options.minThreads, stats.numThreads)
+        << "Failed to reap excess threads after " << durationCount<Milliseconds>(reapTime) << "ms";
+    ASSERT_EQ(6U, stats.totalThreadsRetired);
+    ASSERT_EQ(12U, stats.totalTasksExecuted);
+}
+
+TEST_F(AdaptiveThreadPoolTest, DoesNotGrowWhileQueueLatencyIsBelowTarget) {
+    AdaptiveThreadPool::Options options;
+    options.minThreads = 1;
+    options.maxThreads = 4;
+    options.targetQueueLatency = Seconds(60);
+    options.controllerInterval = Milliseconds(5);
+    options.cpuSaturationThreshold = 2.0;
+    auto& pool = makePool(options);
+    pool.startup();
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(pool.schedule([this] { blockingWork(); }));
+    ASSERT_OK(pool.schedule([this] { blockingWork(); }));
+    while (count1 < 1U) {
+        cv1.wait(lk);
+    }
+    lk.unlock();
+
+    sleepmillis(100);
+    auto stats = pool.getStats();
+    ASSERT_EQ(1U, stats.numThreads);
+    ASSERT_EQ(1U, stats.numPendingTasks);
+}
+
+TEST_F(AdaptiveThreadPoolTest, DoesNotGrowWhileCpuIsSaturated) {
+    AdaptiveThreadPool::Options options;
+    options.minThreads = stdx::thread::hardware_concurrency();
+    options.maxThreads = options.minThreads + 4;
+    options.targetQueueLatency = Milliseconds(1);
+    options.controllerInterval = Milliseconds(5);
+    // Any utilization at all counts as saturated.
+    options.cpuSaturationThreshold = 0.0;
+    auto& pool = makePool(options);
+    pool.startup();
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    for (size_t i = 0U; i < options.minThreads + 1; ++i) {
+        ASSERT_OK(pool.schedule([this] { blockingWork(); })) << i;
+    }
+    while (count1 < options.minThreads) {
+        cv1.wait(lk);
+    }
+    lk.unlock();
+
+    sleepmillis(100);
+    auto stats = pool.getStats();
+    ASSERT_EQ(options.minThreads, stats.numThreads);
+    ASSERT_EQ(1U, stats.numPendingTasks);
+    ASSERT_GT(stats.totalCpuSaturatedIntervals, 0U);
+}
+
+DEATH_TEST(AdaptiveThreadPoolTest, MinThreadsTooFewDies, "but the minimum must be at least 1") {
+    AdaptiveThreadPool::Options options;
+    options.minThreads = 0;
+    AdaptiveThreadPool pool(options);
+}
+
+DEATH_TEST(AdaptiveThreadPoolTest,
+           MinThreadsTooManyDies,
+           "6 which is more than the configured maximum of 5") {
+    AdaptiveThreadPool::Options options;
+    options.maxThreads = 5;
+    options.minThreads = 6;
+    AdaptiveThreadPool pool(options);
+}
+
+}  // namespace
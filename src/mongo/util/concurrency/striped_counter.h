@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+/**
+ * A 64-bit counter for values which many threads add to often but which are read rarely, such as
+ * the number of records in a collection. Each thread adds to one of several stripes, each on its
+ * own cache line, so that concurrent writers do not contend on a single atomic. Reads sum all of
+ * the stripes and are correspondingly more expensive.
+ *
+ * Reads are not a snapshot: a read concurrent with adds may see some of them and not others.
+ */
+class StripedCounter {
+    MONGO_DISALLOW_COPYING(StripedCounter);
+
+public:
+    enum { kNumStripes = 8 };
+
+    StripedCounter() = default;
+
+    void add(int64_t delta) {
+        _stripes[_stripeForThisThread()].value.fetchAndAdd(delta);
+    }
+
+    /**
+     * Returns the sum of the stripes.
+     */
+    int64_t load() const;
+
+    /**
+     * Replaces the value of the counter. Adds made concurrently with a store may be lost.
+     */
+    void store(int64_t value);
+
+private:
+    // Twice the size of a cache line on all supported platforms. Counters are usually heap
+    // allocated, which does not guarantee cache line alignment, so padding each stripe to two
+    // lines keeps the values of any two stripes on different lines wherever the array starts.
+    static const size_t kStripeBytes = 128;
+
+    struct Stripe {
+        AtomicInt64 value;
+        char padding[kStripeBytes - sizeof(AtomicInt64)];
+    };
+
+    static size_t _stripeForThisThread();
+
+    Stripe _stripes[kNumStripes];
+};
+
+}  // namespace mongo
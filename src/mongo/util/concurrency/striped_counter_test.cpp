@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/striped_counter.h"
+
+namespace mongo {
+namespace {
+
+TEST(StripedCounterTest, StartsAtZero) {
+    StripedCounter counter;
+    ASSERT_EQ(0, counter.load());
+}
+
+TEST(StripedCounterTest, AddAndStore) {
+    StripedCounter counter;
+    counter.add(5);
+    counter.add(-7);
+    ASSERT_EQ(-2, counter.load());
+
+    counter.store(42);
+    ASSERT_EQ(42, counter.load());
+    counter.add(1);
+    ASSERT_EQ(43, counter.load());
+}
+
+TEST(StripedCounterTest, SumsAddsFromManyThreads) {
+    const int kThreads = 2 * StripedCounter::kNumStripes + 1;
+    const int kAddsPerThread = 10000;
+
+    StripedCounter counter;
+    counter.store(100);
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&counter, i] {
+            for (int j = 0; j < kAddsPerThread; j++) {
+                counter.add(i % 2 == 0 ? 2 : -1);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    const int64_t adders = (kThreads + 1) / 2;
+    const int64_t subtracters = kThreads / 2;
+    ASSERT_EQ(100 + (2 * adders - subtracters) * kAddsPerThread, counter.load());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -25,178 +25,183 @@
  *    then also delete it in the license file.
  */
 
-#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
-
 #include "mongo/platform/basic.h"
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <limits>
 
-#include "mongo/util/log.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
-#if defined(__linux__)
 namespace {
-void _check(int ret) {
-    if (ret == 0)
-        return;
-    int err = errno;
-    severe() << "error in Ticketholder: " << errnoWithDescription(err);
-    fassertFailed(28604);
-}
+
+// The bounds of the sem_t based implementation, which the ticket server parameters and
+// --maxConns were validated against.
+const int kMinTickets = 5;
+#if defined(SEM_VALUE_MAX)
+const int kMaxTickets = SEM_VALUE_MAX;
+#else
+const int kMaxTickets = std::numeric_limits<int>::max();
+#endif
+
+size_t idx(TicketPriority priority) {
+    return static_cast<size_t>(priority);
 }
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
-    _check(sem_init(&_sem, 0, num));
+}  // namespace
+
+StringData toString(TicketPriority priority) {
+    switch (priority) {
+        case TicketPriority::kHigh:
+            return "high";
+        case TicketPriority::kNormal:
+            return "normal";
+        case TicketPriority::kLow:
+            return "low";
+    }
+    MONGO_UNREACHABLE;
 }
 
+TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
+
 TicketHolder::~TicketHolder() {
-    _check(sem_destroy(&_sem));
+    invariant(_numWaiters.load() == 0);
 }
 
-bool TicketHolder::tryAcquire() {
-    while (0 != sem_trywait(&_sem)) {
-        switch (errno) {
-            case EAGAIN:
-                return false;
-            case EINTR:
-                break;
-            default:
-                _check(-1);
-        }
-    }
+bool TicketHolder::tryAcquire(TicketPriority priority) {
+    if (_numWaiters.load() > 0 || !_takeTicket())
+        return false;
+
+    _stats[idx(priority)].admitted.fetchAndAdd(1);
     return true;
 }
 
-void TicketHolder::waitForTicket() {
-    while (0 != sem_wait(&_sem)) {
-        switch (errno) {
-            case EINTR:
-                break;
-            default:
-                _check(-1);
-        }
+void TicketHolder::waitForTicket(TicketPriority priority) {
+    auto& stats = _stats[idx(priority)];
+    if (_numWaiters.load() == 0 && _takeTicket()) {
+        stats.admitted.fetchAndAdd(1);
+        return;
     }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    // The releasing thread hands the ticket over directly and removes us from the queue, so
+    // 'waiter' only has to outlive the wait below.
+    Waiter waiter;
+    _queues[idx(priority)].push_back(&waiter);
+    _numWaiters.fetchAndAdd(1);
+    stats.queued.fetchAndAdd(1);
+
+    // A ticket released before '_numWaiters' was raised did not look for waiters, so claim it
+    // here. This grants the queues in order and may well serve someone ahead of us.
+    _grantWaiters_inlock();
+
+    const auto start = stdx::chrono::steady_clock::now();
+    waiter.cv.wait(lk, [&waiter] { return waiter.granted; });
+    const auto waited = stdx::chrono::steady_clock::now() - start;
+
+    stats.queued.fetchAndAdd(-1);
+    stats.admitted.fetchAndAdd(1);
+    stats.admittedAfterWait.fetchAndAdd(1);
+    stats.totalWaitMicros.fetchAndAdd(
+        stdx::chrono::duration_cast<stdx::chrono::microseconds>(waited).count());
 }
 
 void TicketHolder::release() {
-    _check(sem_post(&_sem));
+    _num.fetchAndAdd(1);
+    if (_numWaiters.load() == 0)
+        return;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _grantWaiters_inlock();
 }
 
 Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<stdx::mutex> lk(_resizeMutex);
-
-    if (newSize < 5)
+    if (newSize < kMinTickets) {
         return Status(ErrorCodes::BadValue,
-                      str::stream() << "Minimum value for semaphore is 5; given " << newSize);
-
-    if (newSize > SEM_VALUE_MAX)
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Maximum value for semaphore is " << SEM_VALUE_MAX
+                      str::stream() << "Minimum value for semaphore is " << kMinTickets
                                     << "; given "
                                     << newSize);
-
-    while (_outof.load() < newSize) {
-        release();
-        _outof.fetchAndAdd(1);
     }
 
-    while (_outof.load() > newSize) {
-        waitForTicket();
-        _outof.subtractAndFetch(1);
+    if (newSize > kMaxTickets) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Maximum value for semaphore is " << kMaxTickets
+                                    << "; given "
+                                    << newSize);
     }
 
-    invariant(_outof.load() == newSize);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _num.fetchAndAdd(newSize - _outof.load());
+    _outof.store(newSize);
+    _grantWaiters_inlock();
     return Status::OK();
 }
 
 int TicketHolder::available() const {
-    int val = 0;
-    _check(sem_getvalue(&_sem, &val));
-    return val;
+    return std::max(_num.load(), 0);
 }
 
 int TicketHolder::used() const {
-    return outof() - available();
+    return _outof.load() - _num.load();
 }
 
 int TicketHolder::outof() const {
     return _outof.load();
 }
 
-#else
-
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
-
-TicketHolder::~TicketHolder() = default;
-
-bool TicketHolder::tryAcquire() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    return _tryAcquire();
-}
-
-void TicketHolder::waitForTicket() {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    while (!_tryAcquire()) {
-        _newTicket.wait(lk);
+TicketHolder::PriorityStats TicketHolder::getStats(TicketPriority priority) const {
+    const auto& stats = _stats[idx(priority)];
+    PriorityStats out;
+    out.queued = stats.queued.load();
+    out.admitted = stats.admitted.load();
+    out.admittedAfterWait = stats.admittedAfterWait.load();
+    out.totalWaitMicros = stats.totalWaitMicros.load();
+    return out;
+}
+
+void TicketHolder::appendPriorityStats(BSONObjBuilder* builder) const {
+    for (auto priority : {TicketPriority::kHigh, TicketPriority::kNormal, TicketPriority::kLow}) {
+        const auto stats = getStats(priority);
+        BSONObjBuilder sub(builder->subobjStart(toString(priority)));
+        sub.appendNumber("queued", stats.queued);
+        sub.appendNumber("admitted", stats.admitted);
+        sub.appendNumber("admittedAfterWait", stats.admittedAfterWait);
+        sub.appendNumber("totalWaitMicros", stats.totalWaitMicros);
     }
 }
 
-void TicketHolder::release() {
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _num++;
+bool TicketHolder::_takeTicket() {
+    int num = _num.load();
+    while (num > 0) {
+        const int previous = _num.compareAndSwap(num, num - 1);
+        if (previous == num)
+            return true;
+        num = previous;
     }
-    _newTicket.notify_one();
+    return false;
 }
 
-Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+void TicketHolder::_grantWaiters_inlock() {
+    for (auto& queue : _queues) {
+        while (!queue.empty() && _takeTicket()) {
+            Waiter* waiter = queue.front();
+            queue.pop_front();
+            _numWaiters.fetchAndAdd(-1);
+            waiter->granted = true;
 
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        log() << errmsg;
-        return Status(ErrorCodes::BadValue, errmsg);
-    }
-
-    _outof.store(newSize);
-    _num = _outof.load() - used;
-
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
-    return Status::OK();
-}
-
-int TicketHolder::available() const {
-    return _num;
-}
-
-int TicketHolder::used() const {
-    return outof() - _num;
-}
-
-int TicketHolder::outof() const {
-    return _outof.load();
-}
-
-bool TicketHolder::_tryAcquire() {
-    if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
+            // Notify while still holding the mutex: once it is dropped the woken thread may
+            // return and destroy 'waiter'.
+            waiter->cv.notify_one();
         }
-        return false;
     }
-    _num--;
-    return true;
-}
-#endif
 }
+
+}  // namespace mongo
@@ -26,30 +26,76 @@
  */
 #pragma once
 
-#if defined(__linux__)
-#include <semaphore.h>
-#endif
+#include <array>
+#include <deque>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * Admission classes for TicketHolder. When tickets are scarce, a released ticket always goes to
+ * the longest-waiting request of the highest non-empty class; requests of the same class are
+ * admitted strictly in arrival order.
+ */
+enum class TicketPriority {
+    kHigh,    // Cluster-internal work: replication, heartbeat-driven and intra-cluster traffic.
+    kNormal,  // Regular client operations.
+    kLow,     // Bulk or background work that should yield to everything else.
+};
+
+const int kNumTicketPriorities = 3;
+
+StringData toString(TicketPriority priority);
+
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
 public:
+    /**
+     * Admission statistics for a single priority class.
+     */
+    struct PriorityStats {
+        // Requests currently waiting for a ticket.
+        long long queued = 0;
+
+        // Tickets handed out to this class, and how many of those had to queue first.
+        long long admitted = 0;
+        long long admittedAfterWait = 0;
+
+        // Time spent queued, summed over all requests which had to wait.
+        long long totalWaitMicros = 0;
+    };
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
-    bool tryAcquire();
+    /**
+     * Takes a ticket only if one is free and nobody is queued for it, so that callers which do
+     * not wait can never overtake callers which do. 'priority' only selects the statistics the
+     * admission is counted under.
+     */
+    bool tryAcquire(TicketPriority priority = TicketPriority::kNormal);
 
-    void waitForTicket();
+    /**
+     * Blocks until a ticket is handed to this caller.
+     */
+    void waitForTicket(TicketPriority priority = TicketPriority::kNormal);
 
     void release();
 
+    /**
+     * Changes the number of tickets, which must be between 5 and SEM_VALUE_MAX. Shrinking below
+     * the number currently in use is allowed: no new tickets are handed out until enough have
+     * been released to fit the new size.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -58,21 +104,53 @@ public:
 
     int outof() const;
 
+    PriorityStats getStats(TicketPriority priority) const;
+
+    /**
+     * Appends one sub-document per priority class with the statistics from getStats().
+     */
+    void appendPriorityStats(BSONObjBuilder* builder) const;
+
 private:
-#if defined(__linux__)
-    mutable sem_t _sem;
-
-    // You can read _outof without a lock, but have to hold _resizeMutex to change.
-    AtomicInt32 _outof;
-    stdx::mutex _resizeMutex;
-#else
-    bool _tryAcquire();
-
-    AtomicInt32 _outof;
-    int _num;
-    stdx::mutex _mutex;
-    stdx::condition_variable _newTicket;
-#endif
+    struct Waiter {
+        stdx::condition_variable cv;
+        bool granted = false;
+    };
+
+    struct AtomicPriorityStats {
+        AtomicInt64 queued;
+        AtomicInt64 admitted;
+        AtomicInt64 admittedAfterWait;
+        AtomicInt64 totalWaitMicros;
+    };
+
+    /**
+     * Takes a free ticket, if any, without regard for queued waiters.
+     */
+    bool _takeTicket();
+
+    /**
+     * Hands free tickets to queued waiters, highest class first and FIFO within a class.
+     */
+    void _grantWaiters_inlock();
+
+    // Tickets are taken and returned with atomic operations while nobody is queued. '_mutex'
+    // is only taken to queue for a ticket, to hand one over to a queued waiter, and to resize.
+    //
+    // A waiter raises '_numWaiters' before it looks at '_num' one last time, and a releaser
+    // raises '_num' before it looks at '_numWaiters', so one of them always sees the other.
+    mutable stdx::mutex _mutex;
+
+    AtomicWord<int> _outof;
+
+    // Free tickets. Goes negative after a resize below the number of tickets in use.
+    AtomicWord<int> _num;
+
+    // Waiters in '_queues' which have not been handed a ticket yet.
+    AtomicWord<int> _numWaiters{0};
+
+    std::array<std::deque<Waiter*>, kNumTicketPriorities> _queues;
+    std::array<AtomicPriorityStats, kNumTicketPriorities> _stats;
 };
 
 class ScopedTicket {
@@ -0,0 +1,237 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Records the order in which threads were admitted by a TicketHolder. Each waiter gives its
+ * ticket back as soon as it has recorded itself.
+ */
+class AdmissionOrder {
+public:
+    explicit AdmissionOrder(TicketHolder* holder) : _holder(holder) {}
+
+    ~AdmissionOrder() {
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Starts a thread waiting for a ticket with 'priority' and returns once it is queued.
+     */
+    void enqueue(int id, TicketPriority priority) {
+        const auto queuedBefore = _holder->getStats(priority).queued;
+        _threads.emplace_back([this, id, priority] {
+            _holder->waitForTicket(priority);
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _order.push_back(id);
+            }
+            _holder->release();
+        });
+        while (_holder->getStats(priority).queued == queuedBefore) {
+            sleepmillis(1);
+        }
+    }
+
+    std::vector<int> join() {
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+        _threads.clear();
+        return _order;
+    }
+
+private:
+    TicketHolder* const _holder;
+    std::vector<stdx::thread> _threads;
+    stdx::mutex _mutex;
+    std::vector<int> _order;
+};
+
+TEST(TicketHolderTest, BasicAcquireAndRelease) {
+    TicketHolder holder(2);
+    ASSERT_EQ(2, holder.available());
+
+    ASSERT_TRUE(holder.tryAcquire());
+    holder.waitForTicket();
+    ASSERT_EQ(0, holder.available());
+    ASSERT_EQ(2, holder.used());
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    holder.release();
+    ASSERT_EQ(2, holder.available());
+    ASSERT_EQ(0, holder.used());
+}
+
+TEST(TicketHolderTest, ResizeBelowUsedDrainsOnRelease) {
+    TicketHolder holder(7);
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_TRUE(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(5, holder.outof());
+    ASSERT_EQ(0, holder.available());
+    ASSERT_EQ(7, holder.used());
+
+    holder.release();
+    holder.release();
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    ASSERT_EQ(1, holder.available());
+}
+
+TEST(TicketHolderTest, ResizeBounds) {
+    TicketHolder holder(5);
+    ASSERT_NOT_OK(holder.resize(0));
+    ASSERT_NOT_OK(holder.resize(4));
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(5, holder.outof());
+}
+
+TEST(TicketHolderTest, TryAcquireCountsUnderGivenPriority) {
+    TicketHolder holder(5);
+    ASSERT_TRUE(holder.tryAcquire(TicketPriority::kHigh));
+    ASSERT_TRUE(holder.tryAcquire());
+
+    ASSERT_EQ(1, holder.getStats(TicketPriority::kHigh).admitted);
+    ASSERT_EQ(1, holder.getStats(TicketPriority::kNormal).admitted);
+    ASSERT_EQ(0, holder.getStats(TicketPriority::kLow).admitted);
+}
+
+TEST(TicketHolderTest, HigherPriorityAdmittedFirst) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    AdmissionOrder order(&holder);
+    order.enqueue(0, TicketPriority::kLow);
+    order.enqueue(1, TicketPriority::kNormal);
+    order.enqueue(2, TicketPriority::kHigh);
+
+    holder.release();
+    ASSERT(order.join() == std::vector<int>({2, 1, 0}));
+}
+
+TEST(TicketHolderTest, FifoWithinPriority) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    AdmissionOrder order(&holder);
+    for (int id = 0; id < 5; ++id) {
+        order.enqueue(id, TicketPriority::kNormal);
+    }
+
+    holder.release();
+    ASSERT(order.join() == std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(TicketHolderTest, TryAcquireDoesNotOvertakeWaiters) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    AtomicWord<bool> served(false);
+    AtomicWord<bool> done(false);
+    stdx::thread waiter([&] {
+        holder.waitForTicket(TicketPriority::kLow);
+        served.store(true);
+        while (!done.load()) {
+            sleepmillis(1);
+        }
+        holder.release();
+    });
+    while (holder.getStats(TicketPriority::kLow).queued == 0) {
+        sleepmillis(1);
+    }
+
+    // The freed ticket belongs to the queued waiter, even before it has woken up to take it.
+    holder.release();
+    while (!served.load()) {
+        ASSERT_FALSE(holder.tryAcquire());
+    }
+    ASSERT_FALSE(holder.tryAcquire());
+
+    done.store(true);
+    waiter.join();
+    ASSERT_TRUE(holder.tryAcquire());
+}
+
+TEST(TicketHolderTest, GrowingHandsNewTicketsToWaiters) {
+    TicketHolder holder(5);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(holder.tryAcquire());
+    }
+
+    AdmissionOrder order(&holder);
+    order.enqueue(0, TicketPriority::kLow);
+
+    // Growing the pool hands the new ticket straight to the queued waiter, which gives it back.
+    ASSERT_OK(holder.resize(6));
+    order.join();
+    ASSERT_TRUE(holder.tryAcquire());
+    ASSERT_FALSE(holder.tryAcquire());
+}
+
+TEST(TicketHolderTest, WaitStatsPerPriority) {
+    TicketHolder holder(1);
+    holder.waitForTicket(TicketPriority::kHigh);
+
+    AdmissionOrder order(&holder);
+    order.enqueue(0, TicketPriority::kLow);
+    sleepmillis(10);
+    holder.release();
+    order.join();
+
+    auto high = holder.getStats(TicketPriority::kHigh);
+    ASSERT_EQ(1, high.admitted);
+    ASSERT_EQ(0, high.admittedAfterWait);
+
+    auto low = holder.getStats(TicketPriority::kLow);
+    ASSERT_EQ(0, low.queued);
+    ASSERT_EQ(1, low.admitted);
+    ASSERT_EQ(1, low.admittedAfterWait);
+    ASSERT_GTE(low.totalWaitMicros, 10 * 1000);
+}
+
+}  // namespace
+}  // namespace mongo
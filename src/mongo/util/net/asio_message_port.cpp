@@ -301,6 +301,13 @@ asio::error_code ASIOMessagingPort::_handshake(bool isServer, const char* buf, s
             durationCount<Duration<decltype(_timer)::duration::period>>(*_timeout)));
     }
 
+    auto sslManager = getSSLManager();
+    std::string peer;
+    if (!isServer) {
+        peer = remoteAddr().toString();
+        sslManager->restoreClientSession(_sslSock.native_handle(), peer);
+    }
+
     asio::error_code ec = asio::error::would_block;
     if (buf) {
         _sslSock.async_handshake(handshakeType,
@@ -314,6 +321,16 @@ asio::error_code ASIOMessagingPort::_handshake(bool isServer, const char* buf, s
         _service.run_one();
     } while (ec == asio::error::would_block);
 
+    if (!ec) {
+        sslManager->recordHandshake(_sslSock.native_handle(),
+                                    isServer
+                                        ? SSLManagerInterface::ConnectionDirection::kIncoming
+                                        : SSLManagerInterface::ConnectionDirection::kOutgoing);
+        if (!isServer) {
+            sslManager->saveClientSession(_sslSock.native_handle(), peer);
+        }
+    }
+
     return ec;
 #else
     return asio::error::operation_not_supported;
@@ -338,7 +355,7 @@ bool ASIOMessagingPort::recv(Message& m) {
         if (getGlobalFailPointRegistry()->getFailPoint("throwSockExcep")->shouldFail()) {
             throw SocketException(SocketException::RECV_ERROR, "fail point set");
         }
-        SharedBuffer buf = SharedBuffer::allocate(kInitialMessageSize);
+        SharedBuffer buf = SharedBuffer::allocatePooled(kInitialMessageSize);
         MsgData::View md = buf.get();
 
         asio::error_code ec = _read(md.view2ptr(), kHeaderLen);
@@ -467,6 +484,15 @@ void ASIOMessagingPort::say(Message& toSend, int responseTo) {
 
 void ASIOMessagingPort::say(const Message& toSend) {
     invariant(!toSend.empty());
+    if (!toSend.isContiguous()) {
+        std::vector<std::pair<char*, int>> data;
+        toSend.forEachRange([&data](const char* ptr, size_t size) {
+            data.emplace_back(const_cast<char*>(ptr), static_cast<int>(size));
+        });
+        send(data, nullptr);
+        return;
+    }
+
     auto buf = toSend.buf();
     if (buf) {
         send(buf, MsgData::ConstView(buf).getLen(), nullptr);
@@ -36,10 +36,14 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/config.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/asio_message_port.h"
@@ -81,6 +85,26 @@ namespace mongo {
 
 namespace {
 const auto getListener = ServiceContext::declareDecoration<Listener*>();
+
+// Number of sockets, each with its own accept thread, to open per listening address. Values above
+// 1 bind the sockets with SO_REUSEPORT so that the kernel spreads incoming connections over them.
+// Only listeners that can handle concurrent accepts (the main server port) honor this.
+int listenerAcceptThreads = 1;
+
+class ExportedListenerAcceptThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedListenerAcceptThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), "listenerAcceptThreads", &listenerAcceptThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue, "listenerAcceptThreads must be at least 1");
+        }
+        return Status::OK();
+    }
+} exportedListenerAcceptThreadsParam;
 }  // namespace
 
 using std::shared_ptr;
@@ -164,6 +188,16 @@ Listener::~Listener() {
 bool Listener::setupSockets() {
     checkTicketNumbers();
 
+    _acceptThreads = 1;
+    if (supportsConcurrentAccept() && listenerAcceptThreads > 1) {
+#ifdef SO_REUSEPORT
+        _acceptThreads = listenerAcceptThreads;
+#else
+        warning() << "listenerAcceptThreads requires SO_REUSEPORT, which is not available on "
+                     "this platform; using a single accept thread";
+#endif
+    }
+
 #if !defined(_WIN32)
     _mine = ipToAddrs(_ip.c_str(), _port, (!serverGlobalParams.noUnixSocket && useUnixSockets()));
 #else
@@ -179,59 +213,75 @@ bool Listener::setupSockets() {
             return _setupSocketsSuccessful;
         }
 
-        SOCKET sock = ::socket(me.getType(), SOCK_STREAM, 0);
-        ScopeGuard socketGuard = MakeGuard(&closesocket, sock);
-        massert(15863,
-                str::stream() << "listen(): invalid socket? " << errnoWithDescription(),
-                sock >= 0);
+        const size_t socketsForAddr = me.getType() == AF_UNIX ? 1 : _acceptThreads;
+        for (size_t acceptThread = 0; acceptThread < socketsForAddr; ++acceptThread) {
+            SOCKET sock = ::socket(me.getType(), SOCK_STREAM, 0);
+            ScopeGuard socketGuard = MakeGuard(&closesocket, sock);
+            massert(15863,
+                    str::stream() << "listen(): invalid socket? " << errnoWithDescription(),
+                    sock >= 0);
 
-        if (me.getType() == AF_UNIX) {
+            if (me.getType() == AF_UNIX) {
 #if !defined(_WIN32)
-            if (unlink(me.getAddr().c_str()) == -1) {
-                if (errno != ENOENT) {
-                    error() << "Failed to unlink socket file " << me << " "
-                            << errnoWithDescription(errno);
-                    fassertFailedNoTrace(28578);
+                if (unlink(me.getAddr().c_str()) == -1) {
+                    if (errno != ENOENT) {
+                        error() << "Failed to unlink socket file " << me << " "
+                                << errnoWithDescription(errno);
+                        fassertFailedNoTrace(28578);
+                    }
                 }
-            }
 #endif
-        } else if (me.getType() == AF_INET6) {
-            // IPv6 can also accept IPv4 connections as mapped addresses (::ffff:127.0.0.1)
-            // That causes a conflict if we don't do set it to IPV6_ONLY
-            const int one = 1;
-            setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&one, sizeof(one));
-        }
+            } else if (me.getType() == AF_INET6) {
+                // IPv6 can also accept IPv4 connections as mapped addresses (::ffff:127.0.0.1)
+                // That causes a conflict if we don't do set it to IPV6_ONLY
+                const int one = 1;
+                setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&one, sizeof(one));
+            }
 
 #if !defined(_WIN32)
-        {
-            const int one = 1;
-            if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0)
-                log() << "Failed to set socket opt, SO_REUSEADDR";
-        }
+            {
+                const int one = 1;
+                if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0)
+                    log() << "Failed to set socket opt, SO_REUSEADDR";
+            }
 #endif
 
-        if (::bind(sock, me.raw(), me.addressSize) != 0) {
-            int x = errno;
-            error() << "listen(): bind() failed " << errnoWithDescription(x)
-                    << " for socket: " << me.toString();
-            if (x == EADDRINUSE)
-                error() << "  addr already in use";
-            return _setupSocketsSuccessful;
-        }
+#ifdef SO_REUSEPORT
+            if (socketsForAddr > 1) {
+                const int one = 1;
+                if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+                    error() << "listen(): failed to set SO_REUSEPORT for socket: " << me.toString()
+                            << " " << errnoWithDescription();
+                    return _setupSocketsSuccessful;
+                }
+            }
+#endif
+
+            if (::bind(sock, me.raw(), me.addressSize) != 0) {
+                int x = errno;
+                error() << "listen(): bind() failed " << errnoWithDescription(x)
+                        << " for socket: " << me.toString();
+                if (x == EADDRINUSE)
+                    error() << "  addr already in use";
+                return _setupSocketsSuccessful;
+            }
 
 #if !defined(_WIN32)
-        if (me.getType() == AF_UNIX) {
-            if (chmod(me.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
-                error() << "Failed to chmod socket file " << me << " "
-                        << errnoWithDescription(errno);
-                fassertFailedNoTrace(28582);
+            if (me.getType() == AF_UNIX) {
+                if (chmod(me.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
+                    error() << "Failed to chmod socket file " << me << " "
+                            << errnoWithDescription(errno);
+                    fassertFailedNoTrace(28582);
+                }
+                ListeningSockets::get()->addPath(me.getAddr());
             }
-            ListeningSockets::get()->addPath(me.getAddr());
-        }
 #endif
 
-        _socks.push_back(sock);
-        socketGuard.Dismiss();
+            _socks.push_back(sock);
+            _socketAcceptThread.push_back(acceptThread);
+            _socketIsTcp.push_back(me.getType() != AF_UNIX);
+            socketGuard.Dismiss();
+        }
     }
 
     _setupSocketsSuccessful = true;
@@ -245,7 +295,6 @@ void Listener::initAndListen() {
         return;
     }
 
-    SOCKET maxfd = 0;  // needed for select()
     for (unsigned i = 0; i < _socks.size(); i++) {
         if (::listen(_socks[i], SOMAXCONN) != 0) {
             error() << "listen(): listen() failed " << errnoWithDescription();
@@ -253,16 +302,6 @@ void Listener::initAndListen() {
         }
 
         ListeningSockets::get()->add(_socks[i]);
-
-        if (_socks[i] > maxfd) {
-            maxfd = _socks[i];
-        }
-    }
-
-    if (maxfd >= FD_SETSIZE) {
-        error() << "socket " << maxfd << " is higher than " << FD_SETSIZE - 1 << "; not supported"
-                << warnings;
-        return;
     }
 
 #ifdef MONGO_CONFIG_SSL
@@ -271,6 +310,11 @@ void Listener::initAndListen() {
     _logListen(_port, false);
 #endif
 
+    if (_acceptThreads > 1) {
+        log() << "accepting connections on " << _acceptThreads
+              << " SO_REUSEPORT sockets per address";
+    }
+
     {
         // Wake up any threads blocked in waitUntilListening()
         stdx::lock_guard<stdx::mutex> lock(_readyMutex);
@@ -278,6 +322,42 @@ void Listener::initAndListen() {
         _readyCondition.notify_all();
     }
 
+    // Each accept thread selects over its own socket for every address. The calling thread
+    // serves the first group.
+    std::vector<std::vector<SOCKET>> socketGroups(_acceptThreads);
+    for (unsigned i = 0; i < _socks.size(); i++) {
+        socketGroups[_socketAcceptThread[i]].push_back(_socks[i]);
+    }
+
+    std::vector<stdx::thread> acceptThreads;
+    for (size_t i = 1; i < socketGroups.size(); ++i) {
+        acceptThreads.emplace_back([this, &socketGroups, i] {
+            setThreadName(str::stream() << "listener" << i);
+            _acceptLoop(socketGroups[i]);
+        });
+    }
+
+    _acceptLoop(socketGroups[0]);
+
+    for (auto&& thread : acceptThreads) {
+        thread.join();
+    }
+}
+
+void Listener::_acceptLoop(const std::vector<SOCKET>& socks) {
+    SOCKET maxfd = 0;  // needed for select()
+    for (auto sock : socks) {
+        if (sock > maxfd) {
+            maxfd = sock;
+        }
+    }
+
+    if (maxfd >= FD_SETSIZE) {
+        error() << "socket " << maxfd << " is higher than " << FD_SETSIZE - 1 << "; not supported"
+                << warnings;
+        return;
+    }
+
     struct timeval maxSelectTime;
     // The check against _finished allows us to actually stop the listener by signalling it through
     // the _finished flag.
@@ -285,7 +365,8 @@ void Listener::initAndListen() {
         fd_set fds[1];
         FD_ZERO(fds);
 
-        for (vector<SOCKET>::iterator it = _socks.begin(), end = _socks.end(); it != end; ++it) {
+        for (vector<SOCKET>::const_iterator it = socks.begin(), end = socks.end(); it != end;
+             ++it) {
             FD_SET(*it, fds);
         }
 
@@ -308,7 +389,8 @@ void Listener::initAndListen() {
             return;
         }
 
-        for (vector<SOCKET>::iterator it = _socks.begin(), end = _socks.end(); it != end; ++it) {
+        for (vector<SOCKET>::const_iterator it = socks.begin(), end = socks.end(); it != end;
+             ++it) {
             if (!(FD_ISSET(*it, fds)))
                 continue;
             SockAddr from;
@@ -326,6 +408,7 @@ void Listener::initAndListen() {
                     return;  // socket closed
                 }
                 if (!inShutdown()) {
+                    _acceptErrors.addAndFetch(1);
                     log() << "Listener: accept() returns " << s << " " << errnoWithDescription(x);
                     if (x == EMFILE || x == ENFILE) {
                         // Connection still in listen queue but we can't accept it yet
@@ -338,6 +421,7 @@ void Listener::initAndListen() {
                 continue;
             }
 
+            _noteAccepted();
             long long myConnectionNumber = globalConnectionNumber.addAndFetch(1);
 
             if (_logConnect && !serverGlobalParams.quiet) {
@@ -542,6 +626,7 @@ void Listener::initAndListen() {
                 return;  // socket closed
             }
             if (!inShutdown()) {
+                _acceptErrors.addAndFetch(1);
                 log() << "Listener: accept() returns " << s << " " << errnoWithDescription(x);
                 if (x == EMFILE || x == ENFILE) {
                     // Connection still in listen queue but we can't accept it yet
@@ -554,6 +639,7 @@ void Listener::initAndListen() {
             continue;
         }
 
+        _noteAccepted();
         long long myConnectionNumber = globalConnectionNumber.addAndFetch(1);
 
         if (_logConnect && !serverGlobalParams.quiet) {
@@ -582,6 +668,60 @@ void Listener::_logListen(int port, bool ssl) {
           << (ssl ? " ssl" : "");
 }
 
+void Listener::_noteAccepted() {
+    _totalAccepted.addAndFetch(1);
+
+    const long long now = curTimeMillis64() / 1000;
+    stdx::lock_guard<stdx::mutex> lk(_acceptRateMutex);
+    if (now != _acceptRateSecond) {
+        _acceptsLastSecond = (now == _acceptRateSecond + 1) ? _acceptsThisSecond : 0;
+        _acceptsThisSecond = 0;
+        _acceptRateSecond = now;
+    }
+    ++_acceptsThisSecond;
+}
+
+void Listener::appendStats(BSONObjBuilder* b) const {
+    BSONObjBuilder section(b->subobjStart("listener"));
+    section.append("acceptThreads", static_cast<int>(_acceptThreads));
+    section.append("listeningSockets", static_cast<int>(_socks.size()));
+    section.append("totalAccepted", _totalAccepted.load());
+    section.append("acceptErrors", _acceptErrors.load());
+
+    {
+        const long long now = curTimeMillis64() / 1000;
+        stdx::lock_guard<stdx::mutex> lk(_acceptRateMutex);
+        long long lastSecond = 0;
+        if (now == _acceptRateSecond) {
+            lastSecond = _acceptsLastSecond;
+        } else if (now == _acceptRateSecond + 1) {
+            lastSecond = _acceptsThisSecond;
+        }
+        section.append("acceptsLastSecond", lastSecond);
+    }
+
+#if defined(__linux__)
+    // For a listening TCP socket, Linux reports the current accept queue length in tcpi_unacked
+    // and the configured backlog in tcpi_sacked.
+    long long queueDepth = 0;
+    long long queueLimit = 0;
+    for (size_t i = 0; i < _socks.size(); ++i) {
+        if (!_socketIsTcp[i]) {
+            continue;
+        }
+        struct tcp_info info;
+        socklen_t len = sizeof(info);
+        if (getsockopt(_socks[i], IPPROTO_TCP, TCP_INFO, &info, &len) == 0) {
+            queueDepth += info.tcpi_unacked;
+            queueLimit += info.tcpi_sacked;
+        }
+    }
+    section.append("acceptQueueDepth", queueDepth);
+    section.append("acceptQueueLimit", queueLimit);
+#endif
+    section.doneFast();
+}
+
 void Listener::waitUntilListening() const {
     stdx::unique_lock<stdx::mutex> lock(_readyMutex);
     while (!_ready) {
@@ -45,6 +45,7 @@ namespace mongo {
 
 const int DEFAULT_MAX_CONN = 1000000;
 
+class BSONObjBuilder;
 class ServiceContext;
 
 class Listener {
@@ -85,9 +86,30 @@ public:
 
     void shutdown();
 
+    /**
+     * Appends accept thread, accept rate and accept queue statistics for this Listener's
+     * sockets.
+     */
+    void appendStats(BSONObjBuilder* b) const;
+
 private:
     std::vector<SockAddr> _mine;
     std::vector<SOCKET> _socks;
+
+    // Parallel to _socks: the accept thread that services each socket, and whether it is a TCP
+    // socket (as opposed to a unix domain socket).
+    std::vector<size_t> _socketAcceptThread;
+    std::vector<bool> _socketIsTcp;
+    size_t _acceptThreads = 1;
+
+    // Accept counters. The rate is the number of connections accepted during the last full
+    // second, kept under _acceptRateMutex.
+    AtomicInt64 _totalAccepted;
+    AtomicInt64 _acceptErrors;
+    mutable stdx::mutex _acceptRateMutex;
+    long long _acceptRateSecond = 0;
+    long long _acceptsThisSecond = 0;
+    long long _acceptsLastSecond = 0;
     std::string _name;
     std::string _ip;
     bool _setupSocketsSuccessful;
@@ -109,10 +131,28 @@ private:
 
     void _logListen(int port, bool ssl);
 
+#if !defined(_WIN32)
+    /**
+     * Runs the select/accept loop over 'socks' until shutdown.
+     */
+    void _acceptLoop(const std::vector<SOCKET>& socks);
+#endif
+
+    void _noteAccepted();
+
     virtual bool useUnixSockets() const {
         return false;
     }
 
+    /**
+     * Subclasses whose accepted() may be called from several threads at once return true, which
+     * lets the listenerAcceptThreads server parameter spread accepts over multiple
+     * SO_REUSEPORT sockets and threads.
+     */
+    virtual bool supportsConcurrentAccept() const {
+        return false;
+    }
+
 public:
     /** the "next" connection number.  every connection to this process has a unique number */
     static AtomicInt64 globalConnectionNumber;
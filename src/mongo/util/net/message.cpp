@@ -47,6 +47,34 @@ int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
 
+void Message::setData(SharedBuffer buf, std::vector<MessageSegment> segments) {
+    verify(empty());
+    _buf = std::move(buf);
+    _segments = std::move(segments);
+    _segmentBytes = 0;
+    for (auto&& segment : _segments) {
+        _segmentBytes += segment.size;
+    }
+    invariant(static_cast<size_t>(size()) >= _segmentBytes);
+}
+
+void Message::makeContiguous() {
+    if (isContiguous()) {
+        return;
+    }
+
+    auto buf = SharedBuffer::allocatePooled(size());
+    char* out = buf.get();
+    forEachRange([&out](const char* data, size_t size) {
+        memcpy(out, data, size);
+        out += size;
+    });
+
+    _buf = std::move(buf);
+    _segments.clear();
+    _segmentBytes = 0;
+}
+
 bool doesOpGetAResponse(int op) {
     return op == dbQuery || op == dbGetMore;
 }
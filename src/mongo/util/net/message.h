@@ -30,6 +30,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
@@ -42,6 +43,7 @@
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/net/sockaddr.h"
 #include "mongo/util/print.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -407,6 +409,20 @@ inline int ConstView::dataLen() const {
 }
 }  // namespace MsgData
 
+/**
+ * Bytes that live in another ref-counted buffer, typically an owned BSONObj, and are sent as part
+ * of a Message without being copied into the Message's own buffer. 'owner' keeps the bytes alive
+ * for as long as the Message references them.
+ */
+struct MessageSegment {
+    ConstSharedBuffer owner;
+    const char* data;
+    size_t size;
+
+    // Number of bytes of the Message's own buffer that are sent before this segment.
+    size_t offset;
+};
+
 class Message {
 public:
     Message() = default;
@@ -422,10 +438,45 @@ public:
     }
 
     MsgData::View singleData() const {
-        massert(13273, "single data buffer expected", _buf);
+        massert(13273, "single data buffer expected", _buf && isContiguous());
         return header();
     }
 
+    /**
+     * Returns false if some of this message's bytes are borrowed segments rather than part of
+     * its own buffer. Only the header may be read from a message that is not contiguous; use
+     * makeContiguous() before looking at the body.
+     */
+    bool isContiguous() const {
+        return _segments.empty();
+    }
+
+    /**
+     * Copies any borrowed segments into a new buffer holding the whole message.
+     */
+    void makeContiguous();
+
+    /**
+     * Calls 'callback(const char* data, size_t size)' for each piece of the message, in the order
+     * the pieces are to be sent. This is a single call for contiguous messages.
+     */
+    template <typename Callback>
+    void forEachRange(Callback&& callback) const {
+        const char* ownData = _buf.get();
+        const size_t ownSize = size() - _segmentBytes;
+        size_t sent = 0;
+        for (auto&& segment : _segments) {
+            if (segment.offset > sent) {
+                callback(ownData + sent, segment.offset - sent);
+                sent = segment.offset;
+            }
+            callback(segment.data, segment.size);
+        }
+        if (ownSize > sent) {
+            callback(ownData + sent, ownSize - sent);
+        }
+    }
+
     bool empty() const {
         return !_buf;
     }
@@ -443,6 +494,8 @@ public:
 
     void reset() {
         _buf = {};
+        _segments.clear();
+        _segmentBytes = 0;
     }
 
     // use to set first buffer if empty
@@ -450,13 +503,19 @@ public:
         verify(empty());
         _buf = std::move(buf);
     }
+
+    /**
+     * Like setData(SharedBuffer), but also splices 'segments' into the message. The segments must
+     * be ordered by offset, and the length in the header of 'buf' must already include them.
+     */
+    void setData(SharedBuffer buf, std::vector<MessageSegment> segments);
     void setData(int operation, const char* msgtxt) {
         setData(operation, msgtxt, strlen(msgtxt) + 1);
     }
     void setData(int operation, const char* msgdata, size_t len) {
         verify(empty());
         size_t dataLen = len + sizeof(MsgData::Value) - 4;
-        _buf = SharedBuffer::allocate(dataLen);
+        _buf = SharedBuffer::allocatePooled(dataLen);
         MsgData::View d = _buf.get();
         if (len)
             memcpy(d.data(), msgdata, len);
@@ -484,6 +543,9 @@ public:
 
 private:
     SharedBuffer _buf;
+
+    std::vector<MessageSegment> _segments;
+    size_t _segmentBytes = 0;
 };
 
 
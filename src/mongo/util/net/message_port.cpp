@@ -150,7 +150,7 @@ bool MessagingPort::recv(Message& m) {
         _psock->setHandshakeReceived();
         int z = (len + 1023) & 0xfffffc00;
         verify(z >= len);
-        auto buf = SharedBuffer::allocate(z);
+        auto buf = SharedBuffer::allocatePooled(z);
         MsgData::View md = buf.get();
         memcpy(md.view2ptr(), &header, headerLen);
         int left = len - headerLen;
@@ -201,6 +201,15 @@ void MessagingPort::say(Message& toSend, int responseTo) {
 
 void MessagingPort::say(const Message& toSend) {
     invariant(!toSend.empty());
+    if (!toSend.isContiguous()) {
+        std::vector<std::pair<char*, int>> data;
+        toSend.forEachRange([&data](const char* ptr, size_t size) {
+            data.emplace_back(const_cast<char*>(ptr), static_cast<int>(size));
+        });
+        send(data, "say");
+        return;
+    }
+
     auto buf = toSend.buf();
     if (buf) {
         send(buf, MsgData::ConstView(buf).getLen(), "say");
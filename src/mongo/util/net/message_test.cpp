@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message.h"
+
+#include <cstring>
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Builds a message whose own buffer holds the header followed by 'inline' bytes, and which
+// borrows 'borrowed' at 'offset' bytes into that buffer.
+Message buildSegmentedMessage(StringData own, StringData borrowed, size_t offset) {
+    const size_t ownSize = MsgData::MsgDataHeaderSize + own.size();
+    auto buf = SharedBuffer::allocate(ownSize);
+    MsgData::View view(buf.get());
+    view.setId(1);
+    view.setResponseToMsgId(0);
+    view.setOperation(opReply);
+    view.setLen(ownSize + borrowed.size());
+    memcpy(view.data(), own.rawData(), own.size());
+
+    auto owner = SharedBuffer::allocate(borrowed.size());
+    memcpy(owner.get(), borrowed.rawData(), borrowed.size());
+
+    MessageSegment segment;
+    segment.owner = owner;
+    segment.data = owner.get();
+    segment.size = borrowed.size();
+    segment.offset = MsgData::MsgDataHeaderSize + offset;
+
+    Message msg;
+    msg.setData(buf, {segment});
+    return msg;
+}
+
+std::string flatten(const Message& msg) {
+    std::string out;
+    msg.forEachRange([&out](const char* data, size_t size) { out.append(data, size); });
+    return out;
+}
+
+TEST(Message, ContiguousMessageIsOneRange) {
+    Message msg;
+    msg.setData(opReply, "hello", 5);
+    ASSERT_TRUE(msg.isContiguous());
+
+    int ranges = 0;
+    msg.forEachRange([&ranges](const char*, size_t) { ++ranges; });
+    ASSERT_EQ(ranges, 1);
+    ASSERT_EQ(flatten(msg).size(), static_cast<size_t>(msg.size()));
+}
+
+TEST(Message, SegmentsAreSplicedAtTheirOffsets) {
+    auto msg = buildSegmentedMessage("abcdef", "XYZ", 2);
+    ASSERT_FALSE(msg.isContiguous());
+    ASSERT_EQ(msg.size(), static_cast<int>(MsgData::MsgDataHeaderSize + 9));
+
+    auto bytes = flatten(msg);
+    ASSERT_EQ(bytes.size(), static_cast<size_t>(msg.size()));
+    ASSERT_EQ(bytes.substr(MsgData::MsgDataHeaderSize), "abXYZcdef");
+}
+
+TEST(Message, SegmentAtEnd) {
+    auto msg = buildSegmentedMessage("abc", "XYZ", 3);
+    ASSERT_EQ(flatten(msg).substr(MsgData::MsgDataHeaderSize), "abcXYZ");
+}
+
+TEST(Message, MakeContiguous) {
+    auto msg = buildSegmentedMessage("abcdef", "XYZ", 4);
+    ASSERT_THROWS(msg.singleData(), UserException);
+
+    msg.makeContiguous();
+    ASSERT_TRUE(msg.isContiguous());
+    ASSERT_EQ(msg.singleData().getId(), 1);
+    ASSERT_EQ(std::string(msg.singleData().data(), msg.singleData().dataLen()), "abcdXYZef");
+}
+
+TEST(Message, CopiesShareSegments) {
+    auto msg = buildSegmentedMessage("abcdef", "XYZ", 1);
+    Message copy(msg);
+    msg.reset();
+    ASSERT_TRUE(msg.empty());
+    ASSERT_EQ(flatten(copy).substr(MsgData::MsgDataHeaderSize), "aXYZbcdef");
+}
+
+}  // namespace
+}  // namespace mongo
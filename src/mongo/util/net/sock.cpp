@@ -36,6 +36,7 @@
 #if !defined(_WIN32)
 #include <arpa/inet.h>
 #include <errno.h>
+#include <limits.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -495,10 +496,13 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
             _bytesOut += j->second;
         }
     }
+    // sendmsg() rejects more than IOV_MAX entries, so long lists are sent in windows of at most
+    // that many.
+    size_t remaining = i;
     struct msghdr meta;
     memset(&meta, 0, sizeof(meta));
     meta.msg_iov = &d[0];
-    meta.msg_iovlen = d.size();
+    meta.msg_iovlen = std::min<size_t>(remaining, IOV_MAX);
 
     while (meta.msg_iovlen > 0) {
         int ret = -1;
@@ -532,9 +536,10 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
                 } else {
                     ret -= i->iov_len;
                     ++i;
-                    --(meta.msg_iovlen);
+                    --remaining;
                 }
             }
+            meta.msg_iovlen = std::min<size_t>(remaining, IOV_MAX);
         }
     }
 #endif
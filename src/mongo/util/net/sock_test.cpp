@@ -343,5 +343,25 @@ TEST_F(SocketFailPointTest, TestFailedRecvsDontRecv) {
     ASSERT_TRUE(tryRecv());
 }
 
+TEST(Socket, SendVectorWithManyEntries) {
+    // More entries than sendmsg() accepts in one call (IOV_MAX is 1024 on Linux).
+    const int kEntries = 4096;
+    const auto sockets = socketPair(SOCK_STREAM);
+    ASSERT_TRUE(sockets.first);
+    ASSERT_TRUE(sockets.second);
+
+    std::vector<char> sent(kEntries);
+    std::vector<std::pair<char*, int>> data;
+    for (int i = 0; i < kEntries; ++i) {
+        sent[i] = static_cast<char>(i % 251);
+        data.push_back(std::make_pair(&sent[i], 1));
+    }
+    sockets.first->send(data, "SendVectorWithManyEntries");
+
+    std::vector<char> received(kEntries);
+    sockets.second->recv(&received[0], kEntries);
+    ASSERT_TRUE(sent == received);
+}
+
 
 }  // namespace
@@ -36,6 +36,7 @@
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/tss.hpp>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -43,8 +44,10 @@
 #include "mongo/base/init.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/config.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/exit.h"
@@ -197,6 +200,107 @@ boost::thread_specific_ptr<SSLThreadInfo> SSLThreadInfo::_thread;
 
 ////////////////////////////////////////////////////////////////
 
+/**
+ * A startup parameter of the SSL session caches, which may not be negative.
+ */
+class ExportedSSLSessionParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedSSLSessionParameter(const std::string& name, int* value)
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), name, value) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue, name() + " must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+};
+
+// Maximum number of sessions kept by the server-side session ID cache of each SSL_CTX used to
+// accept connections.
+int sslSessionCacheSize = 20 * 1024;
+ExportedSSLSessionParameter exportedSSLSessionCacheSizeParam("sslSessionCacheSize",
+                                                             &sslSessionCacheSize);
+
+// How long a session may be resumed, for both session IDs and session tickets.
+int sslSessionTimeoutSecs = 300;
+ExportedSSLSessionParameter exportedSSLSessionTimeoutSecsParam("sslSessionTimeoutSecs",
+                                                               &sslSessionTimeoutSecs);
+
+// Maximum number of peers whose sessions outgoing connections remember for resumption.
+int sslClientSessionCacheSize = 1024;
+ExportedSSLSessionParameter exportedSSLClientSessionCacheSizeParam("sslClientSessionCacheSize",
+                                                                   &sslClientSessionCacheSize);
+
+/**
+ * Remembers the last session negotiated with each peer by outgoing connections. Sessions are
+ * keyed by the SSL_CTX as well as the peer, since a session may only be resumed with the
+ * settings it was negotiated with.
+ */
+class ClientSessionCache {
+    MONGO_DISALLOW_COPYING(ClientSessionCache);
+
+public:
+    ClientSessionCache() = default;
+
+    ~ClientSessionCache() {
+        for (auto&& entry : _sessions) {
+            SSL_SESSION_free(entry.second);
+        }
+    }
+
+    void restore(SSL* ssl, const std::string& peer) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _sessions.find(Key(SSL_get_SSL_CTX(ssl), peer));
+        if (it != _sessions.end()) {
+            // SSL_set_session() takes its own reference to the session.
+            SSL_set_session(ssl, it->second);
+        }
+    }
+
+    void save(SSL* ssl, const std::string& peer) {
+        const size_t capacity = static_cast<size_t>(sslClientSessionCacheSize);
+        if (capacity == 0) {
+            return;
+        }
+
+        SSL_SESSION* session = SSL_get1_session(ssl);
+        if (!session) {
+            return;
+        }
+
+        Key key(SSL_get_SSL_CTX(ssl), peer);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _sessions.find(key);
+        if (it != _sessions.end()) {
+            SSL_SESSION_free(it->second);
+            it->second = session;
+            return;
+        }
+
+        if (_sessions.size() >= capacity) {
+            // The cache only needs to cover the members of a cluster, so rather than tracking
+            // recency, make room by dropping an arbitrary peer.
+            SSL_SESSION_free(_sessions.begin()->second);
+            _sessions.erase(_sessions.begin());
+        }
+        _sessions.emplace(std::move(key), session);
+    }
+
+    size_t size() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _sessions.size();
+    }
+
+private:
+    using Key = std::pair<SSL_CTX*, std::string>;
+
+    mutable stdx::mutex _mutex;
+    std::map<Key, SSL_SESSION*> _sessions;
+};
+
 SimpleMutex sslManagerMtx;
 SSLManagerInterface* theSSLManager = NULL;
 using UniqueSSLContext = std::unique_ptr<SSL_CTX, decltype(&_free_ssl_context)>;
@@ -225,6 +329,14 @@ public:
     StatusWith<boost::optional<SSLPeerInfo>> parseAndValidatePeerCertificate(
         SSL* conn, const std::string& remoteHost) final;
 
+    void restoreClientSession(SSL* ssl, const std::string& peer) final;
+
+    void saveClientSession(SSL* ssl, const std::string& peer) final;
+
+    void recordHandshake(SSL* ssl, ConnectionDirection direction) final;
+
+    void appendSessionCacheStats(BSONObjBuilder* b) const final;
+
     virtual const SSLConfiguration& getSSLConfiguration() const {
         return _sslConfiguration;
     }
@@ -255,6 +367,12 @@ private:
     bool _allowInvalidHostnames;
     SSLConfiguration _sslConfiguration;
 
+    ClientSessionCache _clientSessions;
+    AtomicInt64 _serverSessionsResumed;
+    AtomicInt64 _serverFullHandshakes;
+    AtomicInt64 _clientSessionsResumed;
+    AtomicInt64 _clientFullHandshakes;
+
     /**
      * creates an SSL object to be used for this file descriptor.
      * caller must SSL_free it.
@@ -654,6 +772,19 @@ Status SSLManager::initSSLContext(SSL_CTX* context,
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Let returning peers skip the asymmetric part of the handshake. Servers keep a session ID
+    // cache (session tickets are on by default); clients keep their sessions in
+    // _clientSessions, keyed by peer, rather than in OpenSSL's internal cache which is never
+    // consulted on the client side.
+    ::SSL_CTX_set_timeout(context, sslSessionTimeoutSecs);
+    if (direction == ConnectionDirection::kIncoming) {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+        ::SSL_CTX_sess_set_cache_size(context, sslSessionCacheSize);
+    } else {
+        ::SSL_CTX_set_session_cache_mode(context,
+                                         SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    }
+
     if (direction == ConnectionDirection::kOutgoing && !params.sslClusterFile.empty()) {
         ::EVP_set_pw_prompt("Enter cluster certificate passphrase");
         if (!_setupPEM(context, params.sslClusterFile, params.sslClusterPassword)) {
@@ -1081,6 +1212,9 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    const std::string peer = socket->remoteAddr().toString();
+    restoreClientSession(sslConn->ssl, peer);
+
     do {
         ret = ::SSL_connect(sslConn->ssl);
     } while (!_doneWithSSLOp(sslConn.get(), ret));
@@ -1088,6 +1222,9 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    recordHandshake(sslConn->ssl, ConnectionDirection::kOutgoing);
+    saveClientSession(sslConn->ssl, peer);
+
     return sslConn.release();
 }
 
@@ -1103,9 +1240,50 @@ SSLConnection* SSLManager::accept(Socket* socket, const char* initialBytes, int
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    recordHandshake(sslConn->ssl, ConnectionDirection::kIncoming);
+
     return sslConn.release();
 }
 
+void SSLManager::restoreClientSession(SSL* ssl, const std::string& peer) {
+    _clientSessions.restore(ssl, peer);
+}
+
+void SSLManager::saveClientSession(SSL* ssl, const std::string& peer) {
+    // A resumed session is already in the cache.
+    if (!::SSL_session_reused(ssl)) {
+        _clientSessions.save(ssl, peer);
+    }
+}
+
+void SSLManager::recordHandshake(SSL* ssl, ConnectionDirection direction) {
+    const bool resumed = ::SSL_session_reused(ssl);
+    if (direction == ConnectionDirection::kIncoming) {
+        (resumed ? _serverSessionsResumed : _serverFullHandshakes).addAndFetch(1);
+    } else {
+        (resumed ? _clientSessionsResumed : _clientFullHandshakes).addAndFetch(1);
+    }
+}
+
+void SSLManager::appendSessionCacheStats(BSONObjBuilder* b) const {
+    BSONObjBuilder sessions(b->subobjStart("SSLSessionCache"));
+    {
+        BSONObjBuilder incoming(sessions.subobjStart("incoming"));
+        incoming.append("resumed", _serverSessionsResumed.load());
+        incoming.append("fullHandshakes", _serverFullHandshakes.load());
+        if (_serverContext) {
+            incoming.append("cachedSessions",
+                            static_cast<long long>(::SSL_CTX_sess_number(_serverContext.get())));
+        }
+    }
+    {
+        BSONObjBuilder outgoing(sessions.subobjStart("outgoing"));
+        outgoing.append("resumed", _clientSessionsResumed.load());
+        outgoing.append("fullHandshakes", _clientFullHandshakes.load());
+        outgoing.append("cachedPeers", static_cast<long long>(_clientSessions.size()));
+    }
+}
+
 // TODO SERVER-11601 Use NFC Unicode canonicalization
 bool SSLManager::_hostNameMatch(const char* nameToMatch, const char* certHostName) {
     if (strlen(certHostName) < 2) {
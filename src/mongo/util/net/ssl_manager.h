@@ -57,6 +57,7 @@ const std::string getSSLVersion(const std::string& prefix, const std::string& su
 
 #ifdef MONGO_CONFIG_SSL
 namespace mongo {
+class BSONObjBuilder;
 struct SSLParams;
 
 class SSLConnection {
@@ -186,6 +187,29 @@ public:
      */
     virtual StatusWith<boost::optional<SSLPeerInfo>> parseAndValidatePeerCertificate(
         SSL* ssl, const std::string& remoteHost) = 0;
+
+    /**
+     * Offers the session cached from an earlier connection to "peer" (a host:port string) to an
+     * outgoing connection which has not started its handshake yet, so that the server may resume
+     * it instead of performing a full handshake.
+     */
+    virtual void restoreClientSession(SSL* ssl, const std::string& peer) = 0;
+
+    /**
+     * Caches the session negotiated by a completed outgoing handshake with "peer" for reuse by
+     * later connections to it.
+     */
+    virtual void saveClientSession(SSL* ssl, const std::string& peer) = 0;
+
+    /**
+     * Counts a completed handshake as either a resumed session or a full handshake.
+     */
+    virtual void recordHandshake(SSL* ssl, ConnectionDirection direction) = 0;
+
+    /**
+     * Appends session resumption counters and cache sizes, for serverStatus.
+     */
+    virtual void appendSessionCacheStats(BSONObjBuilder* b) const = 0;
 };
 
 // Access SSL functions through this instance.
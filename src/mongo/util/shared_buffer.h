@@ -51,6 +51,14 @@ public:
         return takeOwnership(mongoMalloc(sizeof(Holder) + bytes));
     }
 
+    /**
+     * Like allocate(), but draws the buffer from the size-classed SharedBufferPool and returns
+     * it there when the last reference goes away. Intended for short-lived, frequently allocated
+     * buffers such as wire protocol messages. Requests too large for any size class fall back to
+     * allocate().
+     */
+    static SharedBuffer allocatePooled(size_t bytes);
+
     /**
      * Resizes the buffer, copying the current contents.
      *
@@ -58,10 +66,17 @@ public:
      *
      * This method is illegal to call if any other SharedBuffer instances share this buffer since
      * they wouldn't be updated and would still try to delete the original buffer.
+     *
+     * Pooled buffers stay pooled, and resizing within the buffer's size class does not copy.
      */
     void realloc(size_t size) {
         invariant(!_holder || !_holder->isShared());
 
+        if (_holder && _holder->isPooled()) {
+            _reallocPooled(size);
+            return;
+        }
+
         const size_t realSize = size + sizeof(Holder);
         void* newPtr = mongoRealloc(_holder.get(), realSize);
 
@@ -81,10 +96,16 @@ public:
     }
 
 private:
+    friend class SharedBufferPool;
+
     class Holder {
     public:
-        explicit Holder(AtomicUInt32::WordType initial = AtomicUInt32::WordType())
-            : _refCount(initial) {}
+        // Size class value for buffers that did not come from the SharedBufferPool.
+        static const uint8_t kUnpooled = 0;
+
+        explicit Holder(AtomicUInt32::WordType initial = AtomicUInt32::WordType(),
+                        uint8_t sizeClass = kUnpooled)
+            : _refCount(initial), _sizeClass(sizeClass) {}
 
         // these are called automatically by boost::intrusive_ptr
         friend void intrusive_ptr_add_ref(Holder* h) {
@@ -95,8 +116,13 @@ private:
             if (h->_refCount.subtractAndFetch(1) == 0) {
                 // We placement new'ed a Holder in takeOwnership above,
                 // so we must destroy the object here.
+                const auto sizeClass = h->_sizeClass;
                 h->~Holder();
-                free(h);
+                if (sizeClass == kUnpooled) {
+                    free(h);
+                } else {
+                    releasePooled(h, sizeClass);
+                }
             }
         }
 
@@ -112,7 +138,16 @@ private:
             return _refCount.load() > 1;
         }
 
+        bool isPooled() const {
+            return _sizeClass != kUnpooled;
+        }
+
+        // Returns a pooled buffer's memory to the SharedBufferPool. Defined in
+        // shared_buffer_pool.cpp.
+        static void releasePooled(void* holderPrefixedData, uint8_t sizeClass);
+
         AtomicUInt32 _refCount;
+        const uint8_t _sizeClass;
     };
 
     explicit SharedBuffer(Holder* holder) : _holder(holder, /*add_ref=*/false) {
@@ -127,14 +162,18 @@ private:
      * This class will call free(holderPrefixedData), so it must have been allocated in a way
      * that makes that valid.
      */
-    static SharedBuffer takeOwnership(void* holderPrefixedData) {
+    static SharedBuffer takeOwnership(void* holderPrefixedData,
+                                      uint8_t sizeClass = Holder::kUnpooled) {
         // Initialize the refcount to 1 so we don't need to increment it in the constructor
         // (see private Holder* constructor above).
         //
         // TODO: Should dassert alignment of holderPrefixedData here if possible.
-        return SharedBuffer(new (holderPrefixedData) Holder(1U));
+        return SharedBuffer(new (holderPrefixedData) Holder(1U, sizeClass));
     }
 
+    // realloc() for pooled buffers. Defined in shared_buffer_pool.cpp.
+    void _reallocPooled(size_t size);
+
     boost::intrusive_ptr<Holder> _holder;
 };
 
@@ -0,0 +1,295 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <boost/thread/tss.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+namespace {
+
+// Size classes are numbered from 1 so that 0 can mean "not pooled" in the buffer header.
+size_t classBytes(uint8_t sizeClass) {
+    return SharedBufferPool::kMinPooledBytes << (sizeClass - 1);
+}
+
+uint8_t sizeClassFor(size_t totalBytes) {
+    for (uint8_t sizeClass = 1; sizeClass <= SharedBufferPool::kNumSizeClasses; ++sizeClass) {
+        if (totalBytes <= classBytes(sizeClass)) {
+            return sizeClass;
+        }
+    }
+    return 0;
+}
+
+size_t maxThreadCacheBuffers(uint8_t sizeClass) {
+    return std::max<size_t>(SharedBufferPool::kMaxThreadCacheBytesPerClass / classBytes(sizeClass),
+                            2);
+}
+
+struct Counters {
+    AtomicInt64 threadCacheHits;
+    AtomicInt64 globalHits;
+    AtomicInt64 misses;
+    AtomicInt64 oversized;
+    AtomicInt64 freed;
+    AtomicInt64 threadCacheRetainedBytes;
+    AtomicInt64 globalRetainedBytes;
+};
+
+Counters counters;
+
+/**
+ * The shared free lists, one per size class. Threads move buffers in and out of here in batches
+ * to keep the mutex off the per-message path.
+ */
+class GlobalFreeLists {
+public:
+    /**
+     * Moves up to 'count' buffers of the given class into 'out'. Returns the number moved.
+     */
+    size_t take(uint8_t sizeClass, size_t count, std::vector<void*>* out) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto& list = _lists[sizeClass - 1];
+        const size_t moved = std::min(count, list.size());
+        out->insert(out->end(), list.end() - moved, list.end());
+        list.resize(list.size() - moved);
+        counters.globalRetainedBytes.subtractAndFetch(moved * classBytes(sizeClass));
+        return moved;
+    }
+
+    /**
+     * Takes ownership of the last 'count' buffers of 'in', freeing any that do not fit under
+     * kMaxGlobalRetainedBytes.
+     */
+    void give(uint8_t sizeClass, size_t count, std::vector<void*>* in) {
+        const int64_t bytes = classBytes(sizeClass);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto& list = _lists[sizeClass - 1];
+        for (size_t i = 0; i < count; ++i) {
+            void* block = in->back();
+            in->pop_back();
+            if (counters.globalRetainedBytes.load() + bytes >
+                static_cast<int64_t>(SharedBufferPool::kMaxGlobalRetainedBytes)) {
+                counters.freed.fetchAndAdd(1);
+                free(block);
+                continue;
+            }
+            list.push_back(block);
+            counters.globalRetainedBytes.addAndFetch(bytes);
+        }
+    }
+
+private:
+    stdx::mutex _mutex;
+    std::vector<void*> _lists[SharedBufferPool::kNumSizeClasses];
+};
+
+GlobalFreeLists& globalFreeLists() {
+    // Intentionally leaked so that buffers released during shutdown still have a home.
+    static auto lists = new GlobalFreeLists();
+    return *lists;
+}
+
+/**
+ * Per-thread free lists. Allocation and release only touch the global lists when a thread's
+ * list for the size class is empty or full.
+ */
+class ThreadCache {
+    MONGO_DISALLOW_COPYING(ThreadCache);
+
+public:
+    ThreadCache() = default;
+
+    ~ThreadCache() {
+        flush();
+    }
+
+    void* pop(uint8_t sizeClass) {
+        auto& list = _lists[sizeClass - 1];
+        if (!list.empty()) {
+            counters.threadCacheHits.fetchAndAdd(1);
+        } else {
+            const size_t refill = maxThreadCacheBuffers(sizeClass) / 2;
+            const size_t moved = globalFreeLists().take(sizeClass, refill, &list);
+            if (moved == 0) {
+                return nullptr;
+            }
+            counters.globalHits.fetchAndAdd(1);
+            counters.threadCacheRetainedBytes.addAndFetch(moved * classBytes(sizeClass));
+        }
+
+        void* block = list.back();
+        list.pop_back();
+        counters.threadCacheRetainedBytes.subtractAndFetch(classBytes(sizeClass));
+        return block;
+    }
+
+    void push(void* block, uint8_t sizeClass) {
+        auto& list = _lists[sizeClass - 1];
+        if (list.size() >= maxThreadCacheBuffers(sizeClass)) {
+            _spill(sizeClass, list.size() / 2);
+        }
+        list.push_back(block);
+        counters.threadCacheRetainedBytes.addAndFetch(classBytes(sizeClass));
+    }
+
+    void flush() {
+        for (uint8_t sizeClass = 1; sizeClass <= SharedBufferPool::kNumSizeClasses; ++sizeClass) {
+            _spill(sizeClass, _lists[sizeClass - 1].size());
+        }
+    }
+
+private:
+    void _spill(uint8_t sizeClass, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        counters.threadCacheRetainedBytes.subtractAndFetch(count * classBytes(sizeClass));
+        globalFreeLists().give(sizeClass, count, &_lists[sizeClass - 1]);
+    }
+
+    std::vector<void*> _lists[SharedBufferPool::kNumSizeClasses];
+};
+
+// The raw pointer gives a cheap lookup; the thread_specific_ptr owns the cache and flushes it
+// back to the global lists when the thread exits.
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL ThreadCache* threadCache;
+boost::thread_specific_ptr<ThreadCache> threadCacheOwner([](ThreadCache* cache) {
+    threadCache = nullptr;
+    delete cache;
+});
+
+ThreadCache* getOrMakeThreadCache() {
+    if (!threadCache) {
+        threadCache = new ThreadCache();
+        threadCacheOwner.reset(threadCache);
+    }
+    return threadCache;
+}
+
+}  // namespace
+
+SharedBuffer SharedBuffer::allocatePooled(size_t bytes) {
+    return SharedBufferPool::allocate(bytes);
+}
+
+void SharedBuffer::_reallocPooled(size_t size) {
+    const size_t capacity = classBytes(_holder->_sizeClass) - sizeof(Holder);
+    if (size <= capacity) {
+        return;
+    }
+
+    auto newBuffer = allocatePooled(size);
+    memcpy(newBuffer.get(), get(), capacity);
+    swap(newBuffer);
+}
+
+void SharedBuffer::Holder::releasePooled(void* holderPrefixedData, uint8_t sizeClass) {
+    SharedBufferPool::release(holderPrefixedData, sizeClass);
+}
+
+SharedBuffer SharedBufferPool::allocate(size_t bytes) {
+    const uint8_t sizeClass = sizeClassFor(sizeof(SharedBuffer::Holder) + bytes);
+    if (!sizeClass) {
+        counters.oversized.fetchAndAdd(1);
+        return SharedBuffer::allocate(bytes);
+    }
+
+    void* block = getOrMakeThreadCache()->pop(sizeClass);
+    if (!block) {
+        counters.misses.fetchAndAdd(1);
+        block = mongoMalloc(classBytes(sizeClass));
+    }
+    return SharedBuffer::takeOwnership(block, sizeClass);
+}
+
+void SharedBufferPool::release(void* block, uint8_t sizeClass) {
+    // Don't create a cache here: buffers may be released by threads that never allocate, or by a
+    // thread whose cache has already been torn down.
+    if (threadCache) {
+        threadCache->push(block, sizeClass);
+        return;
+    }
+
+    std::vector<void*> single{block};
+    globalFreeLists().give(sizeClass, 1, &single);
+}
+
+size_t SharedBufferPool::pooledCapacity(size_t bytes) {
+    const uint8_t sizeClass = sizeClassFor(sizeof(SharedBuffer::Holder) + bytes);
+    return sizeClass ? classBytes(sizeClass) - sizeof(SharedBuffer::Holder) : 0;
+}
+
+void SharedBufferPool::flushThreadCache() {
+    if (threadCache) {
+        threadCache->flush();
+    }
+}
+
+SharedBufferPool::Stats SharedBufferPool::getStats() {
+    Stats stats;
+    stats.threadCacheHits = counters.threadCacheHits.load();
+    stats.globalHits = counters.globalHits.load();
+    stats.misses = counters.misses.load();
+    stats.oversized = counters.oversized.load();
+    stats.freed = counters.freed.load();
+    stats.threadCacheRetainedBytes = counters.threadCacheRetainedBytes.load();
+    stats.globalRetainedBytes = counters.globalRetainedBytes.load();
+    return stats;
+}
+
+void SharedBufferPool::appendStats(BSONObjBuilder* b) {
+    const auto stats = getStats();
+    const auto hits = stats.threadCacheHits + stats.globalHits;
+    const auto requests = hits + stats.misses + stats.oversized;
+
+    BSONObjBuilder section(b->subobjStart("bufferPool"));
+    section.append("threadCacheHits", stats.threadCacheHits);
+    section.append("globalHits", stats.globalHits);
+    section.append("misses", stats.misses);
+    section.append("oversized", stats.oversized);
+    section.append("freed", stats.freed);
+    section.append("hitRate", requests ? static_cast<double>(hits) / requests : 0.0);
+    section.append("retainedBytes", stats.threadCacheRetainedBytes + stats.globalRetainedBytes);
+    section.append("threadCacheRetainedBytes", stats.threadCacheRetainedBytes);
+    section.append("globalRetainedBytes", stats.globalRetainedBytes);
+    section.doneFast();
+}
+
+}  // namespace mongo
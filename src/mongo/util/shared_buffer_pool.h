@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A process-wide pool of SharedBuffer memory, used by SharedBuffer::allocatePooled().
+ *
+ * Buffers are grouped into power-of-two size classes from kMinPooledBytes to kMaxPooledBytes
+ * (including the SharedBuffer header). Each thread keeps a small cache of free buffers per size
+ * class so that the common allocate/release cycle of a request does not take a lock; threads
+ * spill to and refill from a mutex-protected global free list, which is bounded by
+ * kMaxGlobalRetainedBytes. Buffers beyond that bound are returned to the allocator.
+ */
+class SharedBufferPool {
+public:
+    static const size_t kMinPooledBytes = 1024;
+    static const size_t kMaxPooledBytes = 128 * 1024;
+    static const size_t kNumSizeClasses = 8;
+
+    static const size_t kMaxThreadCacheBytesPerClass = 256 * 1024;
+    static const size_t kMaxGlobalRetainedBytes = 64 * 1024 * 1024;
+
+    struct Stats {
+        // Allocations satisfied from the calling thread's cache.
+        int64_t threadCacheHits = 0;
+
+        // Allocations satisfied from the global free list.
+        int64_t globalHits = 0;
+
+        // Allocations that had to go to the allocator for a new pooled buffer.
+        int64_t misses = 0;
+
+        // Allocations larger than kMaxPooledBytes, which are not pooled at all.
+        int64_t oversized = 0;
+
+        // Pooled buffers handed back to the allocator because the pool was full.
+        int64_t freed = 0;
+
+        // Bytes currently held in free buffers, in thread caches and in the global list.
+        int64_t threadCacheRetainedBytes = 0;
+        int64_t globalRetainedBytes = 0;
+    };
+
+    static Stats getStats();
+
+    /**
+     * Appends the pool statistics, including the overall hit rate, as a "bufferPool" subobject.
+     */
+    static void appendStats(BSONObjBuilder* b);
+
+    /**
+     * Moves all buffers cached by the calling thread to the global free list. This also happens
+     * automatically when a thread exits.
+     */
+    static void flushThreadCache();
+
+    /**
+     * Returns the number of usable bytes of buffers from the smallest size class that can hold
+     * 'bytes', or 0 if 'bytes' is too large to be pooled.
+     */
+    static size_t pooledCapacity(size_t bytes);
+
+private:
+    friend class SharedBuffer;
+
+    static SharedBuffer allocate(size_t bytes);
+    static void release(void* block, uint8_t sizeClass);
+};
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <cstring>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(SharedBufferPool, ReleasedBufferIsReused) {
+    SharedBufferPool::flushThreadCache();
+
+    const char* first;
+    {
+        auto buf = SharedBuffer::allocatePooled(100);
+        first = buf.get();
+    }
+
+    const auto before = SharedBufferPool::getStats();
+    auto buf = SharedBuffer::allocatePooled(200);
+    const auto after = SharedBufferPool::getStats();
+
+    ASSERT_EQ(buf.get(), first);
+    ASSERT_EQ(after.threadCacheHits, before.threadCacheHits + 1);
+    ASSERT_EQ(after.misses, before.misses);
+}
+
+TEST(SharedBufferPool, SizeClasses) {
+    ASSERT_GTE(SharedBufferPool::pooledCapacity(1), 1U);
+    ASSERT_LT(SharedBufferPool::pooledCapacity(1), SharedBufferPool::kMinPooledBytes);
+    ASSERT_GTE(SharedBufferPool::pooledCapacity(5000), 5000U);
+    ASSERT_LT(SharedBufferPool::pooledCapacity(5000), 8192U);
+    ASSERT_EQ(SharedBufferPool::pooledCapacity(SharedBufferPool::kMaxPooledBytes), 0U);
+}
+
+TEST(SharedBufferPool, OversizedBuffersAreNotPooled) {
+    const auto before = SharedBufferPool::getStats();
+    auto buf = SharedBuffer::allocatePooled(SharedBufferPool::kMaxPooledBytes * 2);
+    ASSERT(buf);
+    const auto after = SharedBufferPool::getStats();
+    ASSERT_EQ(after.oversized, before.oversized + 1);
+
+    const auto retainedBefore = after.threadCacheRetainedBytes + after.globalRetainedBytes;
+    buf = {};
+    const auto final = SharedBufferPool::getStats();
+    ASSERT_EQ(final.threadCacheRetainedBytes + final.globalRetainedBytes, retainedBefore);
+}
+
+TEST(SharedBufferPool, ReallocKeepsContents) {
+    auto buf = SharedBuffer::allocatePooled(16);
+    memcpy(buf.get(), "pooled buffer", 14);
+
+    const auto capacity = SharedBufferPool::pooledCapacity(16);
+    const char* original = buf.get();
+    buf.realloc(capacity);
+    ASSERT_EQ(buf.get(), original);
+
+    buf.realloc(capacity * 4);
+    ASSERT_EQ(std::string(buf.get()), "pooled buffer");
+
+    buf.realloc(SharedBufferPool::kMaxPooledBytes * 2);
+    ASSERT_EQ(std::string(buf.get()), "pooled buffer");
+}
+
+TEST(SharedBufferPool, ThreadExitReturnsBuffersToGlobalList) {
+    const auto before = SharedBufferPool::getStats();
+
+    stdx::thread([] {
+        for (int i = 0; i < 4; ++i) {
+            SharedBuffer::allocatePooled(3000);
+        }
+    }).join();
+
+    const auto after = SharedBufferPool::getStats();
+    ASSERT_EQ(after.threadCacheRetainedBytes, before.threadCacheRetainedBytes);
+    ASSERT_GT(after.globalRetainedBytes, before.globalRetainedBytes);
+
+    SharedBufferPool::flushThreadCache();
+    const auto flushed = SharedBufferPool::getStats();
+    auto buf = SharedBuffer::allocatePooled(3000);
+    ASSERT_EQ(SharedBufferPool::getStats().globalHits, flushed.globalHits + 1);
+}
+
+TEST(SharedBufferPool, PooledBufBuilder) {
+    BufBuilder builder(PooledBufferTag{});
+    for (int i = 0; i < 10000; ++i) {
+        builder.appendNum(i);
+    }
+
+    auto buf = builder.release();
+    for (int i = 0; i < 10000; ++i) {
+        int value;
+        memcpy(&value, buf.get() + i * sizeof(int), sizeof(int));
+        ASSERT_EQ(value, i);
+    }
+}
+
+TEST(SharedBufferPool, AppendStats) {
+    BSONObjBuilder b;
+    SharedBufferPool::appendStats(&b);
+    auto section = b.obj()["bufferPool"].Obj();
+    ASSERT_TRUE(section.hasField("hitRate"));
+    ASSERT_TRUE(section.hasField("retainedBytes"));
+    ASSERT_GTE(section["misses"].numberLong(), 0);
+}
+
+}  // namespace
+}  // namespace mongo